@@ -6,15 +6,49 @@
 
 #include "assignment_state.h"
 #include "calendar_file.h"
+#include "event_history.h"
 #include "event_list.h"
+#include "headless.h"
+#include "instrument.h"
+#include "latency.h"
+#include "trace.h"
 #include "ui_assignment.h"
 
+/*
+ * Forward declarations.
+ */
+static int guiMain(int argc, char *argv[]);
+
+/*
+ * If the first argument is a command (starts with "--") then that
+ * command line tool is run, see headless.h, otherwise the GUI is.
+ * Either way the instrumentation and the trace are written out at the
+ * end if they were asked for, see instrument.h and trace.h.
+ */
+int main(int argc, char *argv[])
+{
+  int result;
+
+  traceStart();
+
+  if (headlessRequested(argc, argv)) {
+    result = headlessRun(argc, argv);
+  } else {
+    result = guiMain(argc, argv);
+  }
+
+  INSTRUMENT_DUMP();
+  traceFinish();
+
+  return result;
+}
+
 /*
  * If given a single command line argument, the program will try to
  * load that file as a calendar. If there is a problem, then it will
  * let the user know, and proceed with just an empty calendar.
  */
-int main(int argc, char *argv[])
+static int guiMain(int argc, char *argv[])
 {
   /*
    * Our application state, this is passed around from function to
@@ -23,6 +57,8 @@ int main(int argc, char *argv[])
   struct AssignmentState state;
 
   state.event_list = eventListCreate();
+  state.fuzzy_index = NULL;
+  state.prefix_index = NULL;
   state.error = NULL;
   state.error_code = 0;
 
@@ -46,9 +82,21 @@ int main(int argc, char *argv[])
     }
   }
 
+  /* Whatever we start with is the first version, nothing to undo. */
+  state.history = eventHistoryCreate(state.event_list);
+
+  /* Changes still work without it, they just can't be undone. */
+  if (state.history == NULL) {
+    state.error = "Not enough memory to keep an undo history.";
+  }
+
   uiSetup(&state);
   uiRun(&state);
   uiCleanup(&state);
+  latencyReportRequested(eventListCount(state.event_list));
+  eventFuzzyDestroy(state.fuzzy_index);
+  eventPrefixDestroy(state.prefix_index);
+  eventHistoryDestroy(state.history);
   eventListDestroy(state.event_list);
 
   /*
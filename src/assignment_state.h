@@ -11,7 +11,10 @@
 #ifndef ASSIGNMENT_STATE_H_
 #define ASSIGNMENT_STATE_H_
 
+#include "event_fuzzy.h"
+#include "event_history.h"
 #include "event_list.h"
+#include "event_prefix.h"
 #include "gui.h"
 
 /*
@@ -30,12 +33,22 @@
  *
  * main_window - Pointer for the main window.
  * event_list - Pointer to the list of calendar events that are loaded.
+ * history - Undo/redo history of the event list, has to be kept in
+ *           step with every change made to event_list.
+ * fuzzy_index - Index of the event names for offering close ones,
+ *               NULL until it's first needed.
+ * prefix_index - Sorted event names for the find dialog, NULL until
+ *                it's first needed. Keeps up with event_list by itself,
+ *                but has to be destroyed before event_list is.
  * error - String of the error that needs to be displayed to the user.
  * error_code - Error code to return on the exit of the program.
  */
 struct AssignmentState {
   Window *main_window;
   struct EventList *event_list;
+  struct EventHistory *history;
+  struct EventFuzzyIndex *fuzzy_index;
+  struct EventPrefixIndex *prefix_index;
   const char *error;
   int error_code;
 };
@@ -0,0 +1,43 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Public header for libcalendar, the calendar without the GUI.
+ *
+ * Events, dates and times, event lists and loading and saving them,
+ * plus the indexes, queries, schedules, stats and history built on
+ * them. Nothing here needs GTK. Build it with make lib, then compile
+ * with -Isrc and link with libcalendar.a (or -L. -lcalendar for the
+ * shared one) and -pthread.
+ *
+ * The GUI (gui, ui_assignment) and the command line tools (headless)
+ * are part of the program, not the library.
+ */
+
+#ifndef CALENDAR_H_
+#define CALENDAR_H_
+
+#include "bool.h"
+#include "calendar_file.h"
+#include "date_time.h"
+#include "date_time_batch.h"
+#include "event.h"
+#include "event_fuzzy.h"
+#include "event_history.h"
+#include "event_id_map.h"
+#include "event_index.h"
+#include "event_list.h"
+#include "event_prefix.h"
+#include "event_query.h"
+#include "event_schedule.h"
+#include "event_stats.h"
+#include "event_text.h"
+#include "event_upcoming.h"
+#include "instrument.h"
+#include "latency.h"
+#include "monotonic.h"
+#include "shared_event_list.h"
+#include "trace.h"
+
+#endif
@@ -6,6 +6,7 @@
  * Implementation of reading from, and writing to calendar files.
  */
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,6 +15,8 @@
 #include "date_time.h"
 #include "event_list.h"
 #include "event.h"
+#include "instrument.h"
+#include "trace.h"
 
 /*
  * Name and location are variable length strings. BUFFER_CHUNK is the
@@ -22,6 +25,12 @@
  */
 #define BUFFER_CHUNK 512
 
+/*
+ * Size of the stdio buffer when saving, each time it fills it's one
+ * write to the file.
+ */
+#define SAVE_BUFFER_SIZE 65536
+
 /*
  * Max string lengths to support reading the date and time strings
  * from the calendar file. These are including the terminator.
@@ -40,6 +49,21 @@
   EVENT_MAX_DURATION_STR_LEN              \
   "i "
 
+/*
+ * Each event is saved with its id on a line of its own before it, so
+ * it keeps the id when it's loaded again. Files saved before events
+ * had ids don't have these lines, their events get new ids instead.
+ *
+ * Ids are read as a string of digits, so a sign or an id too big for
+ * an EventId is an error rather than wrapping around. No id has more
+ * than EVENT_MAX_ID_DIGITS digits.
+ */
+#define EVENT_ID_MARKER '#'
+#define EVENT_ID_FORMAT "#id %llu\n"
+#define EVENT_MAX_ID_DIGITS 20
+#define EVENT_MAX_ID_DIGITS_STR "20"
+#define EVENT_ID_READ_FORMAT "id %" EVENT_MAX_ID_DIGITS_STR "[0-9]"
+
 /*
  * Module Ident
  *
@@ -59,12 +83,15 @@
  * We also keep track of any errors creating an event here, this is
  * because we need to stop processing if we get a file error, or an
  * error creating an event.
+ *
+ * The events are created from the pool of the list being loaded into.
  */
 struct CalendarFile {
   char *read_buffer;
   int buffer_size;
   FILE *current_file;
   enum EventError event_error;
+  struct EventList *list;
 };
 
 /*
@@ -72,6 +99,7 @@ struct CalendarFile {
  */
 static enum FileError readEventFromFile(struct Event **loaded_event,
                                         struct CalendarFile *calendar_file);
+static Boolean readEventId(EventId *id, FILE *file);
 static enum FileError readEventName(char **temp_name,
                                     struct CalendarFile *calendar_file);
 static enum FileError readVariableLengthString(struct CalendarFile
@@ -88,6 +116,11 @@ enum FileError loadCalendar(struct EventList *list,
   enum FileError file_error_result;
   struct CalendarFile calendar_file;
 
+  traceBegin("loadCalendar");
+  INSTRUMENT_START(INSTRUMENT_LOAD);
+  INSTRUMENT_COUNT(INSTRUMENT_LOAD_MALLOCS,
+                   -INSTRUMENT_VALUE(INSTRUMENT_MALLOCS));
+
   /*
    * Check for NULL filename, empty strings will return FILE_ERROR
    * error.
@@ -96,6 +129,7 @@ enum FileError loadCalendar(struct EventList *list,
     calendar_file.buffer_size = 0;
     calendar_file.current_file = fopen(filename, "rb");
     calendar_file.event_error = EVENT_NO_ERROR;
+    calendar_file.list = list;
 
     if (calendar_file.current_file != NULL) {
       /* Manged to open the file. */
@@ -112,7 +146,7 @@ enum FileError loadCalendar(struct EventList *list,
        * It starts off as BUFFER_CHUNK size, but will double in size
        * each time it's not big enough.
        */
-      calendar_file.read_buffer = (char *) malloc(BUFFER_CHUNK);
+      calendar_file.read_buffer = (char *) INSTRUMENT_MALLOC(BUFFER_CHUNK);
 
       if (calendar_file.read_buffer != NULL) {
         /* We have our initial read buffer. */
@@ -133,6 +167,7 @@ enum FileError loadCalendar(struct EventList *list,
           /* No errors reading the event, try adding it to the list. */
           if (calendar_file.event_error == EVENT_NO_ERROR) {
             event_insert_success = eventListInsertLast(list, current_event);
+            INSTRUMENT_COUNT(INSTRUMENT_LOAD_RECORDS, event_insert_success);
           }
         } while ((calendar_file.event_error == EVENT_NO_ERROR) &&
                  (file_error_result == FILE_NO_ERROR) &&
@@ -164,6 +199,8 @@ enum FileError loadCalendar(struct EventList *list,
         file_error_result = FILE_INTERNAL_ERROR;
       }
 
+      INSTRUMENT_COUNT(INSTRUMENT_LOAD_BYTES,
+                       ftell(calendar_file.current_file));
       fclose(calendar_file.current_file);
     } else {
       /* File open did not succeed. */
@@ -173,6 +210,11 @@ enum FileError loadCalendar(struct EventList *list,
     file_error_result = FILE_NO_FILENAME;
   }
 
+  INSTRUMENT_COUNT(INSTRUMENT_LOAD_MALLOCS,
+                   INSTRUMENT_VALUE(INSTRUMENT_MALLOCS));
+  INSTRUMENT_STOP(INSTRUMENT_LOAD);
+  traceEnd("loadCalendar");
+
   return file_error_result;
 }
 
@@ -184,6 +226,9 @@ enum FileError saveCalendar(struct EventList *list,
 {
   enum FileError file_error_result;
 
+  traceBegin("saveCalendar");
+  INSTRUMENT_START(INSTRUMENT_SAVE);
+
   /* Check that it's not an empty list. */
   if (list->head != NULL) {
     if (filename != NULL) {
@@ -195,6 +240,8 @@ enum FileError saveCalendar(struct EventList *list,
 
       if (output_file != NULL) {
         struct Event *current_event;
+
+        setvbuf(output_file, NULL, _IOFBF, SAVE_BUFFER_SIZE);
         eventListResetPosition(list);
         current_event = eventListNext(list);
 
@@ -202,6 +249,7 @@ enum FileError saveCalendar(struct EventList *list,
          * Loop through the list, saving each entry to the file.
          */
         while (current_event != NULL) {
+          fprintf(output_file, EVENT_ID_FORMAT, current_event->id);
           fprintf(output_file, FILE_DATE_FORMAT " "
                   FILE_TIME_FORMAT " "
                   "%d %s\n",
@@ -215,13 +263,18 @@ enum FileError saveCalendar(struct EventList *list,
 
           /* Only save a location if we have one. */
           if (current_event->location != NULL) {
-            fprintf(output_file, "%s\n", current_event->location);
+            fprintf(output_file, "%s\n", eventLocation(current_event));
           }
 
           fprintf(output_file, "\n");
           current_event = eventListNext(list);
         }
 
+        /* The open, a write per full buffer and the close. */
+        INSTRUMENT_COUNT(INSTRUMENT_SAVE_BYTES, ftell(output_file));
+        INSTRUMENT_COUNT(INSTRUMENT_SAVE_SYSCALLS,
+                         2 + (ftell(output_file) + SAVE_BUFFER_SIZE - 1) /
+                         SAVE_BUFFER_SIZE);
         fclose(output_file);
       } else {
         /* Couldn't open the file */
@@ -234,6 +287,9 @@ enum FileError saveCalendar(struct EventList *list,
     file_error_result = FILE_EMPTY_LIST;
   }
 
+  INSTRUMENT_STOP(INSTRUMENT_SAVE);
+  traceEnd("saveCalendar");
+
   return file_error_result;
 }
 
@@ -300,14 +356,22 @@ static enum FileError readEventFromFile(struct Event **loaded_event,
   enum FileError file_error_result;
   char date[EVENT_MAX_DATE_STR_LEN], time[EVENT_MAX_TIME_STR_LEN];
   int duration, read_result;
+  EventId id;
+  Boolean id_valid;
 
   calendar_file->event_error = EVENT_READ_ERROR;
 
   /*
-   * Scan in the first line of the event.
+   * Scan in the id, if there is one, then the first line of the event.
    */
-  read_result = fscanf(calendar_file->current_file, EVENT_LEADING_FORMAT,
-                       date, time, &duration);
+  id_valid = readEventId(&id, calendar_file->current_file);
+
+  if (id_valid) {
+    read_result = fscanf(calendar_file->current_file, EVENT_LEADING_FORMAT,
+                         date, time, &duration);
+  } else {
+    read_result = 0;
+  }
 
   /*
    * If the file read was not exactly what we expect, then it's a file
@@ -336,8 +400,15 @@ static enum FileError readEventFromFile(struct Event **loaded_event,
        * We might have hit the end of the file, but we still have a
        * valid event name, so we might still have a valid event.
        */
-      calendar_file->event_error = eventCreate(loaded_event, date, time, duration,
+      INSTRUMENT_START(INSTRUMENT_PARSE);
+      calendar_file->event_error = eventListCreateEvent(calendar_file->list,
+                                   loaded_event, date, time, duration,
                                    temp_name, temp_location);
+      INSTRUMENT_STOP(INSTRUMENT_PARSE);
+
+      if (calendar_file->event_error == EVENT_NO_ERROR) {
+        (*loaded_event)->id = id;
+      }
     }
 
     free(temp_location);
@@ -348,7 +419,7 @@ static enum FileError readEventFromFile(struct Event **loaded_event,
      * Didn't get the start of an event when we expected one.
      * If we get an EOF here, it probably means that we've got no more entries.
      */
-    if (feof(calendar_file->current_file)) {
+    if (id_valid && feof(calendar_file->current_file)) {
       file_error_result = FILE_EOF;
     } else {
       file_error_result = FILE_INVALID_FORMAT;
@@ -358,6 +429,58 @@ static enum FileError readEventFromFile(struct Event **loaded_event,
   return file_error_result;
 }
 
+/*
+ * Skips the blank lines before an event, and reads its id line if it
+ * has one.
+ *
+ * Returns FALSE if there's an id line but it isn't a valid id, one
+ * from 1 to EVENT_LAST_ID.
+ *
+ * id - Set to the id, or EVENT_NO_ID if the event doesn't have one.
+ * file - The calendar file.
+ */
+static Boolean readEventId(EventId *id, FILE *file)
+{
+  char digits[EVENT_MAX_ID_DIGITS + 1];
+  const char *digit;
+  Boolean result;
+  int character;
+
+  result = TRUE;
+  *id = EVENT_NO_ID;
+
+  do {
+    character = getc(file);
+  } while (character != EOF && isspace(character));
+
+  if (character == EVENT_ID_MARKER) {
+    result = (fscanf(file, EVENT_ID_READ_FORMAT, digits) == 1);
+
+    /* Any more digits and it's too big. */
+    character = getc(file);
+
+    if (isdigit(character)) {
+      result = FALSE;
+    } else if (character != EOF) {
+      ungetc(character, file);
+    }
+
+    for (digit = digits; result && *digit != '\0'; digit++) {
+      result = (*id <= (EVENT_LAST_ID - (EventId) (*digit - '0')) / 10);
+
+      if (result) {
+        *id = *id * 10 + (EventId) (*digit - '0');
+      }
+    }
+
+    result = (result && *id != EVENT_NO_ID);
+  } else if (character != EOF) {
+    ungetc(character, file);
+  }
+
+  return result;
+}
+
 /*
  * Attempts to read the event name from the current file position.
  *
@@ -396,7 +519,7 @@ static enum FileError readEventName(char **temp_name,
       /*
        * Allocate a temporary string to hold the name until we can create an event.
        */
-      *temp_name = (char *) malloc(name_string_length + 1);
+      *temp_name = (char *) INSTRUMENT_MALLOC(name_string_length + 1);
 
       if (*temp_name != NULL) {
         **temp_name = '\0';
@@ -438,7 +561,8 @@ static enum FileError readEventLocation(char **temp_location,
      * Only process the location if there's a string there at all.
      */
     if (location_string_length > 0) {
-      *temp_location = (char *) malloc(location_string_length + 1);
+      *temp_location =
+        (char *) INSTRUMENT_MALLOC(location_string_length + 1);
 
       if (*temp_location != NULL) {
         **temp_location = '\0';
@@ -509,8 +633,9 @@ static enum FileError readVariableLengthString(struct CalendarFile
          * Reallocate, doubling your current buffer size is slightly
          * better memory management wise.
          */
-        calendar_file->read_buffer = (char *) realloc(calendar_file->read_buffer,
-                                     calendar_file->buffer_size * 2);
+        calendar_file->read_buffer = (char *)
+          INSTRUMENT_REALLOC(calendar_file->read_buffer,
+                             calendar_file->buffer_size * 2);
 
         /* Total size remaining (including space used by terminator) */
         buffer_space_remaining = calendar_file->buffer_size + 1;
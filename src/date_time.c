@@ -30,7 +30,18 @@
 #define MAX_HOURS 24
 #define MAX_MINUTES 59
 
-#define MINUTES_IN_HOURS 60
+/*
+ * Days in a week, and how far Thursday is from the Monday of its week.
+ */
+#define DAYS_IN_WEEK 7
+#define MONDAY_TO_THURSDAY 3
+
+/*
+ * Days in a 400 year cycle of the Gregorian calendar, and the number
+ * of days from 0000-03-01 to 0001-01-01. See daysFromCivil.
+ */
+#define DAYS_IN_ERA 146097
+#define DAYS_FROM_MARCH_TO_EPOCH 306
 
 /*
  * Strings for the singular, and plurals for hours and minutes.
@@ -76,6 +87,8 @@ static enum DateTimeError checkDay(int year, int month, int day);
 static enum DateTimeError parseTimeString(const char *const stTime,
     struct Time *time);
 static enum DateTimeError validateTime(int hour, int minutes);
+static long daysFromCivil(int year, int month, int day);
+static void civilFromDays(long days, struct Date *date);
 
 /*
  * Both dateParse and timeParse just do the simple length check
@@ -111,6 +124,16 @@ enum DateTimeError timeParse(const char *const stTime, struct Time *time)
   return error_result;
 }
 
+enum DateTimeError dateValidate(const struct Date *const date)
+{
+  return validateDate(date->year, date->month, date->day);
+}
+
+enum DateTimeError timeValidate(const struct Time *const time)
+{
+  return validateTime(time->hour, time->minutes);
+}
+
 /*
  * Returns the formatted date for displaying to the calendar.
  */
@@ -162,6 +185,108 @@ void timeString(char *const outString, const struct Time *const time)
   }
 }
 
+/*
+ * Whole days, then the minutes into that day.
+ */
+Timestamp timestampFromDateTime(const struct Date *const date,
+                                const struct Time *const time)
+{
+  return (Timestamp) daysFromCivil(date->year, date->month, date->day) *
+         MINUTES_IN_DAY + time->hour * MINUTES_IN_HOURS + time->minutes;
+}
+
+/*
+ * Opposite of timestampFromDateTime.
+ */
+void timestampToDateTime(Timestamp timestamp, struct Date *date,
+                         struct Time *time)
+{
+  int minute_of_day;
+
+  civilFromDays((long) (timestamp / MINUTES_IN_DAY), date);
+
+  minute_of_day = (int) (timestamp % MINUTES_IN_DAY);
+  time->hour = minute_of_day / MINUTES_IN_HOURS;
+  time->minutes = minute_of_day % MINUTES_IN_HOURS;
+}
+
+long dateToDays(const struct Date *const date)
+{
+  return daysFromCivil(date->year, date->month, date->day);
+}
+
+void dateFromDays(long days, struct Date *date)
+{
+  civilFromDays(days, date);
+}
+
+/*
+ * Just days arithmetic, converting to days and back.
+ */
+enum DateTimeError dateAddDays(struct Date *date, long days)
+{
+  enum DateTimeError result;
+  long new_days;
+
+  result = DATETIME_NO_ERROR;
+  new_days = dateToDays(date) + days;
+
+  if (new_days >= 0) {
+    civilFromDays(new_days, date);
+  } else {
+    result = DATETIME_YEAR_INVALID;
+  }
+
+  return result;
+}
+
+long dateDifference(const struct Date *const from,
+                    const struct Date *const to)
+{
+  return dateToDays(to) - dateToDays(from);
+}
+
+/*
+ * 0001-01-01 was a Monday (going back with the Gregorian rules), so
+ * the day number lines up with the weekday.
+ */
+enum Weekday dateWeekday(const struct Date *const date)
+{
+  return (enum Weekday) (dateToDays(date) % DAYS_IN_WEEK);
+}
+
+/*
+ * A week belongs to the year its Thursday is in, and counting the
+ * Thursdays from the start of that year gives the week number.
+ */
+void dateIsoWeek(const struct Date *const date, int *week_year, int *week)
+{
+  struct Date thursday, new_year;
+  long days, thursday_days;
+
+  days = dateToDays(date);
+  thursday_days = days - days % DAYS_IN_WEEK + MONDAY_TO_THURSDAY;
+  dateFromDays(thursday_days, &thursday);
+
+  new_year.year = thursday.year;
+  new_year.month = 1;
+  new_year.day = 1;
+
+  *week_year = thursday.year;
+  *week = (int) ((thursday_days - dateToDays(&new_year)) / DAYS_IN_WEEK) + 1;
+}
+
+/*
+ * Round trip through a timestamp, it already knows how to split the
+ * days from the minutes.
+ */
+void dateTimeAddMinutes(struct Date *date, struct Time *time,
+                        long minutes)
+{
+  timestampToDateTime(timestampFromDateTime(date, time) + minutes, date,
+                      time);
+}
+
 /*
  * Output the formatted duration to the given string.
  *
@@ -431,3 +556,53 @@ static enum DateTimeError validateTime(int hour, int minutes)
 
   return result;
 }
+
+/*
+ * Days since 0001-01-01 for the given date.
+ *
+ * This is Howard Hinnant's days_from_civil algorithm, it treats the
+ * year as starting in March, so the leap day is the last day of the
+ * year and the month lengths follow a simple pattern. No tables, and
+ * no branching on the month.
+ *
+ * Date is assumed to be validated, so the year is never negative.
+ */
+static long daysFromCivil(int year, int month, int day)
+{
+  long shifted_year, era, year_of_era, day_of_year, day_of_era;
+
+  /* Jan and Feb are the end of the previous March based year. */
+  shifted_year = year - (month <= 2);
+  era = shifted_year / 400;
+  year_of_era = shifted_year - era * 400;
+  day_of_year = (153 * ((month + 9) % 12) + 2) / 5 + day - 1;
+  day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 +
+               day_of_year;
+
+  return era * DAYS_IN_ERA + day_of_era - DAYS_FROM_MARCH_TO_EPOCH;
+}
+
+/*
+ * Opposite of daysFromCivil.
+ *
+ * days - Days since 0001-01-01, must not be negative.
+ * date - Updated with the date.
+ */
+static void civilFromDays(long days, struct Date *date)
+{
+  long era, day_of_era, year_of_era, day_of_year, shifted_month;
+
+  days += DAYS_FROM_MARCH_TO_EPOCH;
+  era = days / DAYS_IN_ERA;
+  day_of_era = days - era * DAYS_IN_ERA;
+  year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+                 day_of_era / (DAYS_IN_ERA - 1)) / 365;
+  day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 -
+                              year_of_era / 100);
+  shifted_month = (5 * day_of_year + 2) / 153;
+
+  date->day = (int) (day_of_year - (153 * shifted_month + 2) / 5 + 1);
+  date->month = (int) (shifted_month < 10 ? shifted_month + 3 :
+                       shifted_month - 9);
+  date->year = (int) (year_of_era + era * 400 + (date->month <= 2));
+}
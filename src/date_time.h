@@ -27,28 +27,60 @@
  */
 #define FILE_TIME_FORMAT "%02d:%02d"
 
+/*
+ * Minutes in an hour and in a day, for working with timestamps.
+ */
+#define MINUTES_IN_HOURS 60
+#define MINUTES_IN_DAY (24 * MINUTES_IN_HOURS)
+
 /*
  * Date structure.
  *
+ * Day and month are small, so they're kept small to keep events
+ * compact, a whole date is 8 bytes.
+ *
  * day - day of the time (1 to 31)
  * month - month (1 to 12)
  * year - year (0 to max signed int)
  */
 struct Date {
-  int day;
-  int month;
+  signed char day;
+  signed char month;
   int year;
 };
 
 /*
- * Time structure.
+ * Time structure, 2 bytes.
  *
  * hour - hour in 24 hour based clock.
  * minutes - minutes (0 to 59)
  */
 struct Time {
-  int hour;
-  int minutes;
+  signed char hour;
+  signed char minutes;
+};
+
+/*
+ * A date and time packed into one number, minutes since 00:00 on
+ * 0001-01-01 (the earliest date we accept).
+ *
+ * Earlier date/times always have smaller timestamps, so they can be
+ * compared and subtracted directly. 24:00 is the same timestamp as
+ * 00:00 the next day.
+ */
+typedef long long Timestamp;
+
+/*
+ * Days of the week, in ISO 8601 order (weeks start on Monday).
+ */
+enum Weekday {
+  WEEKDAY_MONDAY,
+  WEEKDAY_TUESDAY,
+  WEEKDAY_WEDNESDAY,
+  WEEKDAY_THURSDAY,
+  WEEKDAY_FRIDAY,
+  WEEKDAY_SATURDAY,
+  WEEKDAY_SUNDAY
 };
 
 /*
@@ -87,6 +119,21 @@ enum DateTimeError dateParse(const char *const stDate, struct Date *date);
  */
 enum DateTimeError timeParse(const char *const stTime, struct Time *time);
 
+/*
+ * Check that the date is a real date, the same checks done by
+ * dateParse.
+ *
+ * Returns: Error about what was invalid, DATETIME_NO_ERROR if no
+ *          error.
+ */
+enum DateTimeError dateValidate(const struct Date *const date);
+
+/*
+ * Check the time is a valid 24 hour time, the same checks done by
+ * timeParse.
+ */
+enum DateTimeError timeValidate(const struct Time *const time);
+
 /*
  * Format the given date to a string.
  *
@@ -109,6 +156,94 @@ void dateString(char *const outString, const struct Date *const date);
  */
 void timeString(char *const outString, const struct Time *const time);
 
+/*
+ * Pack a date and time into a timestamp.
+ *
+ * Both are assumed to be validated.
+ *
+ * date - Date to pack.
+ * time - Time of day on that date.
+ */
+Timestamp timestampFromDateTime(const struct Date *const date,
+                                const struct Time *const time);
+
+/*
+ * Unpack a timestamp back into a date and a time.
+ *
+ * The time will always be 00:00 to 23:59, a time of 24:00 comes
+ * back as 00:00 on the next day.
+ *
+ * timestamp - Timestamp to unpack, must not be negative.
+ * date - Struct to be updated with the date.
+ * time - Struct to be updated with the time.
+ */
+void timestampToDateTime(Timestamp timestamp, struct Date *date,
+                         struct Time *time);
+
+/*
+ * Number of days since 0001-01-01 for the date, so 0001-01-01 is day
+ * 0. The date is assumed to be validated.
+ */
+long dateToDays(const struct Date *const date);
+
+/*
+ * Opposite of dateToDays.
+ *
+ * days - Days since 0001-01-01, must not be negative.
+ * date - Struct to be updated with the date.
+ */
+void dateFromDays(long days, struct Date *date);
+
+/*
+ * Move the date by the given number of days, which can be negative.
+ *
+ * Returns DATETIME_YEAR_INVALID if that would be before 0001-01-01,
+ * the date isn't changed in that case.
+ *
+ * date - Date to update, assumed to be validated.
+ * days - Number of days to move by.
+ */
+enum DateTimeError dateAddDays(struct Date *date, long days);
+
+/*
+ * Number of days from one date to another. Negative if to is before
+ * from.
+ */
+long dateDifference(const struct Date *const from,
+                    const struct Date *const to);
+
+/*
+ * Day of the week for the date.
+ */
+enum Weekday dateWeekday(const struct Date *const date);
+
+/*
+ * ISO 8601 week of the date. Weeks start on Monday, and week 1 is the
+ * week with the year's first Thursday in it, so the first few days of
+ * January can be in the last week of the year before, and the last
+ * few days of December in week 1 of the next year.
+ *
+ * date - Date to find the week of, assumed to be validated.
+ * week_year - Updated with the year the week belongs to.
+ * week - Updated with the week number, 1 to 53.
+ */
+void dateIsoWeek(const struct Date *const date, int *week_year, int *week);
+
+/*
+ * Move a date and time forward by a number of minutes, crossing
+ * midnight, month and year ends as needed. Used for working out when
+ * an event finishes.
+ *
+ * Like timestampToDateTime, a result of midnight is always 00:00,
+ * never 24:00.
+ *
+ * date/time - Start date and time, updated to the result.
+ * minutes - Minutes to move by, must not take the date before
+ *           0001-01-01.
+ */
+void dateTimeAddMinutes(struct Date *date, struct Time *time,
+                        long minutes);
+
 /*
  * Given a duration in minutes, update the given string to have the
  * duration formatted as per the assignment spec.
@@ -0,0 +1,279 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Batch date and time parsing.
+ *
+ * The fast path loads a whole fixed width string into one SSE2
+ * register. All the characters are checked to be digits or the right
+ * separator in one go, then the digits are multiplied by their place
+ * values and added up in pairs with a single multiply-add.
+ *
+ * Anything that isn't in the exact fixed width format, or any build
+ * or CPU without SSE2, just uses dateParse/timeParse. Their results
+ * are the same either way.
+ */
+
+#include <string.h>
+
+#include "bool.h"
+#include "date_time.h"
+#include "date_time_batch.h"
+
+/*
+ * SSE2 is only tried with GCC (or compatible) on x86. The target
+ * attribute means the SSE2 functions compile even when the rest of
+ * the build isn't using SSE2, whether it's used is checked when run.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BATCH_HAVE_SSE2
+#include <emmintrin.h>
+#define SSE2_TARGET __attribute__((target("sse2")))
+#endif
+
+/*
+ * Length of the fixed width strings, YYYY-MM-DD and HH:MM.
+ */
+#define FIXED_DATE_LENGTH 10
+#define FIXED_TIME_LENGTH 5
+
+/*
+ * Size of an SSE2 register in bytes, the strings are copied into a
+ * buffer this size so we never read past the end of them.
+ */
+#define VECTOR_SIZE 16
+
+/*
+ * Bit masks of the positions that must be digits, and separators, in
+ * the fixed width strings. Bit 0 is the first character.
+ *
+ * YYYY-MM-DD - digits at 0-3, 5-6, 8-9, '-' at 4 and 7.
+ * HH:MM - digits at 0-1, 3-4, ':' at 2.
+ */
+#define DATE_DIGIT_MASK 0x36f
+#define DATE_SEPARATOR_MASK 0x090
+#define DATE_SEPARATOR '-'
+#define TIME_DIGIT_MASK 0x01b
+#define TIME_SEPARATOR_MASK 0x004
+#define TIME_SEPARATOR ':'
+
+/*
+ * Forward declarations.
+ */
+static Boolean haveSse2(void);
+static Boolean parseFixedDate(const char *const stDate, struct Date *date,
+                              enum DateTimeError *error);
+static Boolean parseFixedTime(const char *const stTime, struct Time *time,
+                              enum DateTimeError *error);
+
+/*
+ * Try the fast path for each date, fall back to dateParse. Either way
+ * a date with an error is zeroed here, dateParse doesn't always.
+ */
+void dateParseBatch(const char *const *stDates, struct Date *dates,
+                    enum DateTimeError *errors, int count)
+{
+  Boolean use_sse2;
+  int i;
+
+  use_sse2 = haveSse2();
+
+  for (i = 0; i < count; i++) {
+    if (!use_sse2 ||
+        strnlen(stDates[i], FIXED_DATE_LENGTH + 1) != FIXED_DATE_LENGTH ||
+        !parseFixedDate(stDates[i], &dates[i], &errors[i])) {
+      errors[i] = dateParse(stDates[i], &dates[i]);
+    }
+
+    if (errors[i] != DATETIME_NO_ERROR) {
+      dates[i].year = 0;
+      dates[i].month = 0;
+      dates[i].day = 0;
+    }
+  }
+}
+
+/*
+ * Same as dateParseBatch.
+ */
+void timeParseBatch(const char *const *stTimes, struct Time *times,
+                    enum DateTimeError *errors, int count)
+{
+  Boolean use_sse2;
+  int i;
+
+  use_sse2 = haveSse2();
+
+  for (i = 0; i < count; i++) {
+    if (!use_sse2 ||
+        strnlen(stTimes[i], FIXED_TIME_LENGTH + 1) != FIXED_TIME_LENGTH ||
+        !parseFixedTime(stTimes[i], &times[i], &errors[i])) {
+      errors[i] = timeParse(stTimes[i], &times[i]);
+    }
+
+    if (errors[i] != DATETIME_NO_ERROR) {
+      times[i].hour = 0;
+      times[i].minutes = 0;
+    }
+  }
+}
+
+/*
+ * Check once per batch if the CPU we're running on has SSE2.
+ */
+static Boolean haveSse2(void)
+{
+  Boolean result;
+
+  result = FALSE;
+
+#ifdef BATCH_HAVE_SSE2
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("sse2")) {
+    result = TRUE;
+  }
+#endif
+
+  return result;
+}
+
+#ifdef BATCH_HAVE_SSE2
+
+/*
+ * Turn the characters into digit values, and get a register with all
+ * bits set for each character that is a digit. Non digit characters
+ * are 0 in the returned digits.
+ */
+SSE2_TARGET
+static __m128i digitValues(__m128i characters, int *digit_mask)
+{
+  __m128i digits, is_digit;
+
+  /* Anything below '0' wraps around to a large value. */
+  digits = _mm_sub_epi8(characters, _mm_set1_epi8('0'));
+  is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+  *digit_mask = _mm_movemask_epi8(is_digit);
+
+  return _mm_and_si128(digits, is_digit);
+}
+
+/*
+ * Fast path for YYYY-MM-DD, stDate must be exactly that long.
+ *
+ * Returns FALSE if the string isn't in that format, nothing is set in
+ * that case. Otherwise sets the date and error, dateParseBatch zeroes
+ * the date if there's an error.
+ */
+SSE2_TARGET
+static Boolean parseFixedDate(const char *const stDate, struct Date *date,
+                              enum DateTimeError *error)
+{
+  char buffer[VECTOR_SIZE];
+  __m128i characters, digits, low_sums, high_sums;
+  int digit_mask, separator_mask, low_parts[4];
+  Boolean result;
+
+  memset(buffer, 0, VECTOR_SIZE);
+  memcpy(buffer, stDate, FIXED_DATE_LENGTH);
+  characters = _mm_loadu_si128((const __m128i *) buffer);
+
+  digits = digitValues(characters, &digit_mask);
+  separator_mask = _mm_movemask_epi8(
+                     _mm_cmpeq_epi8(characters, _mm_set1_epi8(DATE_SEPARATOR)));
+
+  result = ((digit_mask & DATE_DIGIT_MASK) == DATE_DIGIT_MASK &&
+            (separator_mask & DATE_SEPARATOR_MASK) == DATE_SEPARATOR_MASK);
+
+  if (result) {
+    /*
+     * Widen to 16 bits, multiply each digit by its place value and
+     * add neighbouring pairs. The first 8 characters give the year as
+     * two parts and the month as two parts, the last two give the
+     * day.
+     */
+    low_sums = _mm_madd_epi16(_mm_unpacklo_epi8(digits, _mm_setzero_si128()),
+                              _mm_setr_epi16(1000, 100, 10, 1, 0, 10, 1, 0));
+    high_sums = _mm_madd_epi16(_mm_unpackhi_epi8(digits, _mm_setzero_si128()),
+                               _mm_setr_epi16(10, 1, 0, 0, 0, 0, 0, 0));
+    _mm_storeu_si128((__m128i *) low_parts, low_sums);
+
+    date->year = low_parts[0] + low_parts[1];
+    date->month = low_parts[2] + low_parts[3];
+    date->day = _mm_cvtsi128_si32(high_sums);
+
+    *error = dateValidate(date);
+  }
+
+  return result;
+}
+
+/*
+ * Fast path for HH:MM, stTime must be exactly that long.
+ *
+ * Returns FALSE if the string isn't in that format, nothing is set in
+ * that case. Otherwise sets the time and error, timeParseBatch zeroes
+ * the time if there's an error.
+ */
+SSE2_TARGET
+static Boolean parseFixedTime(const char *const stTime, struct Time *time,
+                              enum DateTimeError *error)
+{
+  char buffer[VECTOR_SIZE];
+  __m128i characters, digits, sums;
+  int digit_mask, separator_mask, parts[4];
+  Boolean result;
+
+  memset(buffer, 0, VECTOR_SIZE);
+  memcpy(buffer, stTime, FIXED_TIME_LENGTH);
+  characters = _mm_loadu_si128((const __m128i *) buffer);
+
+  digits = digitValues(characters, &digit_mask);
+  separator_mask = _mm_movemask_epi8(
+                     _mm_cmpeq_epi8(characters, _mm_set1_epi8(TIME_SEPARATOR)));
+
+  result = ((digit_mask & TIME_DIGIT_MASK) == TIME_DIGIT_MASK &&
+            (separator_mask & TIME_SEPARATOR_MASK) == TIME_SEPARATOR_MASK);
+
+  if (result) {
+    /* Hours are the first pair, minutes are split over the next two. */
+    sums = _mm_madd_epi16(_mm_unpacklo_epi8(digits, _mm_setzero_si128()),
+                          _mm_setr_epi16(10, 1, 0, 10, 1, 0, 0, 0));
+    _mm_storeu_si128((__m128i *) parts, sums);
+
+    time->hour = parts[0];
+    time->minutes = parts[1] + parts[2];
+
+    *error = timeValidate(time);
+  }
+
+  return result;
+}
+
+#else
+
+/*
+ * No SSE2, haveSse2 is always FALSE so these are never called.
+ */
+static Boolean parseFixedDate(const char *const stDate, struct Date *date,
+                              enum DateTimeError *error)
+{
+  (void) stDate;
+  (void) date;
+  (void) error;
+
+  return FALSE;
+}
+
+static Boolean parseFixedTime(const char *const stTime, struct Time *time,
+                              enum DateTimeError *error)
+{
+  (void) stTime;
+  (void) time;
+  (void) error;
+
+  return FALSE;
+}
+
+#endif
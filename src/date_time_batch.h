@@ -0,0 +1,46 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Parsing lots of dates and times at once, for importing large
+ * calendars.
+ *
+ * These give exactly the same results as calling dateParse and
+ * timeParse on each string. Strings in the exact fixed width format
+ * (YYYY-MM-DD and HH:MM) are checked and converted with SSE2 when the
+ * CPU has it, anything else goes through the normal parse functions.
+ */
+
+#ifndef DATE_TIME_BATCH_H_
+#define DATE_TIME_BATCH_H_
+
+#include "date_time.h"
+
+/*
+ * Parse an array of date strings.
+ *
+ * stDates - Array of date strings to parse.
+ * dates - Array to be updated with the dates, any date with an error
+ *         is set to 0-0-0.
+ * errors - Array to be updated with the error for each date.
+ * count - Number of strings, all the arrays must be at least this
+ *         long.
+ */
+void dateParseBatch(const char *const *stDates, struct Date *dates,
+                    enum DateTimeError *errors, int count);
+
+/*
+ * Parse an array of time strings.
+ *
+ * stTimes - Array of time strings to parse.
+ * times - Array to be updated with the times, any time with an error
+ *         is set to 00:00.
+ * errors - Array to be updated with the error for each time.
+ * count - Number of strings, all the arrays must be at least this
+ *         long.
+ */
+void timeParseBatch(const char *const *stTimes, struct Time *times,
+                    enum DateTimeError *errors, int count);
+
+#endif
@@ -13,6 +13,7 @@
 
 #include "bool.h"
 #include "event.h"
+#include "instrument.h"
 
 /*
  * Forward declarations.
@@ -21,6 +22,7 @@ static void updateEventString(struct Event *const event);
 static Boolean durationValid(int duration);
 static enum EventError eventSetName(struct Event *const event,
                                     const char *const name);
+static void eventFreeName(struct Event *const event);
 static enum EventError eventSetLocation(struct Event *const event,
                                         const char *const location);
 void eventDestroy(struct Event *const event);
@@ -38,15 +40,34 @@ enum EventError eventCreate(struct Event **new_event,
                             int duration,
                             const char *const name,
                             const char *const location)
+{
+  return eventCreateInPool(new_event, NULL, stDate, stTime, duration, name,
+                           location);
+}
+
+enum EventError eventCreateInPool(struct Event **new_event,
+                                  struct Pool *pool,
+                                  const char *const stDate,
+                                  const char *const stTime,
+                                  int duration,
+                                  const char *const name,
+                                  const char *const location)
 {
   enum EventError error_result;
   error_result = EVENT_NO_ERROR;
 
   assert(new_event != NULL);
 
-  *new_event = (struct Event *) malloc(sizeof(struct Event));
+  if (pool != NULL) {
+    *new_event = (struct Event *) poolAlloc(pool);
+  } else {
+    *new_event = (struct Event *) INSTRUMENT_MALLOC(sizeof(struct Event));
+  }
 
   if (*new_event != NULL) {
+    (*new_event)->pool = pool;
+    (*new_event)->id = EVENT_NO_ID;
+    (*new_event)->list_node = NULL;
     (*new_event)->name = NULL;
     (*new_event)->location = NULL;
     (*new_event)->formatted_string = NULL;
@@ -55,6 +76,8 @@ enum EventError eventCreate(struct Event **new_event,
       if (timeParse(stTime, &(*new_event)->time) == DATETIME_NO_ERROR) {
         if (durationValid(duration)) {
           (*new_event)->duration = duration;
+          (*new_event)->timestamp =
+            timestampFromDateTime(&(*new_event)->date, &(*new_event)->time);
 
           if (name != NULL && name[0] != '\0') {
             eventSetName(*new_event, name);
@@ -117,9 +140,10 @@ enum EventError eventEdit(struct Event *event_to_edit,
      * event to match.
      */
     eventSetName(event_to_edit, temp_event->name);
-    eventSetLocation(event_to_edit, temp_event->location);
+    eventSetLocation(event_to_edit, eventLocation(temp_event));
     event_to_edit->date = temp_event->date;
     event_to_edit->time = temp_event->time;
+    event_to_edit->timestamp = temp_event->timestamp;
     event_to_edit->duration = temp_event->duration;
 
     /*
@@ -136,6 +160,170 @@ enum EventError eventEdit(struct Event *event_to_edit,
   return error_result;
 }
 
+/*
+ * Just the timestamps, no need to look at the date/time fields.
+ */
+int eventCompareStart(const struct Event *const first,
+                      const struct Event *const second)
+{
+  int result;
+
+  if (first->timestamp < second->timestamp) {
+    result = -1;
+  } else if (first->timestamp > second->timestamp) {
+    result = 1;
+  } else {
+    result = 0;
+  }
+
+  return result;
+}
+
+Timestamp eventEndTimestamp(const struct Event *const event)
+{
+  return event->timestamp + event->duration;
+}
+
+int eventStartMinute(const struct Event *const event)
+{
+  return event->time.hour * MINUTES_IN_HOURS + event->time.minutes;
+}
+
+/*
+ * Each has to start before the other finishes.
+ */
+Boolean eventsOverlap(const struct Event *const first,
+                      const struct Event *const second)
+{
+  return (first->timestamp < eventEndTimestamp(second) &&
+          second->timestamp < eventEndTimestamp(first));
+}
+
+const char *eventLocation(const struct Event *const event)
+{
+  const char *result;
+
+  result = NULL;
+
+  if (event->location != NULL) {
+    result = event->location->name;
+  }
+
+  return result;
+}
+
+/*
+ * Entries in the same table are only the same location if they are
+ * the same entry, anything else needs the strings compared.
+ */
+Boolean eventSameLocation(const struct Event *const first,
+                          const struct Event *const second)
+{
+  Boolean result;
+
+  if (first->location == second->location) {
+    result = TRUE;
+  } else if (first->location == NULL || second->location == NULL) {
+    result = FALSE;
+  } else if (first->location->table != NULL &&
+             first->location->table == second->location->table) {
+    result = FALSE;
+  } else {
+    result = (strcmp(first->location->name, second->location->name) == 0);
+  }
+
+  return result;
+}
+
+/*
+ * Swap the event's entry for the table's one.
+ */
+void eventShareLocation(struct Event *const event,
+                        struct LocationTable *table)
+{
+  struct LocationEntry *shared;
+
+  if (event->location != NULL && event->location->table != table) {
+    shared = locationIntern(table, event->location->name);
+
+    if (shared != NULL) {
+      locationRelease(event->location);
+      event->location = shared;
+    }
+  }
+}
+
+/*
+ * The formatted string has the location in it, so it has to be
+ * rebuilt even if the entry is the same one.
+ */
+void eventUseLocation(struct Event *const event,
+                      struct LocationEntry *location)
+{
+  if (location != event->location) {
+    locationAcquire(location);
+    locationRelease(event->location);
+    event->location = location;
+  }
+
+  updateEventString(event);
+}
+
+/*
+ * Copy an event.
+ *
+ * The formatted string is copied across rather than being rebuilt,
+ * it's the same fields so it will be the same string.
+ */
+enum EventError eventCopy(struct Event **copy,
+                          const struct Event *const original)
+{
+  enum EventError error_result;
+
+  assert(copy != NULL);
+  assert(original != NULL);
+
+  error_result = EVENT_NO_ERROR;
+
+  *copy = (struct Event *) INSTRUMENT_MALLOC(sizeof(struct Event));
+
+  if (*copy != NULL) {
+    **copy = *original;
+    (*copy)->pool = NULL;
+    (*copy)->list_node = NULL;
+    (*copy)->name = NULL;
+    (*copy)->location = NULL;
+    (*copy)->formatted_string = NULL;
+
+    error_result = eventSetName(*copy, original->name);
+
+    if (error_result == EVENT_NO_ERROR) {
+      error_result = eventSetLocation(*copy, eventLocation(original));
+    }
+
+    if (error_result == EVENT_NO_ERROR) {
+      (*copy)->formatted_string =
+        (char *) INSTRUMENT_MALLOC(original->formatted_string_length + 1);
+
+      if ((*copy)->formatted_string != NULL) {
+        memcpy((*copy)->formatted_string, original->formatted_string,
+               original->formatted_string_length + 1);
+      } else {
+        error_result = EVENT_INTERNAL_ERROR;
+      }
+    }
+
+    if (error_result != EVENT_NO_ERROR) {
+      eventDestroy(*copy);
+      *copy = NULL;
+    }
+  } else {
+    error_result = EVENT_INTERNAL_ERROR;
+  }
+
+  return error_result;
+}
+
 /*
  * Destroys an event.
  *
@@ -145,10 +333,15 @@ enum EventError eventEdit(struct Event *event_to_edit,
 void eventDestroy(struct Event *const event)
 {
   if (event != NULL) {
-    free(event->name);
-    free(event->location);
+    eventFreeName(event);
+    locationRelease(event->location);
     free(event->formatted_string);
-    free(event);
+
+    if (event->pool != NULL) {
+      poolFree(event->pool, event);
+    } else {
+      free(event);
+    }
   }
 }
 
@@ -178,7 +371,7 @@ static void updateEventString(struct Event *const event)
   string_length = strlen(event->name) + 1;
 
   if (event->location != NULL) {
-    string_length += strlen(event->location) + 3;
+    string_length += strlen(event->location->name) + 3;
   }
 
   durationString(duration_string, event->duration);
@@ -194,7 +387,7 @@ static void updateEventString(struct Event *const event)
    * Allocate the string (+1 for terminator, returned string size does
    * not include this.)
    */
-  event->formatted_string = (char *)malloc(string_length + 1);
+  event->formatted_string = (char *)INSTRUMENT_MALLOC(string_length + 1);
 
   /* Can't recover from a memory error like this. */
   assert(event->formatted_string != NULL);
@@ -207,7 +400,7 @@ static void updateEventString(struct Event *const event)
   if (event->location != NULL) {
     /* Add the location string */
     strcat(event->formatted_string, "@ ");
-    strcat(event->formatted_string, event->location);
+    strcat(event->formatted_string, event->location->name);
     strcat(event->formatted_string, " ");
   }
 
@@ -222,7 +415,8 @@ static void updateEventString(struct Event *const event)
 }
 
 /*
- * Copies over the name string into the given event.
+ * Copies over the name string into the given event, into name_inline
+ * if it fits.
  *
  * event - Event that we want to update.
  * name - String that the event's name should be updated to.
@@ -244,8 +438,13 @@ static enum EventError eventSetName(struct Event *const event,
 
   if (name_length > 0) {
     /* Free up memory already allocated to the existing event name. */
-    free(event->name);
-    event->name = (char *) malloc(name_length + 1);
+    eventFreeName(event);
+
+    if (name_length < EVENT_INLINE_NAME_SIZE) {
+      event->name = event->name_inline;
+    } else {
+      event->name = (char *) INSTRUMENT_MALLOC(name_length + 1);
+    }
 
     if (event->name != NULL) {
       *event->name = '\0';
@@ -261,7 +460,21 @@ static enum EventError eventSetName(struct Event *const event,
 }
 
 /*
- * Copies over the location string into the given event.
+ * Free the name if it was allocated, inline names are part of the
+ * event.
+ */
+static void eventFreeName(struct Event *const event)
+{
+  if (event->name != event->name_inline) {
+    free(event->name);
+  }
+
+  event->name = NULL;
+}
+
+/*
+ * Copies over the location string into the given event. The event
+ * gets an entry of its own, eventShareLocation can share it after.
  *
  * event - Event that we want to update.
  * location - String that the event's location should be updated to.
@@ -278,7 +491,7 @@ static enum EventError eventSetLocation(struct Event *const event,
   assert(event);
 
   /* Location is allowed to be NULL, so free the memory now. */
-  free(event->location);
+  locationRelease(event->location);
   event->location = NULL;
 
   if (location != NULL) {
@@ -286,12 +499,9 @@ static enum EventError eventSetLocation(struct Event *const event,
   }
 
   if (location_length > 0) {
-    event->location = (char *) malloc(location_length + 1);
+    event->location = locationCreate(location, location_length);
 
-    if (event->location != NULL) {
-      *event->location = '\0';
-      strncat(event->location, location, location_length);
-    } else {
+    if (event->location == NULL) {
       /* Couldn't allocate memory. */
       result = EVENT_INTERNAL_ERROR;
     }
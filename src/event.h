@@ -11,7 +11,10 @@
 
 #include <stdlib.h>
 
+#include "bool.h"
 #include "date_time.h"
+#include "location_table.h"
+#include "pool.h"
 
 /*
  * Number of fields expected to be read from leading format of event
@@ -32,12 +35,42 @@
 #define MAX_LENGTH_OF_NAME 1024
 #define MAX_LENGTH_OF_LOCATION 1024
 
+/*
+ * Names shorter than this (counting the terminator) are kept in the
+ * event itself rather than allocated separately. Most names fit. It's
+ * sized so an event is two cache lines on a 64 bit machine, see
+ * struct Event.
+ */
+#define EVENT_INLINE_NAME_SIZE 48
+
+/*
+ * Events are told apart by an id, given to them by the list they're
+ * put in. EVENT_NO_ID means it hasn't been given one yet.
+ */
+typedef unsigned long long EventId;
+
+#define EVENT_NO_ID 0ULL
+
+/*
+ * Highest id an event can have, so one past it never wraps around to
+ * EVENT_NO_ID.
+ */
+#define EVENT_LAST_ID (~EVENT_NO_ID - 1)
+
 /*
  * The actual events.
  *
- * The strings are all dynamically allocated.
+ * The strings are all dynamically allocated, except short names.
+ *
+ * name - Points to name_inline if the name fits in it, otherwise to
+ *        its own allocation. Either way it's just a string to read.
+ * location - Shared with other events at the same location when the
+ *            event is in a list, see location_table.h. Use
+ *            eventLocation to get the string.
  *
  * date/time - Be sure to just use the date_time.h functions.
+ * timestamp - Date and time packed together, for ordering events.
+ *             Kept up to date by eventCreate and eventEdit.
  *
  * formatted_string - This is a string that represents the event's
  *                    on-screen calendar display. It is automatically
@@ -46,15 +79,35 @@
  * formatted_string_length - Maintained count of length of formatted string,
  *                           just so we don't need strlen calls when looping
  *                           to create calendar display.
+ * pool - Pool the event was allocated from, NULL if it was malloc'd.
+ * id - Unique among the events in the list it's in, and kept when it's
+ *      edited, copied, saved and loaded. EVENT_NO_ID until it's put in
+ *      a list.
+ * list_node - The node holding the event in its list, so it can be
+ *             taken out without looking for it. Only means anything
+ *             while the event is in a list, see event_list.h.
+ *
+ * Lists allocate their events on cache line boundaries, and on a 64
+ * bit machine everything sorting, filtering, searching and finding by
+ * id looks at fits in the first line. The second is only read to show
+ * the event.
  */
 struct Event {
+  /* Used when sorting and filtering, kept together at the start. */
+  Timestamp timestamp;
+  EventId id;
+  int duration;
   struct Date date;
   struct Time time;
-  int duration;
   char *name;
-  char *location; /* Set to null if no location. */
+  struct LocationEntry *location; /* Set to null if no location. */
+  struct EventListNode *list_node;
+  struct Pool *pool;
+
+  /* Only used for display. */
   char *formatted_string;
   int formatted_string_length;
+  char name_inline[EVENT_INLINE_NAME_SIZE];
 };
 
 /*
@@ -67,7 +120,8 @@ enum EventError {
   EVENT_DURATION_INVALID,
   EVENT_NAME_INVALID,
   EVENT_READ_ERROR,
-  EVENT_INTERNAL_ERROR
+  EVENT_INTERNAL_ERROR,
+  EVENT_NOT_FOUND /* No event with that id. */
 };
 
 /*
@@ -95,6 +149,21 @@ enum EventError eventCreate(struct Event **new_event,
                             const char *const name,
                             const char *const location);
 
+/*
+ * Same as eventCreate, but the event is allocated from the pool. It
+ * goes back to the pool when it's destroyed.
+ *
+ * pool - Pool to allocate from, its objects must be at least the size
+ *        of an event. NULL is the same as eventCreate.
+ */
+enum EventError eventCreateInPool(struct Event **new_event,
+                                  struct Pool *pool,
+                                  const char *const stDate,
+                                  const char *const stTime,
+                                  int duration,
+                                  const char *const name,
+                                  const char *const location);
+
 /*
  * Edit an event.
  *
@@ -122,6 +191,87 @@ enum EventError eventEdit(struct Event *event_to_edit,
                           const char *const name,
                           const char *const location);
 
+/*
+ * Compare the start of two events.
+ *
+ * Returns less than zero if first starts before second, zero if they
+ * start at the same time, and greater than zero otherwise.
+ */
+int eventCompareStart(const struct Event *const first,
+                      const struct Event *const second);
+
+/*
+ * Timestamp of when the event finishes, its start plus its duration.
+ */
+Timestamp eventEndTimestamp(const struct Event *const event);
+
+/*
+ * Minutes into the day the event starts, from its time as entered, so
+ * an event at 24:00 is 1440 rather than 0 on the next day.
+ */
+int eventStartMinute(const struct Event *const event);
+
+/*
+ * Returns TRUE if the two events are on at the same time.
+ *
+ * An event finishing at the same time another starts isn't an
+ * overlap. Events with no duration overlap nothing.
+ */
+Boolean eventsOverlap(const struct Event *const first,
+                      const struct Event *const second);
+
+/*
+ * Location string of the event, NULL if it doesn't have one.
+ */
+const char *eventLocation(const struct Event *const event);
+
+/*
+ * Returns TRUE if the two events are at the same location, or both
+ * have no location. Events sharing locations from the same table are
+ * just a pointer comparison.
+ */
+Boolean eventSameLocation(const struct Event *const first,
+                          const struct Event *const second);
+
+/*
+ * Share the event's location with other events using the table.
+ *
+ * If there isn't memory to add the location to the table, the event
+ * just keeps its own location.
+ *
+ * event - Event to update.
+ * table - Table to share the location from.
+ */
+void eventShareLocation(struct Event *const event,
+                        struct LocationTable *table);
+
+/*
+ * Move the event to another location entry, used when locations are
+ * renamed or merged. The event gets a reference to the new entry and
+ * releases the one it had.
+ *
+ * event - Event to update.
+ * location - Entry to use, can be the one the event already has if
+ *            its name has changed.
+ */
+void eventUseLocation(struct Event *const event,
+                      struct LocationEntry *location);
+
+/*
+ * Copy an event.
+ *
+ * Makes a new event with its own copies of all the strings, the
+ * original is not changed.
+ *
+ * Returns EVENT_INTERNAL_ERROR if there was a memory error.
+ *
+ * copy - Set to a pointer to the new event, NULL if there was an
+ *        error.
+ * original - Event to copy.
+ */
+enum EventError eventCopy(struct Event **copy,
+                          const struct Event *const original);
+
 /*
  * Destroy an event.
  *
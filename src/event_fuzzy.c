@@ -0,0 +1,504 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Trigram index and bit-parallel edit distance for event names.
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "event_fuzzy.h"
+
+/*
+ * Bits in a FuzzyWord, queries up to this long use Myers' algorithm,
+ * longer ones the plain table.
+ */
+#define FUZZY_WORD_BITS 64
+
+/*
+ * Most of a query that's looked at, names can't be longer anyway.
+ */
+#define FUZZY_MAX_QUERY MAX_LENGTH_OF_NAME
+
+/*
+ * Characters of the query per edit allowed, when it isn't given.
+ */
+#define FUZZY_CHARACTERS_PER_EDIT 4
+
+/*
+ * A trigram can be lost to an edit at any of its three characters.
+ */
+#define FUZZY_TRIGRAMS_PER_EDIT 3
+
+typedef unsigned long long FuzzyWord;
+
+/*
+ * A query ready for comparing against names.
+ *
+ * text - The query, folded to lower case.
+ * length - Length of text.
+ * peq - For each character, the bits of the positions it's at in
+ *       text. Only filled in if length is up to FUZZY_WORD_BITS.
+ */
+struct FuzzyPattern {
+  unsigned char text[FUZZY_MAX_QUERY + 1];
+  int length;
+  FuzzyWord peq[UCHAR_MAX + 1];
+};
+
+/*
+ * Forward declarations.
+ */
+static unsigned char fold(char character);
+static int trigramBucket(unsigned char first, unsigned char second,
+                         unsigned char third);
+static int nameBuckets(const char *const name, int *buckets, int size);
+static void patternCreate(struct FuzzyPattern *pattern,
+                          const char *const query);
+static int boundedDistance(const struct FuzzyPattern *pattern,
+                           const char *const text, int limit);
+static int myersDistance(const struct FuzzyPattern *pattern,
+                         const char *const text, int text_length, int limit);
+static int tableDistance(const struct FuzzyPattern *pattern,
+                         const char *const text, int text_length, int limit);
+static int addMatch(struct EventFuzzyMatch *matches, int match_count,
+                    int max_matches, struct Event *event, int distance);
+static int compareBuckets(const void *first, const void *second);
+
+/*
+ * Two passes over the names, one to count the postings in each bucket
+ * and one to fill them in, so they all go in one array.
+ */
+struct EventFuzzyIndex *eventFuzzyCreate(struct EventList *list)
+{
+  struct EventFuzzyIndex *index;
+  struct EventListNode *node;
+  int *buckets, *last, *fill;
+  int bucket_count, i, j, b;
+  Boolean memory_ok;
+
+  index = (struct EventFuzzyIndex *) malloc(sizeof(struct EventFuzzyIndex));
+  buckets = (int *) malloc(sizeof(int) * (MAX_LENGTH_OF_NAME + 1));
+  last = (int *) malloc(sizeof(int) * EVENT_FUZZY_BUCKETS);
+  memory_ok = (index != NULL && buckets != NULL && last != NULL);
+
+  if (memory_ok) {
+    index->count = eventListCount(list);
+    index->events = (struct Event **)
+                    malloc(sizeof(struct Event *) * (index->count + 1));
+    index->bucket_starts = (int *)
+                           calloc(EVENT_FUZZY_BUCKETS + 1, sizeof(int));
+    index->postings = NULL;
+    index->list = list;
+    index->modification_count = list->modification_count;
+    memory_ok = (index->events != NULL && index->bucket_starts != NULL);
+  }
+
+  if (memory_ok) {
+    for (b = 0; b < EVENT_FUZZY_BUCKETS; b++) {
+      last[b] = -1;
+    }
+
+    for (node = list->head, i = 0; node != NULL; node = node->next, i++) {
+      index->events[i] = node->event;
+      bucket_count = nameBuckets(node->event->name, buckets,
+                                 MAX_LENGTH_OF_NAME + 1);
+
+      for (j = 0; j < bucket_count; j++) {
+        if (last[buckets[j]] != i) {
+          last[buckets[j]] = i;
+          index->bucket_starts[buckets[j] + 1]++;
+        }
+      }
+    }
+
+    for (b = 0; b < EVENT_FUZZY_BUCKETS; b++) {
+      index->bucket_starts[b + 1] += index->bucket_starts[b];
+    }
+
+    index->postings = (int *)
+      malloc(sizeof(int) * (index->bucket_starts[EVENT_FUZZY_BUCKETS] + 1));
+    memory_ok = (index->postings != NULL);
+  }
+
+  if (memory_ok) {
+    /* last becomes where the next posting of each bucket goes. */
+    fill = last;
+    memcpy(fill, index->bucket_starts, sizeof(int) * EVENT_FUZZY_BUCKETS);
+
+    for (i = 0; i < index->count; i++) {
+      bucket_count = nameBuckets(index->events[i]->name, buckets,
+                                 MAX_LENGTH_OF_NAME + 1);
+
+      for (j = 0; j < bucket_count; j++) {
+        b = buckets[j];
+
+        if (fill[b] == index->bucket_starts[b] ||
+            index->postings[fill[b] - 1] != i) {
+          index->postings[fill[b]] = i;
+          fill[b]++;
+        }
+      }
+    }
+  } else {
+    eventFuzzyDestroy(index);
+    index = NULL;
+  }
+
+  free(buckets);
+  free(last);
+
+  return index;
+}
+
+void eventFuzzyDestroy(struct EventFuzzyIndex *index)
+{
+  if (index != NULL) {
+    free(index->events);
+    free(index->bucket_starts);
+    free(index->postings);
+    free(index);
+  }
+}
+
+Boolean eventFuzzyIsCurrent(const struct EventFuzzyIndex *index,
+                            const struct EventList *list)
+{
+  return (index != NULL && index->list == list &&
+          index->modification_count == list->modification_count);
+}
+
+int eventFuzzyDistance(const char *const first, const char *const second)
+{
+  struct FuzzyPattern *pattern;
+  int result;
+
+  pattern = (struct FuzzyPattern *) malloc(sizeof(struct FuzzyPattern));
+  result = -1;
+
+  if (pattern != NULL) {
+    patternCreate(pattern, first);
+    result = boundedDistance(pattern, second,
+                             pattern->length + (int) strlen(second));
+    free(pattern);
+  }
+
+  return result;
+}
+
+/*
+ * Count how many of the query's trigram buckets each name shares, and
+ * only work out the distance for names sharing enough. If the query
+ * is too short for that to rule anything out, every name is checked.
+ */
+int eventFuzzyFind(struct EventFuzzyIndex *index, const char *const query,
+                   int max_distance, struct EventFuzzyMatch *matches,
+                   int max_matches)
+{
+  struct FuzzyPattern *pattern;
+  int *buckets, *shared;
+  int bucket_count, unique_count, threshold, distance, result, i, p;
+
+  pattern = (struct FuzzyPattern *) malloc(sizeof(struct FuzzyPattern));
+  buckets = (int *) malloc(sizeof(int) * (FUZZY_MAX_QUERY + 1));
+  shared = (int *) calloc(index->count + 1, sizeof(int));
+  result = 0;
+
+  if (pattern != NULL && buckets != NULL && shared != NULL) {
+    patternCreate(pattern, query);
+
+    if (max_distance < 0) {
+      max_distance = pattern->length / FUZZY_CHARACTERS_PER_EDIT;
+
+      if (max_distance < 1) {
+        max_distance = 1;
+      }
+    }
+
+    bucket_count = nameBuckets(query, buckets, FUZZY_MAX_QUERY + 1);
+    qsort(buckets, bucket_count, sizeof(int), &compareBuckets);
+    unique_count = 0;
+
+    for (i = 0; i < bucket_count; i++) {
+      if (unique_count == 0 || buckets[unique_count - 1] != buckets[i]) {
+        buckets[unique_count] = buckets[i];
+        unique_count++;
+      }
+    }
+
+    threshold = unique_count - FUZZY_TRIGRAMS_PER_EDIT * max_distance;
+
+    if (threshold > 0) {
+      for (i = 0; i < unique_count; i++) {
+        for (p = index->bucket_starts[buckets[i]];
+             p < index->bucket_starts[buckets[i] + 1]; p++) {
+          shared[index->postings[p]]++;
+        }
+      }
+    }
+
+    for (i = 0; i < index->count; i++) {
+      if (shared[i] >= threshold) {
+        distance = boundedDistance(pattern, index->events[i]->name,
+                                   max_distance);
+
+        if (distance <= max_distance) {
+          result = addMatch(matches, result, max_matches, index->events[i],
+                            distance);
+        }
+      }
+    }
+  }
+
+  free(pattern);
+  free(buckets);
+  free(shared);
+
+  return result;
+}
+
+static unsigned char fold(char character)
+{
+  return (unsigned char) tolower((unsigned char) character);
+}
+
+/*
+ * Multiplicative hash of the three characters.
+ */
+static int trigramBucket(unsigned char first, unsigned char second,
+                         unsigned char third)
+{
+  unsigned long key;
+
+  key = ((unsigned long) first << 16) | ((unsigned long) second << 8) | third;
+  key = (key * 2654435761UL) & 0xffffffffUL;
+
+  return (int) ((key >> 16) % EVENT_FUZZY_BUCKETS);
+}
+
+/*
+ * The buckets of the name's trigrams, folded. The name is padded with
+ * two 0s in front and one behind, so even short names have trigrams
+ * and the ends count. A name of length n has n + 1 trigrams, only the
+ * first size are given.
+ *
+ * Returns the number of buckets given.
+ */
+static int nameBuckets(const char *const name, int *buckets, int size)
+{
+  unsigned char first, second, third;
+  int result, i;
+
+  first = 0;
+  second = 0;
+  result = 0;
+
+  for (i = 0; name[i] != '\0' && result < size; i++) {
+    third = fold(name[i]);
+    buckets[result] = trigramBucket(first, second, third);
+    result++;
+    first = second;
+    second = third;
+  }
+
+  if (result < size) {
+    buckets[result] = trigramBucket(first, second, 0);
+    result++;
+  }
+
+  return result;
+}
+
+static void patternCreate(struct FuzzyPattern *pattern,
+                          const char *const query)
+{
+  int i;
+
+  pattern->length = 0;
+
+  while (pattern->length < FUZZY_MAX_QUERY &&
+         query[pattern->length] != '\0') {
+    pattern->text[pattern->length] = fold(query[pattern->length]);
+    pattern->length++;
+  }
+
+  pattern->text[pattern->length] = '\0';
+
+  if (pattern->length <= FUZZY_WORD_BITS) {
+    memset(pattern->peq, 0, sizeof(pattern->peq));
+
+    for (i = 0; i < pattern->length; i++) {
+      pattern->peq[pattern->text[i]] |= (FuzzyWord) 1 << i;
+    }
+  }
+}
+
+/*
+ * Distance between the pattern and the text, or limit + 1 if it's
+ * more than limit.
+ */
+static int boundedDistance(const struct FuzzyPattern *pattern,
+                           const char *const text, int limit)
+{
+  int text_length, result;
+
+  text_length = (int) strlen(text);
+
+  if (abs(text_length - pattern->length) > limit) {
+    result = limit + 1;
+  } else if (pattern->length == 0) {
+    result = text_length;
+  } else if (pattern->length <= FUZZY_WORD_BITS) {
+    result = myersDistance(pattern, text, text_length, limit);
+  } else {
+    result = tableDistance(pattern, text, text_length, limit);
+  }
+
+  return result;
+}
+
+/*
+ * Myers' algorithm, as given by Hyyrö for the distance between whole
+ * strings. Each bit of pv/mv is whether the table goes up/down by one
+ * going down the current column at that row of the pattern, and the
+ * whole column is worked out from the last in a few operations. score
+ * is the bottom of the column, and each column can only change it by
+ * one, so once it can't come back under the limit it stops.
+ */
+static int myersDistance(const struct FuzzyPattern *pattern,
+                         const char *const text, int text_length, int limit)
+{
+  FuzzyWord pv, mv, ph, mh, xv, xh, eq, high;
+  int score, j, result;
+
+  pv = ~(FuzzyWord) 0;
+  mv = 0;
+  high = (FuzzyWord) 1 << (pattern->length - 1);
+  score = pattern->length;
+
+  for (j = 0; j < text_length && score - (text_length - j) <= limit; j++) {
+    eq = pattern->peq[fold(text[j])];
+    xv = eq | mv;
+    xh = (((eq & pv) + pv) ^ pv) | eq;
+    ph = mv | ~(xh | pv);
+    mh = pv & xh;
+
+    if (ph & high) {
+      score++;
+    } else if (mh & high) {
+      score--;
+    }
+
+    ph = (ph << 1) | 1;
+    mh = mh << 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+  }
+
+  if (j < text_length || score > limit) {
+    result = limit + 1;
+  } else {
+    result = score;
+  }
+
+  return result;
+}
+
+/*
+ * The usual table, a row at a time, for patterns too long for a word.
+ * Stops once a whole row is over the limit.
+ */
+static int tableDistance(const struct FuzzyPattern *pattern,
+                         const char *const text, int text_length, int limit)
+{
+  int *previous, *current, *swap;
+  int row_min, cost, i, j, result;
+
+  previous = (int *) malloc(sizeof(int) * (text_length + 1));
+  current = (int *) malloc(sizeof(int) * (text_length + 1));
+  result = limit + 1;
+
+  if (previous != NULL && current != NULL) {
+    for (j = 0; j <= text_length; j++) {
+      previous[j] = j;
+    }
+
+    row_min = 0;
+
+    for (i = 1; i <= pattern->length && row_min <= limit; i++) {
+      current[0] = i;
+      row_min = i;
+
+      for (j = 1; j <= text_length; j++) {
+        cost = (pattern->text[i - 1] == fold(text[j - 1])) ? 0 : 1;
+        current[j] = previous[j - 1] + cost;
+
+        if (previous[j] + 1 < current[j]) {
+          current[j] = previous[j] + 1;
+        }
+
+        if (current[j - 1] + 1 < current[j]) {
+          current[j] = current[j - 1] + 1;
+        }
+
+        if (current[j] < row_min) {
+          row_min = current[j];
+        }
+      }
+
+      swap = previous;
+      previous = current;
+      current = swap;
+    }
+
+    if (row_min <= limit && previous[text_length] <= limit) {
+      result = previous[text_length];
+    }
+  }
+
+  free(previous);
+  free(current);
+
+  return result;
+}
+
+/*
+ * Insert into the sorted matches, after any at the same distance, and
+ * drop the last if it's full.
+ *
+ * Returns the new number of matches.
+ */
+static int addMatch(struct EventFuzzyMatch *matches, int match_count,
+                    int max_matches, struct Event *event, int distance)
+{
+  int position;
+
+  position = match_count;
+
+  while (position > 0 && matches[position - 1].distance > distance) {
+    position--;
+  }
+
+  if (position < max_matches) {
+    if (match_count == max_matches) {
+      match_count--;
+    }
+
+    memmove(&matches[position + 1], &matches[position],
+            sizeof(struct EventFuzzyMatch) * (match_count - position));
+    matches[position].event = event;
+    matches[position].distance = distance;
+    match_count++;
+  }
+
+  return match_count;
+}
+
+static int compareBuckets(const void *first, const void *second)
+{
+  return *(const int *) first - *(const int *) second;
+}
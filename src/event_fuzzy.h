@@ -0,0 +1,110 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Finding events by name when the name isn't typed exactly.
+ *
+ * Names are compared by edit distance, the number of characters that
+ * have to be added, removed or changed to turn one into the other,
+ * ignoring case. The distance is worked out with Myers' bit-parallel
+ * algorithm, a column of the usual table at a time in a few word
+ * operations.
+ *
+ * An index of the trigrams (runs of three characters) in each name
+ * keeps it from comparing against every name. A name within distance
+ * k of the query has lost at most 3k of the query's trigrams, so only
+ * names sharing enough of them are compared at all.
+ *
+ * Like an EventIndex, the index doesn't own the events and goes out of
+ * date when the list changes, check it with eventFuzzyIsCurrent.
+ */
+
+#ifndef EVENT_FUZZY_H_
+#define EVENT_FUZZY_H_
+
+#include "bool.h"
+#include "event.h"
+#include "event_list.h"
+
+/*
+ * Number of trigram lists, trigrams are hashed into these.
+ */
+#define EVENT_FUZZY_BUCKETS 65536
+
+/*
+ * The index.
+ *
+ * events - All the events, in list order.
+ * count - Number of events.
+ * bucket_starts - Where each bucket's list starts in postings, the
+ *                 list runs to the next bucket's start.
+ * postings - Positions in events of the names with a trigram in each
+ *            bucket, each name at most once per bucket.
+ * list - The list it was built from.
+ * modification_count - The list's modification_count when this was
+ *                      built.
+ */
+struct EventFuzzyIndex {
+  struct Event **events;
+  int count;
+  int *bucket_starts;
+  int *postings;
+  const struct EventList *list;
+  unsigned long modification_count;
+};
+
+/*
+ * A match.
+ *
+ * event - The event.
+ * distance - Edit distance between its name and the query.
+ */
+struct EventFuzzyMatch {
+  struct Event *event;
+  int distance;
+};
+
+/*
+ * Build an index of the names of the events in the list.
+ *
+ * Returns NULL if there was a memory error.
+ */
+struct EventFuzzyIndex *eventFuzzyCreate(struct EventList *list);
+
+/*
+ * Free the index, the events are left alone.
+ */
+void eventFuzzyDestroy(struct EventFuzzyIndex *index);
+
+/*
+ * Returns TRUE if the index was built from this list and it hasn't
+ * changed since. NULL indexes are never current.
+ */
+Boolean eventFuzzyIsCurrent(const struct EventFuzzyIndex *index,
+                            const struct EventList *list);
+
+/*
+ * Edit distance between two strings, ignoring case. Only the first
+ * MAX_LENGTH_OF_NAME characters of first are used.
+ *
+ * Returns -1 if there was a memory error.
+ */
+int eventFuzzyDistance(const char *const first, const char *const second);
+
+/*
+ * Find the events with names closest to the query.
+ *
+ * max_distance - Largest distance to match, or -1 for one for every
+ *                four characters of the query, at least 1.
+ * matches - Filled with the closest, nearest first, events at the same
+ *           distance in list order.
+ * max_matches - Size of matches.
+ *
+ * Returns the number of matches.
+ */
+int eventFuzzyFind(struct EventFuzzyIndex *index, const char *const query,
+                   int max_distance, struct EventFuzzyMatch *matches,
+                   int max_matches);
+
+#endif
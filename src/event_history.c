@@ -0,0 +1,802 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Persistent treap versions of the calendar for undo/redo.
+ *
+ * All the tree functions take borrowed pointers to nodes, and return
+ * nodes that the caller owns a reference to. So every node returned
+ * has to be released with nodeRelease at some point.
+ *
+ * Running out of memory part way through changing a tree releases
+ * whatever was built so far, and is passed back up, the versions that
+ * were there already are never changed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "event_history.h"
+
+/*
+ * Starting seed for the priority generator, anything but 0 works.
+ */
+#define HISTORY_SEED 2463534242u
+
+/*
+ * Forward declarations.
+ */
+static struct EventHistoryNode *nodeCreate(struct EventHistoryRef *ref,
+                                           struct EventHistoryNode *left,
+                                           struct EventHistoryNode *right,
+                                           unsigned int priority);
+static struct EventHistoryNode *nodeRetain(struct EventHistoryNode *node);
+static void nodeRelease(struct EventHistoryNode *node);
+static int nodeSize(const struct EventHistoryNode *node);
+static EventId nodeId(const struct EventHistoryNode *node);
+static Boolean treapMerge(struct EventHistoryNode *left,
+                          struct EventHistoryNode *right,
+                          struct EventHistoryNode **merged);
+static Boolean treapRemove(struct EventHistoryNode *node, EventId id,
+                           struct EventHistoryNode **removed);
+static struct EventHistoryNode *treapSet(struct EventHistoryNode *node,
+                                         EventId id,
+                                         struct EventHistoryRef *ref);
+static struct EventHistoryRef *treapGet(const struct EventHistoryNode *node,
+                                        int position);
+static struct EventHistoryRef *treapFind(const struct EventHistoryNode *node,
+                                         EventId id);
+static struct EventHistoryRef *treapNext(const struct EventHistoryNode *node,
+                                         EventId id);
+static struct EventHistoryRef *refCreate(struct Event *event);
+static void refRelease(struct EventHistoryRef *ref);
+static Boolean appendRef(struct EventHistory *history,
+                         struct EventHistoryRef *ref,
+                         struct EventHistoryNode **new_root);
+static Boolean listHas(const struct EventList *list,
+                       const struct Event *event);
+static Boolean applyChange(struct EventList *list,
+                           const struct EventHistoryNode *root,
+                           const struct EventHistoryChange *change,
+                           Boolean backwards);
+static unsigned int nextPriority(struct EventHistory *history);
+static void versionRelease(struct EventHistoryVersion *version);
+static void pushVersion(struct EventHistoryVersion *stack, int *count,
+                        const struct EventHistoryVersion *version);
+static void clearVersions(struct EventHistoryVersion *stack, int *count);
+static void commitVersion(struct EventHistory *history,
+                          const struct EventHistoryVersion *version);
+static void stopRecording(struct EventHistory *history);
+
+/*
+ * Create the history from the list.
+ */
+struct EventHistory *eventHistoryCreate(struct EventList *list)
+{
+  struct EventHistory *history;
+
+  history = (struct EventHistory *) malloc(sizeof(struct EventHistory));
+
+  if (history != NULL) {
+    history->current.root = NULL;
+    history->current.change.before = NULL;
+    history->current.change.after = NULL;
+    history->undo_count = 0;
+    history->redo_count = 0;
+    history->seed = HISTORY_SEED;
+
+    eventHistoryReset(history, list);
+  }
+
+  return history;
+}
+
+/*
+ * Releasing all the versions frees everything the history owns,
+ * nothing else holds on to the nodes.
+ */
+void eventHistoryDestroy(struct EventHistory *history)
+{
+  if (history != NULL) {
+    stopRecording(history);
+    free(history);
+  }
+}
+
+/*
+ * Build up the first version one event at a time. The list's nodes
+ * are walked directly so its iterator is left alone.
+ */
+Boolean eventHistoryReset(struct EventHistory *history,
+                          struct EventList *list)
+{
+  struct EventListNode *node;
+  struct EventHistoryNode *new_root;
+  struct EventHistoryRef *ref;
+  Boolean result;
+
+  result = (history != NULL);
+
+  if (result) {
+    stopRecording(history);
+    history->recording = TRUE;
+  }
+
+  /* Building the first version isn't something to undo. */
+  for (node = list->head; node != NULL && result; node = node->next) {
+    ref = refCreate(node->event);
+    result = (ref != NULL && appendRef(history, ref, &new_root));
+
+    if (result) {
+      nodeRelease(history->current.root);
+      history->current.root = new_root;
+    }
+
+    refRelease(ref);
+  }
+
+  if (!result && history != NULL) {
+    stopRecording(history);
+  }
+
+  return result;
+}
+
+/*
+ * Adding to the end is merging a single node tree on the right.
+ */
+enum EventHistoryError eventHistoryInsertLast(struct EventHistory *history,
+                                              struct EventList *list,
+                                              struct Event *event)
+{
+  struct EventHistoryVersion version;
+  struct EventHistoryRef *ref;
+  enum EventHistoryError result;
+
+  if (!eventListInsertLast(list, event)) {
+    result = HISTORY_LIST_ERROR;
+  } else {
+    ref = NULL;
+
+    if (history != NULL && history->recording) {
+      ref = refCreate(event);
+    }
+
+    if (ref != NULL && appendRef(history, ref, &version.root)) {
+      /* The change keeps the reference ref was created with. */
+      version.change.before = NULL;
+      version.change.after = ref;
+      commitVersion(history, &version);
+      result = HISTORY_NO_ERROR;
+    } else {
+      refRelease(ref);
+      eventHistoryReset(history, list);
+      result = HISTORY_NOT_RECORDED;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Take the event's node out of the current version. The event is only
+ * taken out of the list once the new version has been made, so there's
+ * nothing to put back if that fails.
+ */
+enum EventHistoryError eventHistoryDelete(struct EventHistory *history,
+                                          struct EventList *list,
+                                          struct Event *event)
+{
+  struct EventHistoryVersion version;
+  enum EventHistoryError result;
+
+  if (!listHas(list, event)) {
+    result = HISTORY_LIST_ERROR;
+  } else if (history != NULL && history->recording &&
+             treapRemove(history->current.root, event->id, &version.root)) {
+    version.change.before = treapFind(history->current.root, event->id);
+    version.change.before->ref_count++;
+    version.change.after = NULL;
+
+    eventListRemove(list, event);
+    version.change.before->in_list = FALSE;
+    commitVersion(history, &version);
+    result = HISTORY_NO_ERROR;
+  } else {
+    /* The old version's ref to the event is in the list, so left alone. */
+    eventListDelete(list, event);
+    eventHistoryReset(history, list);
+    result = HISTORY_NOT_RECORDED;
+  }
+
+  return result;
+}
+
+/*
+ * Replace is just copying the path down to the original's node.
+ */
+enum EventHistoryError eventHistoryReplace(struct EventHistory *history,
+                                           struct EventList *list,
+                                           struct Event *original,
+                                           struct Event *replacement)
+{
+  struct EventHistoryVersion version;
+  struct EventHistoryRef *ref;
+  enum EventHistoryError result;
+
+  ref = NULL;
+  version.root = NULL;
+
+  if (!listHas(list, original) || replacement == NULL) {
+    result = HISTORY_LIST_ERROR;
+  } else {
+    if (history != NULL && history->recording) {
+      ref = refCreate(replacement);
+
+      if (ref != NULL) {
+        version.root = treapSet(history->current.root, original->id, ref);
+      }
+    }
+
+    eventListReplace(list, original, replacement);
+
+    if (version.root != NULL) {
+      version.change.before = treapFind(history->current.root,
+                                        original->id);
+      version.change.before->ref_count++;
+      version.change.before->in_list = FALSE;
+      version.change.after = ref;
+      commitVersion(history, &version);
+      result = HISTORY_NO_ERROR;
+    } else {
+      refRelease(ref);
+      eventDestroy(original);
+      eventHistoryReset(history, list);
+      result = HISTORY_NOT_RECORDED;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Take the current version's change back off the list, then the
+ * current version goes on the redo stack, and the previous version
+ * becomes current.
+ */
+enum EventHistoryError eventHistoryUndo(struct EventHistory *history,
+                                        struct EventList *list)
+{
+  enum EventHistoryError result;
+
+  if (history == NULL || history->undo_count == 0) {
+    result = HISTORY_EMPTY;
+  } else if (!applyChange(list, history->current.root,
+                          &history->current.change, TRUE)) {
+    result = HISTORY_LIST_ERROR;
+  } else {
+    pushVersion(history->redo, &history->redo_count, &history->current);
+    history->current = history->undo[--history->undo_count];
+    result = HISTORY_NO_ERROR;
+  }
+
+  return result;
+}
+
+/*
+ * Opposite of undo.
+ */
+enum EventHistoryError eventHistoryRedo(struct EventHistory *history,
+                                        struct EventList *list)
+{
+  enum EventHistoryError result;
+
+  if (history == NULL || history->redo_count == 0) {
+    result = HISTORY_EMPTY;
+  } else if (!applyChange(list, history->current.root,
+                          &history->redo[history->redo_count - 1].change,
+                          FALSE)) {
+    result = HISTORY_LIST_ERROR;
+  } else {
+    pushVersion(history->undo, &history->undo_count, &history->current);
+    history->current = history->redo[--history->redo_count];
+    result = HISTORY_NO_ERROR;
+  }
+
+  return result;
+}
+
+int eventHistoryCount(const struct EventHistory *history)
+{
+  int result;
+
+  result = 0;
+
+  if (history != NULL) {
+    result = nodeSize(history->current.root);
+  }
+
+  return result;
+}
+
+const struct Event *eventHistoryGet(const struct EventHistory *history,
+                                    int position)
+{
+  const struct EventHistoryRef *ref;
+  const struct Event *result;
+
+  result = NULL;
+  ref = NULL;
+
+  if (history != NULL) {
+    ref = treapGet(history->current.root, position);
+  }
+
+  if (ref != NULL) {
+    result = ref->event;
+  }
+
+  return result;
+}
+
+/*
+ * Create a node, taking ownership of the left and right references
+ * passed in. The event ref gets another reference for this node.
+ *
+ * Returns NULL if there was a memory error, left and right are
+ * released then.
+ */
+static struct EventHistoryNode *nodeCreate(struct EventHistoryRef *ref,
+                                           struct EventHistoryNode *left,
+                                           struct EventHistoryNode *right,
+                                           unsigned int priority)
+{
+  struct EventHistoryNode *node;
+
+  node = (struct EventHistoryNode *) malloc(sizeof(struct EventHistoryNode));
+
+  if (node != NULL) {
+    node->ref = ref;
+    ref->ref_count++;
+    node->left = left;
+    node->right = right;
+    node->size = nodeSize(left) + nodeSize(right) + 1;
+    node->priority = priority;
+    node->ref_count = 1;
+  } else {
+    nodeRelease(left);
+    nodeRelease(right);
+  }
+
+  return node;
+}
+
+/*
+ * Add a reference, NULL is fine. Returns the node to make passing it
+ * on to nodeCreate easier.
+ */
+static struct EventHistoryNode *nodeRetain(struct EventHistoryNode *node)
+{
+  if (node != NULL) {
+    node->ref_count++;
+  }
+
+  return node;
+}
+
+/*
+ * Drop a reference, freeing the node (and maybe its children and
+ * event) if it was the last one.
+ */
+static void nodeRelease(struct EventHistoryNode *node)
+{
+  if (node != NULL) {
+    node->ref_count--;
+
+    if (node->ref_count == 0) {
+      refRelease(node->ref);
+      nodeRelease(node->left);
+      nodeRelease(node->right);
+      free(node);
+    }
+  }
+}
+
+static int nodeSize(const struct EventHistoryNode *node)
+{
+  int size;
+
+  size = 0;
+
+  if (node != NULL) {
+    size = node->size;
+  }
+
+  return size;
+}
+
+/*
+ * The key the tree is ordered by. Events don't change id while they
+ * are in the history, a replacement takes the id of the one it
+ * replaced.
+ */
+static EventId nodeId(const struct EventHistoryNode *node)
+{
+  return node->ref->event->id;
+}
+
+/*
+ * Join two trees, all of left comes before all of right. The root
+ * with the highest priority stays on top.
+ *
+ * Returns FALSE if there was a memory error, merged is NULL then.
+ */
+static Boolean treapMerge(struct EventHistoryNode *left,
+                          struct EventHistoryNode *right,
+                          struct EventHistoryNode **merged)
+{
+  struct EventHistoryNode *joined;
+  Boolean result;
+
+  result = TRUE;
+  *merged = NULL;
+
+  if (left == NULL) {
+    *merged = nodeRetain(right);
+  } else if (right == NULL) {
+    *merged = nodeRetain(left);
+  } else if (left->priority > right->priority) {
+    result = treapMerge(left->right, right, &joined);
+
+    if (result) {
+      *merged = nodeCreate(left->ref, nodeRetain(left->left), joined,
+                           left->priority);
+      result = (*merged != NULL);
+    }
+  } else {
+    result = treapMerge(left, right->left, &joined);
+
+    if (result) {
+      *merged = nodeCreate(right->ref, joined, nodeRetain(right->right),
+                           right->priority);
+      result = (*merged != NULL);
+    }
+  }
+
+  return result;
+}
+
+/*
+ * The tree without the event with the id, which has to be there. Its
+ * children are merged in its place, and the path down to it copied.
+ *
+ * Returns FALSE if there was a memory error.
+ */
+static Boolean treapRemove(struct EventHistoryNode *node, EventId id,
+                           struct EventHistoryNode **removed)
+{
+  struct EventHistoryNode *child;
+  Boolean result;
+
+  *removed = NULL;
+
+  if (id == nodeId(node)) {
+    result = treapMerge(node->left, node->right, removed);
+  } else if (id < nodeId(node)) {
+    result = treapRemove(node->left, id, &child);
+
+    if (result) {
+      *removed = nodeCreate(node->ref, child, nodeRetain(node->right),
+                            node->priority);
+      result = (*removed != NULL);
+    }
+  } else {
+    result = treapRemove(node->right, id, &child);
+
+    if (result) {
+      *removed = nodeCreate(node->ref, nodeRetain(node->left), child,
+                            node->priority);
+      result = (*removed != NULL);
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Copy the path down to the event with the id, which has to be there,
+ * with the new event at the end of it. The node gets its own reference
+ * to ref.
+ *
+ * Returns NULL if there was a memory error.
+ */
+static struct EventHistoryNode *treapSet(struct EventHistoryNode *node,
+                                         EventId id,
+                                         struct EventHistoryRef *ref)
+{
+  struct EventHistoryNode *result, *child;
+
+  result = NULL;
+
+  if (id < nodeId(node)) {
+    child = treapSet(node->left, id, ref);
+
+    if (child != NULL) {
+      result = nodeCreate(node->ref, child, nodeRetain(node->right),
+                          node->priority);
+    }
+  } else if (id == nodeId(node)) {
+    result = nodeCreate(ref, nodeRetain(node->left),
+                        nodeRetain(node->right), node->priority);
+  } else {
+    child = treapSet(node->right, id, ref);
+
+    if (child != NULL) {
+      result = nodeCreate(node->ref, nodeRetain(node->left), child,
+                          node->priority);
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Walk down using the subtree sizes. NULL if there's no such
+ * position.
+ */
+static struct EventHistoryRef *treapGet(const struct EventHistoryNode *node,
+                                        int position)
+{
+  struct EventHistoryRef *result;
+
+  result = NULL;
+
+  if (position >= 0 && position < nodeSize(node)) {
+    while (result == NULL) {
+      if (position < nodeSize(node->left)) {
+        node = node->left;
+      } else if (position == nodeSize(node->left)) {
+        result = node->ref;
+      } else {
+        position -= nodeSize(node->left) + 1;
+        node = node->right;
+      }
+    }
+  }
+
+  return result;
+}
+
+/*
+ * The event with the id, NULL if it isn't in the tree.
+ */
+static struct EventHistoryRef *treapFind(const struct EventHistoryNode *node,
+                                         EventId id)
+{
+  struct EventHistoryRef *result;
+
+  result = NULL;
+
+  while (node != NULL && result == NULL) {
+    if (id < nodeId(node)) {
+      node = node->left;
+    } else if (id > nodeId(node)) {
+      node = node->right;
+    } else {
+      result = node->ref;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * The event with the lowest id above the given one, NULL if there
+ * isn't one. It's what an event with that id goes in ahead of.
+ */
+static struct EventHistoryRef *treapNext(const struct EventHistoryNode *node,
+                                         EventId id)
+{
+  struct EventHistoryRef *result;
+
+  result = NULL;
+
+  while (node != NULL) {
+    if (id < nodeId(node)) {
+      result = node->ref;
+      node = node->left;
+    } else {
+      node = node->right;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Wrap the event, which is in the list. The ref starts with one
+ * reference for the caller, who either hands it on or releases it.
+ */
+static struct EventHistoryRef *refCreate(struct Event *event)
+{
+  struct EventHistoryRef *ref;
+
+  ref = (struct EventHistoryRef *) malloc(sizeof(struct EventHistoryRef));
+
+  if (ref != NULL) {
+    ref->event = event;
+    ref->ref_count = 1;
+    ref->in_list = TRUE;
+  }
+
+  return ref;
+}
+
+/*
+ * Drop a reference, NULL is fine. The event is destroyed with the
+ * last one, unless the list still has it.
+ */
+static void refRelease(struct EventHistoryRef *ref)
+{
+  if (ref != NULL) {
+    ref->ref_count--;
+
+    if (ref->ref_count == 0) {
+      if (!ref->in_list) {
+        eventDestroy(ref->event);
+      }
+
+      free(ref);
+    }
+  }
+}
+
+/*
+ * Make a new root with the event on the end of the current version.
+ * The current version is left as it is.
+ */
+static Boolean appendRef(struct EventHistory *history,
+                         struct EventHistoryRef *ref,
+                         struct EventHistoryNode **new_root)
+{
+  struct EventHistoryNode *single;
+  Boolean result;
+
+  result = FALSE;
+  single = nodeCreate(ref, NULL, NULL, nextPriority(history));
+
+  if (single != NULL) {
+    result = treapMerge(history->current.root, single, new_root);
+    nodeRelease(single);
+  }
+
+  return result;
+}
+
+/*
+ * TRUE if the event is in the list, without searching it.
+ */
+static Boolean listHas(const struct EventList *list,
+                       const struct Event *event)
+{
+  return (event != NULL && eventListFindId(list, event->id) == event);
+}
+
+/*
+ * Make the change to the list, or take it back if backwards. root is
+ * the version the list is now, for finding the event an added one
+ * goes ahead of, which keeps the list in id order.
+ *
+ * Returns FALSE if the list couldn't be changed, only adding an event
+ * can fail.
+ */
+static Boolean applyChange(struct EventList *list,
+                           const struct EventHistoryNode *root,
+                           const struct EventHistoryChange *change,
+                           Boolean backwards)
+{
+  struct EventHistoryRef *from, *to, *next;
+  Boolean result;
+
+  from = backwards ? change->after : change->before;
+  to = backwards ? change->before : change->after;
+  result = TRUE;
+
+  if (from != NULL && to != NULL) {
+    eventListReplace(list, from->event, to->event);
+  } else if (from != NULL) {
+    eventListRemove(list, from->event);
+  } else if (to != NULL) {
+    next = treapNext(root, to->event->id);
+    result = eventListInsertBefore(list, to->event,
+                                   next != NULL ? next->event : NULL);
+  }
+
+  if (result) {
+    if (from != NULL) {
+      from->in_list = FALSE;
+    }
+
+    if (to != NULL) {
+      to->in_list = TRUE;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Xorshift, we only need the priorities to be well spread, not
+ * actually random.
+ */
+static unsigned int nextPriority(struct EventHistory *history)
+{
+  unsigned int seed;
+
+  seed = history->seed;
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  seed &= 0xffffffffu;
+  history->seed = seed;
+
+  return seed;
+}
+
+static void versionRelease(struct EventHistoryVersion *version)
+{
+  nodeRelease(version->root);
+  refRelease(version->change.before);
+  refRelease(version->change.after);
+}
+
+/*
+ * Push a version onto a stack, dropping the oldest if it's full.
+ */
+static void pushVersion(struct EventHistoryVersion *stack, int *count,
+                        const struct EventHistoryVersion *version)
+{
+  if (*count == EVENT_HISTORY_MAX_UNDO) {
+    versionRelease(&stack[0]);
+    memmove(stack, stack + 1, sizeof(struct EventHistoryVersion) *
+            (EVENT_HISTORY_MAX_UNDO - 1));
+    (*count)--;
+  }
+
+  stack[(*count)++] = *version;
+}
+
+static void clearVersions(struct EventHistoryVersion *stack, int *count)
+{
+  while (*count > 0) {
+    versionRelease(&stack[--(*count)]);
+  }
+}
+
+/*
+ * A change was made, the old version can be undone to, and anything
+ * that was undone is gone for good.
+ */
+static void commitVersion(struct EventHistory *history,
+                          const struct EventHistoryVersion *version)
+{
+  pushVersion(history->undo, &history->undo_count, &history->current);
+  clearVersions(history->redo, &history->redo_count);
+  history->current = *version;
+}
+
+/*
+ * Drop every version, leaving an empty history that isn't recording.
+ * Events the list has are left alone, the rest are destroyed.
+ */
+static void stopRecording(struct EventHistory *history)
+{
+  clearVersions(history->undo, &history->undo_count);
+  clearVersions(history->redo, &history->redo_count);
+  versionRelease(&history->current);
+  history->current.root = NULL;
+  history->current.change.before = NULL;
+  history->current.change.after = NULL;
+  history->recording = FALSE;
+}
@@ -0,0 +1,225 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Undo/redo history of the calendar.
+ *
+ * Every change to the calendar makes a new version of the event
+ * collection. Versions are persistent, a new version shares all the
+ * parts it didn't change with the version it came from, so each
+ * change only costs O(log n) time and memory, not a copy of the
+ * whole calendar.
+ *
+ * Versions are kept as a treap (a binary tree that is balanced by
+ * random priorities) ordered by event id, which is the order of the
+ * list too. Changes copy the path from the root down to the changed
+ * node, everything else is shared. Nodes and events are reference counted, and are freed
+ * when the last version using them is dropped.
+ *
+ * The versions hold the list's own events, not copies of them.
+ * Changes are made to the list through the history, so an event that
+ * is deleted or replaced is kept by the history for as long as a
+ * version can still get back to it, instead of being destroyed. An
+ * event can't be edited in place, since older versions would see the
+ * edit, a changed copy replaces it instead. Undo and redo make the
+ * one change between two versions to the list, so the list is the
+ * current version at all times. Events are found by their id, so
+ * nothing here has to search the list.
+ */
+
+#ifndef EVENT_HISTORY_H_
+#define EVENT_HISTORY_H_
+
+#include "bool.h"
+#include "event.h"
+#include "event_list.h"
+
+/*
+ * Max number of versions we can undo back through. When full, the
+ * oldest version is dropped.
+ */
+#define EVENT_HISTORY_MAX_UNDO 256
+
+/*
+ * What happened to a change made through the history.
+ */
+enum EventHistoryError {
+  HISTORY_NO_ERROR,
+  HISTORY_EMPTY, /* Nothing to undo or redo. */
+  HISTORY_LIST_ERROR, /* The list couldn't be changed, nothing was. */
+  HISTORY_NOT_RECORDED /* The list was changed, but the history ran out
+                          of memory recording it, it's been cleared. */
+};
+
+/*
+ * An event shared between versions.
+ *
+ * event - The event, never changed once it's in the history.
+ * ref_count - Number of version nodes and changes using this event.
+ * in_list - TRUE while the event is in the list, it belongs to the
+ *           list then and the history mustn't destroy it.
+ */
+struct EventHistoryRef {
+  struct Event *event;
+  int ref_count;
+  Boolean in_list;
+};
+
+/*
+ * Node of a version tree.
+ *
+ * Nodes are never changed once they are created, apart from the
+ * ref_count.
+ *
+ * ref - Event at this node.
+ * left/right - Events before and after this one.
+ * size - Number of events in this subtree, used to find positions.
+ * priority - Random priority, parents always have a higher priority
+ *            than their children.
+ * ref_count - Number of parent nodes, and versions, using this node.
+ */
+struct EventHistoryNode {
+  struct EventHistoryRef *ref;
+  struct EventHistoryNode *left;
+  struct EventHistoryNode *right;
+  int size;
+  unsigned int priority;
+  int ref_count;
+};
+
+/*
+ * The change that made a version from the one before it, everything
+ * needed to make it to the list again or take it back. A replacement
+ * has the id of the event it replaced, so both have the same id.
+ *
+ * before - Event before the change, NULL if one was added.
+ * after - Event after the change, NULL if it was deleted.
+ */
+struct EventHistoryChange {
+  struct EventHistoryRef *before;
+  struct EventHistoryRef *after;
+};
+
+/*
+ * root - Root of the version's tree, NULL if it's empty.
+ * change - How it was made, both refs are NULL for the first version.
+ */
+struct EventHistoryVersion {
+  struct EventHistoryNode *root;
+  struct EventHistoryChange change;
+};
+
+/*
+ * The history.
+ *
+ * current - The current version, the same events as the list.
+ * undo - The previous versions, most recent last.
+ * redo - The undone versions, most recently undone last.
+ * recording - FALSE if there wasn't the memory to build a version of
+ *             the list, changes are just made to the list then, and
+ *             there's nothing to undo until the history is reset.
+ * seed - State for the priority generator.
+ */
+struct EventHistory {
+  struct EventHistoryVersion current;
+  struct EventHistoryVersion undo[EVENT_HISTORY_MAX_UNDO];
+  int undo_count;
+  struct EventHistoryVersion redo[EVENT_HISTORY_MAX_UNDO];
+  int redo_count;
+  Boolean recording;
+  unsigned int seed;
+};
+
+/*
+ * Create a history, with the events in the list as the first
+ * version. There's nothing to undo to start with.
+ *
+ * Returns NULL if there was a memory error creating the history. If
+ * it's the first version that can't be built, the history isn't
+ * recording, see eventHistoryReset.
+ *
+ * A NULL history can still be passed to the other functions, it acts
+ * like one that isn't recording and can't be reset: changes are just
+ * made to the list, and there's never anything to undo or redo.
+ */
+struct EventHistory *eventHistoryCreate(struct EventList *list);
+
+/*
+ * Destroy the history, and all the versions in it. The events in the
+ * list are left alone.
+ */
+void eventHistoryDestroy(struct EventHistory *history);
+
+/*
+ * Throw away all versions, and start again with the events in the
+ * list as the only version. Has to be done whenever the list is
+ * changed other than through the history, or replaced.
+ *
+ * Returns FALSE if there was a memory error, the history isn't
+ * recording in that case.
+ */
+Boolean eventHistoryReset(struct EventHistory *history,
+                          struct EventList *list);
+
+/*
+ * Add the event to the end of the list.
+ *
+ * The list takes ownership of the event, unless HISTORY_LIST_ERROR is
+ * returned.
+ */
+enum EventHistoryError eventHistoryInsertLast(struct EventHistory *history,
+                                              struct EventList *list,
+                                              struct Event *event);
+
+/*
+ * Delete the event from the list.
+ *
+ * Returns HISTORY_LIST_ERROR if the event isn't in the list.
+ */
+enum EventHistoryError eventHistoryDelete(struct EventHistory *history,
+                                          struct EventList *list,
+                                          struct Event *event);
+
+/*
+ * Replace original in the list with replacement, see eventListReplace.
+ *
+ * The list takes ownership of replacement, unless HISTORY_LIST_ERROR
+ * is returned because original isn't in the list.
+ */
+enum EventHistoryError eventHistoryReplace(struct EventHistory *history,
+                                           struct EventList *list,
+                                           struct Event *original,
+                                           struct Event *replacement);
+
+/*
+ * Take back the last change from the list, and go back to the
+ * previous version.
+ *
+ * Returns HISTORY_EMPTY if there was nothing to undo, or
+ * HISTORY_LIST_ERROR if there wasn't the memory to put a deleted
+ * event back, nothing is changed in either case.
+ */
+enum EventHistoryError eventHistoryUndo(struct EventHistory *history,
+                                        struct EventList *list);
+
+/*
+ * Make the last undone change to the list again, and go forward to
+ * its version. Returns the same as eventHistoryUndo.
+ */
+enum EventHistoryError eventHistoryRedo(struct EventHistory *history,
+                                        struct EventList *list);
+
+/*
+ * Number of events in the current version.
+ */
+int eventHistoryCount(const struct EventHistory *history);
+
+/*
+ * Event at the position in the current version, NULL if there's no
+ * such position. The event belongs to the list.
+ */
+const struct Event *eventHistoryGet(const struct EventHistory *history,
+                                    int position);
+
+#endif
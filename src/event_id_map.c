@@ -0,0 +1,208 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Open addressed hash table from event ids to events.
+ */
+
+#include <stdlib.h>
+
+#include "event_id_map.h"
+#include "instrument.h"
+
+#define ID_MAP_INITIAL_CAPACITY 64
+
+/*
+ * Forward declarations.
+ */
+static int slotHome(const struct EventIdMap *map, EventId id);
+static int slotFind(const struct EventIdMap *map, EventId id);
+static Boolean grow(struct EventIdMap *map);
+
+void eventIdMapInit(struct EventIdMap *map)
+{
+  map->slots = NULL;
+  map->capacity = 0;
+  map->count = 0;
+}
+
+void eventIdMapFree(struct EventIdMap *map)
+{
+  free(map->slots);
+  eventIdMapInit(map);
+}
+
+/*
+ * Only grows for a new id, so replacing the event under an id that's
+ * already there always works.
+ */
+Boolean eventIdMapPut(struct EventIdMap *map, EventId id,
+                      struct Event *event, int value)
+{
+  Boolean result;
+  int position;
+
+  result = TRUE;
+  position = -1;
+
+  if (map->slots != NULL) {
+    position = slotFind(map, id);
+  }
+
+  if (position < 0 || map->slots[position].id == EVENT_NO_ID) {
+    if ((map->count + 1) * 2 > map->capacity) {
+      result = grow(map);
+    }
+
+    if (result) {
+      position = slotFind(map, id);
+      map->slots[position].id = id;
+      map->count++;
+    }
+  }
+
+  if (result) {
+    map->slots[position].event = event;
+    map->slots[position].value = value;
+  }
+
+  return result;
+}
+
+struct Event *eventIdMapGet(const struct EventIdMap *map, EventId id)
+{
+  struct Event *result;
+  int position;
+
+  result = NULL;
+
+  if (map->slots != NULL && id != EVENT_NO_ID) {
+    position = slotFind(map, id);
+
+    if (map->slots[position].id == id) {
+      result = map->slots[position].event;
+    }
+  }
+
+  return result;
+}
+
+int eventIdMapValue(const struct EventIdMap *map, EventId id)
+{
+  int result, position;
+
+  result = -1;
+
+  if (map->slots != NULL && id != EVENT_NO_ID) {
+    position = slotFind(map, id);
+
+    if (map->slots[position].id == id) {
+      result = map->slots[position].value;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Empty the slot, then move back any later slot in the same run that
+ * couldn't be found past the gap any more.
+ */
+void eventIdMapRemove(struct EventIdMap *map, EventId id)
+{
+  int mask, gap, current, home;
+
+  if (map->slots != NULL && id != EVENT_NO_ID) {
+    gap = slotFind(map, id);
+
+    if (map->slots[gap].id == id) {
+      mask = map->capacity - 1;
+      current = (gap + 1) & mask;
+
+      while (map->slots[current].id != EVENT_NO_ID) {
+        home = slotHome(map, map->slots[current].id);
+
+        /* Moves if its home isn't cyclically in (gap, current]. */
+        if (((current - home) & mask) >= ((current - gap) & mask)) {
+          map->slots[gap] = map->slots[current];
+          gap = current;
+        }
+
+        current = (current + 1) & mask;
+      }
+
+      map->slots[gap].id = EVENT_NO_ID;
+      map->slots[gap].event = NULL;
+      map->count--;
+    }
+  }
+}
+
+/*
+ * Ids are mostly handed out in order, so they're mixed up with a
+ * multiply before taking the bits for the slot.
+ */
+static int slotHome(const struct EventIdMap *map, EventId id)
+{
+  id *= 0x9E3779B97F4A7C15ULL;
+  id ^= id >> 32;
+
+  return (int) (id & (EventId) (map->capacity - 1));
+}
+
+/*
+ * Linear probing, returns the id's slot or the empty slot where it
+ * would go.
+ */
+static int slotFind(const struct EventIdMap *map, EventId id)
+{
+  int result;
+
+  result = slotHome(map, id);
+
+  while (map->slots[result].id != EVENT_NO_ID &&
+         map->slots[result].id != id) {
+    result = (result + 1) & (map->capacity - 1);
+  }
+
+  return result;
+}
+
+/*
+ * Double the slots and put everything in again.
+ */
+static Boolean grow(struct EventIdMap *map)
+{
+  struct EventIdSlot *old_slots;
+  int old_capacity, i;
+  Boolean result;
+
+  old_slots = map->slots;
+  old_capacity = map->capacity;
+
+  if (old_capacity == 0) {
+    map->capacity = ID_MAP_INITIAL_CAPACITY;
+  } else {
+    map->capacity = old_capacity * 2;
+  }
+
+  map->slots = (struct EventIdSlot *)
+               INSTRUMENT_CALLOC(map->capacity, sizeof(struct EventIdSlot));
+  result = (map->slots != NULL);
+
+  if (result) {
+    for (i = 0; i < old_capacity; i++) {
+      if (old_slots[i].id != EVENT_NO_ID) {
+        map->slots[slotFind(map, old_slots[i].id)] = old_slots[i];
+      }
+    }
+
+    free(old_slots);
+  } else {
+    map->slots = old_slots;
+    map->capacity = old_capacity;
+  }
+
+  return result;
+}
@@ -0,0 +1,83 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Finding an event by its id in constant time.
+ *
+ * A hash table with open addressing, the ids are kept in the slots
+ * with the events so probing doesn't touch the events at all. It's
+ * kept at most half full, and slots are emptied by moving later ones
+ * back rather than leaving markers, so lookups stay short however many
+ * events come and go.
+ *
+ * Each slot has a number as well as the event, for anything that needs
+ * to keep something of its own for each event (like an EventTextIndex
+ * does). The event list doesn't use it.
+ */
+
+#ifndef EVENT_ID_MAP_H_
+#define EVENT_ID_MAP_H_
+
+#include "bool.h"
+#include "event.h"
+
+/*
+ * id - The event's id, EVENT_NO_ID if the slot is empty.
+ * event - The event.
+ * value - The number kept with it.
+ */
+struct EventIdSlot {
+  EventId id;
+  struct Event *event;
+  int value;
+};
+
+/*
+ * slots - The table, NULL until the first event is put in.
+ * capacity - Size of slots, a power of two.
+ * count - Events in the map.
+ */
+struct EventIdMap {
+  struct EventIdSlot *slots;
+  int capacity;
+  int count;
+};
+
+/*
+ * Start an empty map, nothing is allocated until it's used.
+ */
+void eventIdMapInit(struct EventIdMap *map);
+
+/*
+ * Free the slots, the events are left alone.
+ */
+void eventIdMapFree(struct EventIdMap *map);
+
+/*
+ * Add the event and value under the id, replacing whatever is already
+ * there. The id can't be EVENT_NO_ID. It doesn't have to be the
+ * event's id yet, so the event can be left alone if this fails.
+ *
+ * Returns FALSE if there was a memory error, which can't happen when
+ * the id is already in the map.
+ */
+Boolean eventIdMapPut(struct EventIdMap *map, EventId id,
+                      struct Event *event, int value);
+
+/*
+ * The event with that id, NULL if there isn't one.
+ */
+struct Event *eventIdMapGet(const struct EventIdMap *map, EventId id);
+
+/*
+ * The value kept with that id, -1 if there isn't one.
+ */
+int eventIdMapValue(const struct EventIdMap *map, EventId id);
+
+/*
+ * Take the event with that id out, if there is one.
+ */
+void eventIdMapRemove(struct EventIdMap *map, EventId id);
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Building and searching the sorted event indexes.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "event_index.h"
+
+/*
+ * Which string of the event a string range search looks at.
+ */
+enum IndexField {
+  INDEX_FIELD_NAME,
+  INDEX_FIELD_LOCATION
+};
+
+/*
+ * Forward declarations.
+ */
+static void sortEvents(struct Event **events, struct Event **buffer,
+                       int count,
+                       int (*compare)(const struct Event *const,
+                                      const struct Event *const));
+static void fillColumns(struct EventIndex *index);
+static int compareName(const struct Event *const first,
+                       const struct Event *const second);
+static int compareLocation(const struct Event *const first,
+                           const struct Event *const second);
+static const char *indexField(const struct Event *const event,
+                              enum IndexField field);
+static int compareKey(const char *const value, const char *const key,
+                      size_t key_length, Boolean prefix);
+static int stringRange(struct Event **events, int count,
+                       enum IndexField field, const char *const key,
+                       Boolean prefix, int *first);
+
+/*
+ * Copy the events into each array, then sort them.
+ */
+struct EventIndex *eventIndexCreate(struct EventList *list)
+{
+  struct EventIndex *index;
+  struct EventListNode *current_node;
+  struct Event **buffer;
+  int count;
+
+  index = (struct EventIndex *) malloc(sizeof(struct EventIndex));
+
+  if (index != NULL) {
+    count = 0;
+
+    for (current_node = list->head; current_node != NULL;
+         current_node = current_node->next) {
+      count++;
+    }
+
+    /* +1 so an empty list doesn't look like a memory error. */
+    index->by_start = (struct Event **)
+                      malloc(sizeof(struct Event *) * (count + 1));
+    index->by_name = (struct Event **)
+                     malloc(sizeof(struct Event *) * (count + 1));
+    index->by_location = (struct Event **)
+                         malloc(sizeof(struct Event *) * (count + 1));
+    index->starts = (Timestamp *) malloc(sizeof(Timestamp) * (count + 1));
+    index->durations = (int *) malloc(sizeof(int) * (count + 1));
+    index->start_minutes = (short *) malloc(sizeof(short) * (count + 1));
+    buffer = (struct Event **) malloc(sizeof(struct Event *) * (count + 1));
+
+    if (index->by_start != NULL && index->by_name != NULL &&
+        index->by_location != NULL && index->starts != NULL &&
+        index->durations != NULL && index->start_minutes != NULL &&
+        buffer != NULL) {
+      index->count = 0;
+      index->location_count = 0;
+      index->max_duration = 0;
+      index->modification_count = list->modification_count;
+
+      for (current_node = list->head; current_node != NULL;
+           current_node = current_node->next) {
+        struct Event *event = current_node->event;
+
+        index->by_start[index->count] = event;
+        index->by_name[index->count] = event;
+        index->count++;
+
+        if (event->location != NULL) {
+          index->by_location[index->location_count++] = event;
+        }
+
+        if (event->duration > index->max_duration) {
+          index->max_duration = event->duration;
+        }
+      }
+
+      sortEvents(index->by_start, buffer, index->count, eventCompareStart);
+      fillColumns(index);
+      sortEvents(index->by_name, buffer, index->count, compareName);
+      sortEvents(index->by_location, buffer, index->location_count,
+                 compareLocation);
+    } else {
+      eventIndexDestroy(index);
+      index = NULL;
+    }
+
+    free(buffer);
+  }
+
+  return index;
+}
+
+void eventIndexDestroy(struct EventIndex *index)
+{
+  if (index != NULL) {
+    free(index->by_start);
+    free(index->starts);
+    free(index->durations);
+    free(index->start_minutes);
+    free(index->by_name);
+    free(index->by_location);
+    free(index);
+  }
+}
+
+Boolean eventIndexIsCurrent(const struct EventIndex *index,
+                            const struct EventList *list)
+{
+  Boolean result;
+
+  result = FALSE;
+
+  if (index != NULL &&
+      index->modification_count == list->modification_count) {
+    result = TRUE;
+  }
+
+  return result;
+}
+
+/*
+ * Binary search for the first start that isn't before the timestamp.
+ */
+int eventIndexSeekStart(const struct EventIndex *index, Timestamp start)
+{
+  int low, high, middle;
+
+  low = 0;
+  high = index->count;
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+
+    if (index->starts[middle] < start) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+int eventIndexNameRange(const struct EventIndex *index,
+                        const char *const name, Boolean prefix,
+                        int *first)
+{
+  return stringRange(index->by_name, index->count, INDEX_FIELD_NAME, name,
+                     prefix, first);
+}
+
+int eventIndexLocationRange(const struct EventIndex *index,
+                            const char *const location, Boolean prefix,
+                            int *first)
+{
+  return stringRange(index->by_location, index->location_count,
+                     INDEX_FIELD_LOCATION, location, prefix, first);
+}
+
+/*
+ * Merge sort, since qsort doesn't keep equal events in the order
+ * they were in.
+ *
+ * buffer - Scratch space at least count long.
+ */
+static void sortEvents(struct Event **events, struct Event **buffer,
+                       int count,
+                       int (*compare)(const struct Event *const,
+                                      const struct Event *const))
+{
+  int half, left, right, merged;
+
+  if (count > 1) {
+    half = count / 2;
+    sortEvents(events, buffer, half, compare);
+    sortEvents(events + half, buffer, count - half, compare);
+
+    left = 0;
+    right = half;
+    merged = 0;
+
+    /* Take from the left on ties, that's what keeps it stable. */
+    while (left < half && right < count) {
+      if (compare(events[right], events[left]) < 0) {
+        buffer[merged++] = events[right++];
+      } else {
+        buffer[merged++] = events[left++];
+      }
+    }
+
+    while (left < half) {
+      buffer[merged++] = events[left++];
+    }
+
+    while (right < count) {
+      buffer[merged++] = events[right++];
+    }
+
+    memcpy(events, buffer, sizeof(struct Event *) * count);
+  }
+}
+
+/*
+ * Copy the hot fields out of the events in by_start order.
+ */
+static void fillColumns(struct EventIndex *index)
+{
+  int i;
+
+  for (i = 0; i < index->count; i++) {
+    index->starts[i] = index->by_start[i]->timestamp;
+    index->durations[i] = index->by_start[i]->duration;
+    index->start_minutes[i] = (short) eventStartMinute(index->by_start[i]);
+  }
+}
+
+static int compareName(const struct Event *const first,
+                       const struct Event *const second)
+{
+  int result;
+
+  result = strcmp(first->name, second->name);
+
+  if (result == 0) {
+    result = eventCompareStart(first, second);
+  }
+
+  return result;
+}
+
+static int compareLocation(const struct Event *const first,
+                           const struct Event *const second)
+{
+  int result;
+
+  /* Events sharing a location entry don't need the strings compared. */
+  if (eventSameLocation(first, second)) {
+    result = 0;
+  } else {
+    result = strcmp(eventLocation(first), eventLocation(second));
+  }
+
+  if (result == 0) {
+    result = eventCompareStart(first, second);
+  }
+
+  return result;
+}
+
+static const char *indexField(const struct Event *const event,
+                              enum IndexField field)
+{
+  const char *result;
+
+  if (field == INDEX_FIELD_NAME) {
+    result = event->name;
+  } else {
+    result = eventLocation(event);
+  }
+
+  return result;
+}
+
+/*
+ * Compare a value with the key being searched for. For prefix
+ * searches only the first key_length characters of the value count,
+ * which still keeps the sorted order.
+ */
+static int compareKey(const char *const value, const char *const key,
+                      size_t key_length, Boolean prefix)
+{
+  int result;
+
+  if (prefix) {
+    result = strncmp(value, key, key_length);
+  } else {
+    result = strcmp(value, key);
+  }
+
+  return result;
+}
+
+/*
+ * Two binary searches, one for the first value not less than the
+ * key, and one for the first value greater than it.
+ */
+static int stringRange(struct Event **events, int count,
+                       enum IndexField field, const char *const key,
+                       Boolean prefix, int *first)
+{
+  int low, high, middle, end;
+  size_t key_length;
+
+  key_length = strlen(key);
+
+  low = 0;
+  high = count;
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+
+    if (compareKey(indexField(events[middle], field), key, key_length,
+                   prefix) < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  *first = low;
+
+  high = count;
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+
+    if (compareKey(indexField(events[middle], field), key, key_length,
+                   prefix) <= 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  end = low;
+
+  return end - *first;
+}
@@ -0,0 +1,105 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Sorted indexes over an EventList.
+ *
+ * An index is built from the list as it is at the time, and is a set
+ * of arrays of the list's events sorted different ways, so searches
+ * can binary search instead of going through every event.
+ *
+ * The index doesn't own the events, and goes out of date as soon as
+ * the list is changed. Use eventIndexIsCurrent to check before using
+ * one, anything using an out of date index can crash.
+ */
+
+#ifndef EVENT_INDEX_H_
+#define EVENT_INDEX_H_
+
+#include "bool.h"
+#include "date_time.h"
+#include "event.h"
+#include "event_list.h"
+
+/*
+ * The index.
+ *
+ * by_start - All events, in order of their start timestamp. Events
+ *            starting at the same time are in list order.
+ * starts/durations/start_minutes - Columns with the start timestamp,
+ *                                  duration and minute of the day of
+ *                                  each event in by_start, so scans on
+ *                                  them go through small arrays
+ *                                  instead of the events.
+ * by_name - All events, in order of name (strcmp order).
+ * by_location - Events that have a location, in order of location,
+ *               then start.
+ * count - Number of events in by_start and by_name.
+ * location_count - Number of events in by_location.
+ * max_duration - Longest duration of any event. An event can't
+ *                overlap a time more than this many minutes after it
+ *                starts.
+ * modification_count - The list's modification_count when this was
+ *                      built.
+ */
+struct EventIndex {
+  struct Event **by_start;
+  Timestamp *starts;
+  int *durations;
+  short *start_minutes;
+  struct Event **by_name;
+  struct Event **by_location;
+  int count;
+  int location_count;
+  int max_duration;
+  unsigned long modification_count;
+};
+
+/*
+ * Build an index of the events in the list.
+ *
+ * Returns NULL if there was a memory error.
+ */
+struct EventIndex *eventIndexCreate(struct EventList *list);
+
+/*
+ * Free the index, the events are left alone.
+ */
+void eventIndexDestroy(struct EventIndex *index);
+
+/*
+ * Returns TRUE if the list hasn't changed since the index was built
+ * from it. NULL indexes are never current.
+ */
+Boolean eventIndexIsCurrent(const struct EventIndex *index,
+                            const struct EventList *list);
+
+/*
+ * Position in by_start of the first event starting at or after the
+ * given timestamp. Returns count if there isn't one.
+ */
+int eventIndexSeekStart(const struct EventIndex *index, Timestamp start);
+
+/*
+ * Find the events in by_name with the given name.
+ *
+ * name - Name to look for.
+ * prefix - If TRUE, find names starting with name, rather than
+ *          matching exactly.
+ * first - Set to the position in by_name of the first match.
+ *
+ * Returns the number of matches, they are all together from first.
+ */
+int eventIndexNameRange(const struct EventIndex *index,
+                        const char *const name, Boolean prefix,
+                        int *first);
+
+/*
+ * Same as eventIndexNameRange, but for locations in by_location.
+ */
+int eventIndexLocationRange(const struct EventIndex *index,
+                            const char *const location, Boolean prefix,
+                            int *first);
+
+#endif
@@ -9,11 +9,23 @@
 #include <string.h>
 
 #include "event_list.h"
+#include "instrument.h"
+#include "trace.h"
 
 /*
- * String that is put at the end of the events in the calendar text.
+ * Forward declarations.
  */
-#define EVENT_END_TERMINATOR "\n---"
+static void notifyAdded(struct EventList *list, struct Event *event);
+static void notifyChanged(struct EventList *list, struct Event *event);
+static void notifyRemoved(struct EventList *list, struct Event *event);
+static Boolean listHolds(const struct EventList *list,
+                         const struct Event *event);
+static Boolean idFits(const struct EventList *list,
+                      const struct Event *event,
+                      const struct Event *before);
+static char *allocateString(size_t events_size, int count);
+static char *appendEvent(char *end, const struct Event *event,
+                         Boolean last);
 
 /*
  * Creates an empty list, returning a pointer to the list.
@@ -28,6 +40,25 @@ struct EventList *eventListCreate()
     new_list->head = NULL;
     new_list->tail = NULL;
     new_list->current = NULL;
+    new_list->modification_count = 0;
+    new_list->watchers = NULL;
+    new_list->next_id = EVENT_NO_ID + 1;
+    eventIdMapInit(&new_list->ids);
+    new_list->locations = locationTableCreate();
+    new_list->node_pool = poolCreate(sizeof(struct EventListNode),
+                                     EVENT_LIST_SLAB_OBJECTS, 0);
+    new_list->event_pool = poolCreate(sizeof(struct Event),
+                                      EVENT_LIST_SLAB_OBJECTS,
+                                      POOL_CACHE_LINE);
+
+    if (new_list->locations == NULL || new_list->node_pool == NULL ||
+        new_list->event_pool == NULL) {
+      locationTableDestroy(new_list->locations);
+      poolRelease(new_list->node_pool);
+      poolRelease(new_list->event_pool);
+      free(new_list);
+      new_list = NULL;
+    }
   }
 
   return new_list;
@@ -53,17 +84,32 @@ void eventListDestroy(struct EventList *list)
   while (current_node != NULL) {
     next_node = current_node->next;
     eventDestroy(current_node->event);
-    current_node->next = NULL;
-    free(current_node);
+    poolFree(list->node_pool, current_node);
     current_node = next_node;
   }
 
   list->head = NULL;
   list->tail = NULL;
 
+  eventIdMapFree(&list->ids);
+  locationTableDestroy(list->locations);
+  poolRelease(list->node_pool);
+  poolRelease(list->event_pool);
   free(list);
 }
 
+enum EventError eventListCreateEvent(struct EventList *list,
+                                     struct Event **new_event,
+                                     const char *const stDate,
+                                     const char *const stTime,
+                                     int duration,
+                                     const char *const name,
+                                     const char *const location)
+{
+  return eventCreateInPool(new_event, list->event_pool, stDate, stTime,
+                           duration, name, location);
+}
+
 /*
  * Resets the list so the next call with "next" will return the first
  * event in the list.
@@ -98,32 +144,81 @@ struct Event *eventListNext(struct EventList *list)
  */
 Boolean eventListInsertLast(struct EventList *list,
                             struct Event *to_insert)
+{
+  return eventListInsertBefore(list, to_insert, NULL);
+}
+
+/*
+ * Link a new node in ahead of the node holding before, or after the
+ * tail if there isn't one. The list is in id order, so the tail has
+ * the highest id, and an id that isn't above it is already taken or
+ * would be out of order. The event's id is only set once nothing else
+ * can fail.
+ */
+Boolean eventListInsertBefore(struct EventList *list,
+                              struct Event *to_insert,
+                              struct Event *before)
 {
   struct EventListNode *new_node;
+  EventId id;
   Boolean result;
 
   result = FALSE;
 
-  if (to_insert != NULL) {
-    new_node = (struct EventListNode *) malloc(sizeof(
-                 struct EventListNode));
+  if (to_insert != NULL &&
+      (before == NULL || idFits(list, to_insert, before))) {
+    id = to_insert->id;
+    new_node = NULL;
+
+    if (before == NULL &&
+        (id == EVENT_NO_ID || id > EVENT_LAST_ID ||
+         (list->tail != NULL && id <= list->tail->event->id))) {
+      id = list->next_id;
+    }
+
+    /* Past EVENT_LAST_ID, every id has been given out. */
+    if (id <= EVENT_LAST_ID) {
+      new_node = (struct EventListNode *) poolAlloc(list->node_pool);
+    }
+
+    if (new_node != NULL && !eventIdMapPut(&list->ids, id, to_insert, 0)) {
+      poolFree(list->node_pool, new_node);
+      new_node = NULL;
+    }
 
     if (new_node != NULL) {
+      to_insert->id = id;
+
+      if (id >= list->next_id) {
+        list->next_id = id + 1;
+      }
+
+      eventShareLocation(to_insert, list->locations);
       new_node->event = to_insert;
-      new_node->next = NULL;
+      to_insert->list_node = new_node;
+
+      if (before != NULL) {
+        new_node->next = before->list_node;
+        new_node->previous = before->list_node->previous;
+      } else {
+        new_node->next = NULL;
+        new_node->previous = list->tail;
+      }
 
-      /*
-       * First item inserted into list.
-       */
-      if (list->head == NULL) {
+      if (new_node->previous != NULL) {
+        new_node->previous->next = new_node;
+      } else {
         list->head = new_node;
       }
 
-      if (list->tail != NULL) {
-        list->tail->next = new_node;
+      if (new_node->next != NULL) {
+        new_node->next->previous = new_node;
+      } else {
+        list->tail = new_node;
       }
 
-      list->tail = new_node;
+      list->modification_count++;
+      notifyAdded(list, to_insert);
       result = TRUE;
     }
   }
@@ -140,53 +235,76 @@ Boolean eventListInsertLast(struct EventList *list,
  */
 char *eventListString(struct EventList *list)
 {
-  char *result;
+  char *result, *end;
+  size_t total_size;
+  int count;
+  struct Event *current_event;
+
   result = NULL;
 
-  if (list->head != NULL) {
-    int current_size, num_of_events;
-    struct Event *current_event;
+  traceBegin("eventListString");
+  INSTRUMENT_START(INSTRUMENT_RENDER);
 
-    current_size = 0;
-    num_of_events = 0;
+  if (list->head != NULL) {
+    total_size = 0;
+    count = 0;
 
     eventListResetPosition(list);
     current_event = eventListNext(list);
 
     while (current_event != NULL) {
-      current_size += current_event->formatted_string_length;
-      num_of_events++;
+      total_size += current_event->formatted_string_length;
+      count++;
       current_event = eventListNext(list);
     }
 
-    /*
-     * Allocate memory for the whole string of formatted events.
-     *
-     * This includes 6 extra characters per entry for the formatting.
-     * The last entry only has 5 (no line space. But has terminator.)
-     * TODO: No Magic numbers.
-     */
-    current_size += (6 * num_of_events) - 1;
-
-    result = (char *)malloc(current_size);
+    result = allocateString(total_size, count);
 
     if (result != NULL) {
+      end = result;
       eventListResetPosition(list);
       current_event = eventListNext(list);
-      *result = '\0';
 
       while (current_event != NULL) {
-        strncat(result, current_event->formatted_string,
-                current_event->formatted_string_length);
+        end = appendEvent(end, current_event, list->current == NULL);
+        current_event = eventListNext(list);
+      }
 
-        if (list->current != NULL) {
-          strcat(result, EVENT_END_TERMINATOR "\n\n");
-        } else {
-          strcat(result, EVENT_END_TERMINATOR);
-        }
+      *end = '\0';
+    }
+  }
 
-        current_event = eventListNext(list);
+  INSTRUMENT_STOP(INSTRUMENT_RENDER);
+  traceEnd("eventListString");
+
+  return result;
+}
+
+char *eventListArrayString(struct Event *const *events, int count)
+{
+  char *result, *end;
+  size_t total_size;
+  int i;
+
+  result = NULL;
+
+  if (count > 0) {
+    total_size = 0;
+
+    for (i = 0; i < count; i++) {
+      total_size += events[i]->formatted_string_length;
+    }
+
+    result = allocateString(total_size, count);
+
+    if (result != NULL) {
+      end = result;
+
+      for (i = 0; i < count; i++) {
+        end = appendEvent(end, events[i], i + 1 == count);
       }
+
+      *end = '\0';
     }
   }
 
@@ -201,6 +319,9 @@ struct Event *eventListFind(struct EventList *list, char *search_string)
   struct Event *result;
   Boolean not_found;
 
+  traceBegin("eventListFind");
+  INSTRUMENT_START(INSTRUMENT_FIND);
+
   eventListResetPosition(list);
   result = eventListNext(list);
 
@@ -210,6 +331,8 @@ struct Event *eventListFind(struct EventList *list, char *search_string)
    * Loop through the list, looking at each event for a match.
    */
   while (result != NULL && not_found) {
+    INSTRUMENT_COUNT(INSTRUMENT_FIND_PROBES, 1);
+
     if (strcmp(search_string, result->name) == 0) {
       not_found = FALSE;
     } else {
@@ -217,60 +340,373 @@ struct Event *eventListFind(struct EventList *list, char *search_string)
     }
   }
 
+  INSTRUMENT_STOP(INSTRUMENT_FIND);
+  traceEnd("eventListFind");
+
+  return result;
+}
+
+/*
+ * Walk the nodes counting until we find the event.
+ */
+int eventListPosition(struct EventList *list, const struct Event *event)
+{
+  struct EventListNode *current_node;
+  int position, result;
+
+  result = -1;
+  position = 0;
+  current_node = list->head;
+
+  while (current_node != NULL && result == -1) {
+    if (current_node->event == event) {
+      result = position;
+    } else {
+      position++;
+      current_node = current_node->next;
+    }
+  }
+
   return result;
 }
 
-Boolean eventListDelete(struct EventList *list, struct Event *to_delete) {
+int eventListCount(const struct EventList *list)
+{
+  const struct EventListNode *current_node;
+  int result;
+
+  result = 0;
+
+  for (current_node = list->head; current_node != NULL;
+       current_node = current_node->next) {
+    result++;
+  }
+
+  return result;
+}
+
+struct Event *eventListFindId(const struct EventList *list, EventId id)
+{
+  return eventIdMapGet(&list->ids, id);
+}
+
+/*
+ * Delete event, the event is destroyed once it's unlinked.
+ */
+Boolean eventListDelete(struct EventList *list, struct Event *to_delete)
+{
   Boolean node_found;
 
-  struct EventListNode *previous_node;
-  struct EventListNode *next_node;
-  struct EventListNode *node_to_delete;
+  traceBegin("eventListDelete");
 
-  node_found = FALSE;
+  node_found = eventListRemove(list, to_delete);
 
-  previous_node = NULL;
+  if (node_found) {
+    eventDestroy(to_delete);
+  }
 
-  /* Start with the first node */
-  node_to_delete = list->head;
+  traceEnd("eventListDelete");
 
-  /* Step through the nodes of the list */
-  while (node_to_delete != NULL && !node_found) {
-    /*
-     * If this is the node we're going to remove, we need the pointer
-     * to the next node.
-     */
-    next_node = node_to_delete->next;
+  return node_found;
+}
 
-    /* We have a match! */
-    if (node_to_delete->event == to_delete) {
-      /* If we had a previous node, link to the next node. */
-      if (previous_node != NULL) {
-        previous_node->next = next_node;
-      }
+Boolean eventListDeleteId(struct EventList *list, EventId id)
+{
+  struct Event *to_delete;
+  Boolean result;
 
-      /* Are we deleting the head node? */
-      if (list->head == node_to_delete) {
-        /* Yep, so next node is the new head. */
-        list->head = next_node;
-      }
+  to_delete = eventIdMapGet(&list->ids, id);
+  result = FALSE;
 
-      /* Deleting the tail node? */
-      if (list->tail == node_to_delete) {
-        /* Yep, make tail the previous node. */
-        list->tail = previous_node;
-      }
+  if (to_delete != NULL) {
+    result = eventListDelete(list, to_delete);
+  }
+
+  return result;
+}
+
+/*
+ * Edit the event, and note that the list changed.
+ */
+enum EventError eventListEdit(struct EventList *list,
+                              struct Event *event_to_edit,
+                              const char *const stDate,
+                              const char *const stTime,
+                              const int duration,
+                              const char *const name,
+                              const char *const location)
+{
+  enum EventError error_result;
+
+  error_result = eventEdit(event_to_edit, stDate, stTime, duration, name,
+                           location);
+
+  if (error_result == EVENT_NO_ERROR) {
+    eventShareLocation(event_to_edit, list->locations);
+    list->modification_count++;
+    notifyChanged(list, event_to_edit);
+  }
+
+  return error_result;
+}
+
+enum EventError eventListEditId(struct EventList *list, EventId id,
+                                const char *const stDate,
+                                const char *const stTime,
+                                const int duration,
+                                const char *const name,
+                                const char *const location)
+{
+  struct Event *event_to_edit;
+  enum EventError error_result;
+
+  event_to_edit = eventIdMapGet(&list->ids, id);
+
+  if (event_to_edit != NULL) {
+    error_result = eventListEdit(list, event_to_edit, stDate, stTime,
+                                 duration, name, location);
+  } else {
+    error_result = EVENT_NOT_FOUND;
+  }
+
+  return error_result;
+}
 
-      eventDestroy(node_to_delete->event);
-      free(node_to_delete);
+/*
+ * Unlink the node holding the event, leaving the event alone.
+ */
+Boolean eventListRemove(struct EventList *list, struct Event *to_remove) {
+  Boolean node_found;
+  struct EventListNode *node_to_delete;
+
+  node_found = listHolds(list, to_remove);
+
+  if (node_found) {
+    node_to_delete = to_remove->list_node;
+
+    if (node_to_delete->previous != NULL) {
+      node_to_delete->previous->next = node_to_delete->next;
+    } else {
+      list->head = node_to_delete->next;
+    }
 
-      node_found = TRUE;
+    if (node_to_delete->next != NULL) {
+      node_to_delete->next->previous = node_to_delete->previous;
     } else {
-      /* Not the right one, keep looking. */
-      previous_node = node_to_delete;
-      node_to_delete = node_to_delete->next;
+      list->tail = node_to_delete->previous;
+    }
+
+    /* Don't leave the iterator pointing at a freed node. */
+    if (list->current == node_to_delete) {
+      list->current = node_to_delete->next;
     }
+
+    poolFree(list->node_pool, node_to_delete);
+    to_remove->list_node = NULL;
+    eventIdMapRemove(&list->ids, to_remove->id);
+    list->modification_count++;
+    notifyRemoved(list, to_remove);
   }
 
   return node_found;
 }
+
+/*
+ * Swap the event held by a node, the node itself stays where it is.
+ */
+Boolean eventListReplace(struct EventList *list, struct Event *original,
+                         struct Event *replacement)
+{
+  Boolean node_found;
+
+  node_found = (replacement != NULL && listHolds(list, original));
+
+  if (node_found) {
+    /* The id is already in the map, so this can't run out of memory. */
+    replacement->id = original->id;
+    eventIdMapPut(&list->ids, replacement->id, replacement, 0);
+    eventShareLocation(replacement, list->locations);
+    replacement->list_node = original->list_node;
+    replacement->list_node->event = replacement;
+    original->list_node = NULL;
+    list->modification_count++;
+    notifyRemoved(list, original);
+    notifyAdded(list, replacement);
+  }
+
+  return node_found;
+}
+
+/*
+ * If nothing is at the new location yet, the entry is renamed.
+ * Otherwise the events are moved over to the entry that is there, and
+ * the old entry is taken out of the table. The events still need
+ * visiting either way, since their formatted strings have the
+ * location in them.
+ */
+Boolean eventListRenameLocation(struct EventList *list,
+                                const char *const old_location,
+                                const char *const new_location)
+{
+  struct LocationEntry *old_entry, *new_entry;
+  struct EventListNode *current_node;
+  Boolean result;
+
+  old_entry = locationFind(list->locations, old_location);
+  new_entry = locationFind(list->locations, new_location);
+  result = (old_entry != NULL);
+
+  if (result && new_entry == NULL) {
+    result = locationRename(old_entry, new_location);
+    new_entry = old_entry;
+  } else if (result && new_entry != old_entry) {
+    locationDetach(old_entry);
+  }
+
+  if (result) {
+    for (current_node = list->head; current_node != NULL;
+         current_node = current_node->next) {
+      if (current_node->event->location == old_entry) {
+        eventUseLocation(current_node->event, new_entry);
+        notifyChanged(list, current_node->event);
+      }
+    }
+
+    list->modification_count++;
+  }
+
+  return result;
+}
+
+void eventListWatch(struct EventList *list,
+                    struct EventListWatcher *watcher)
+{
+  watcher->next = list->watchers;
+  list->watchers = watcher;
+}
+
+void eventListUnwatch(struct EventList *list,
+                      struct EventListWatcher *watcher)
+{
+  struct EventListWatcher **link;
+
+  link = &list->watchers;
+
+  while (*link != NULL && *link != watcher) {
+    link = &(*link)->next;
+  }
+
+  if (*link != NULL) {
+    *link = watcher->next;
+    watcher->next = NULL;
+  }
+}
+
+static void notifyAdded(struct EventList *list, struct Event *event)
+{
+  struct EventListWatcher *watcher;
+
+  for (watcher = list->watchers; watcher != NULL; watcher = watcher->next) {
+    watcher->added(watcher->data, event);
+  }
+}
+
+static void notifyChanged(struct EventList *list, struct Event *event)
+{
+  struct EventListWatcher *watcher;
+
+  for (watcher = list->watchers; watcher != NULL; watcher = watcher->next) {
+    watcher->changed(watcher->data, event);
+  }
+}
+
+static void notifyRemoved(struct EventList *list, struct Event *event)
+{
+  struct EventListWatcher *watcher;
+
+  for (watcher = list->watchers; watcher != NULL; watcher = watcher->next) {
+    watcher->removed(watcher->data, event);
+  }
+}
+
+/*
+ * TRUE if the event is in this list, so its list_node can be used.
+ * The node pointer alone can't say, an event in another list has one
+ * too.
+ */
+static Boolean listHolds(const struct EventList *list,
+                         const struct Event *event)
+{
+  return (event != NULL && eventIdMapGet(&list->ids, event->id) == event);
+}
+
+/*
+ * Whether event can go in ahead of before and keep the list in id
+ * order. Only an event going back where it was taken out from can.
+ */
+static Boolean idFits(const struct EventList *list,
+                      const struct Event *event,
+                      const struct Event *before)
+{
+  const struct EventListNode *previous;
+  Boolean result;
+
+  result = (event->id != EVENT_NO_ID && listHolds(list, before) &&
+            event->id < before->id);
+
+  if (result) {
+    previous = before->list_node->previous;
+    result = (previous == NULL || previous->event->id < event->id);
+  }
+
+  return result;
+}
+
+/*
+ * Room for the calendar string of count events, whose own strings add
+ * up to events_size. Every event gets a terminator, all but the last
+ * a separator, and there's the null at the end.
+ *
+ * Returns NULL if count is 0 or there was a memory error.
+ */
+static char *allocateString(size_t events_size, int count)
+{
+  char *result;
+  size_t total_size;
+
+  result = NULL;
+
+  if (count > 0) {
+    total_size = events_size + strlen(EVENT_END_TERMINATOR) * count +
+                 strlen(EVENT_SEPARATOR) * (count - 1) + 1;
+
+    result = (char *) INSTRUMENT_MALLOC(total_size);
+
+    if (result != NULL) {
+      INSTRUMENT_COUNT(INSTRUMENT_RENDER_BYTES, total_size);
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Copy the event's string and terminator to end, and the separator
+ * unless it's the last event.
+ *
+ * Returns the new end of the string, which isn't null terminated.
+ */
+static char *appendEvent(char *end, const struct Event *event, Boolean last)
+{
+  memcpy(end, event->formatted_string, event->formatted_string_length);
+  end += event->formatted_string_length;
+  memcpy(end, EVENT_END_TERMINATOR, strlen(EVENT_END_TERMINATOR));
+  end += strlen(EVENT_END_TERMINATOR);
+
+  if (!last) {
+    memcpy(end, EVENT_SEPARATOR, strlen(EVENT_SEPARATOR));
+    end += strlen(EVENT_SEPARATOR);
+  }
+
+  return end;
+}
@@ -11,41 +11,149 @@
 
 #include "bool.h"
 #include "event.h"
+#include "event_id_map.h"
+#include "location_table.h"
+#include "pool.h"
+
+/*
+ * String that is put at the end of the events in the calendar text.
+ */
+#define EVENT_END_TERMINATOR "\n---"
+
+/*
+ * String that is put between one event's terminator and the next event.
+ */
+#define EVENT_SEPARATOR "\n\n"
 
 /*
  * Just using a double ended linked list for events. Since we need to
  * add new events to the end of the list, and need to go through the
  * list in order.
+ *
+ * It's doubly linked, and each event points back at its node, so an
+ * event can be taken out without going through the list to find it.
  */
 struct EventListNode {
   struct Event *event;
   struct EventListNode *next;
+  struct EventListNode *previous;
 };
 
+/*
+ * Something that wants to know when the events in a list change, like
+ * an index that keeps itself up to date. The event is passed to each
+ * function along with data.
+ *
+ * added - After the event is put in the list.
+ * changed - After the event is changed in place, by eventListEdit or
+ *           eventListRenameLocation.
+ * removed - After the event is taken out of the list, before it's
+ *           destroyed if it's being deleted.
+ * next - Used by the list to link its watchers.
+ */
+struct EventListWatcher {
+  void (*added)(void *data, struct Event *event);
+  void (*changed)(void *data, struct Event *event);
+  void (*removed)(void *data, struct Event *event);
+  void *data;
+  struct EventListWatcher *next;
+};
+
+/*
+ * Number of nodes, or events, allocated at a time by a list's pools.
+ */
+#define EVENT_LIST_SLAB_OBJECTS 64
+
+/*
+ * locations - Locations of the events in the list, events at the
+ *             same location share one entry.
+ * node_pool - Where the list's nodes come from.
+ * event_pool - Where events made with eventListCreateEvent come from.
+ *              Events from here can still be removed from the list
+ *              and outlive it.
+ * modification_count - Goes up every time the events in the list are
+ *                      changed, so anything built from the list (like
+ *                      an EventIndex) can tell if it's out of date.
+ * watchers - Told about each change, see eventListWatch.
+ * next_id - Id given to the next event put in without one, or with one
+ *           already used in the list.
+ * ids - The events by id.
+ */
 struct EventList {
   struct EventListNode *head;
   struct EventListNode *tail;
   struct EventListNode *current;
+  struct LocationTable *locations;
+  struct Pool *node_pool;
+  struct Pool *event_pool;
+  unsigned long modification_count;
+  struct EventListWatcher *watchers;
+  EventId next_id;
+  struct EventIdMap ids;
 };
 
 /*
- * Create a new event list and return a pointer to it.
+ * Create a new event list and return a pointer to it, NULL if there
+ * was a memory error.
  */
 struct EventList *eventListCreate();
 
 /*
  * Destroy the given list.
  *
- * Will clean up all the events, and free all the memory.
+ * Will clean up all the events, and free all the memory. Watchers
+ * aren't told, they should be taken off first.
  */
 void eventListDestroy(struct EventList *list);
 
+/*
+ * Start and stop telling a watcher about changes to the list. The
+ * watcher isn't copied, it has to stay around until it's taken off.
+ */
+void eventListWatch(struct EventList *list,
+                    struct EventListWatcher *watcher);
+void eventListUnwatch(struct EventList *list,
+                      struct EventListWatcher *watcher);
+
 /*
  * Insert the given event into the end of the list.
+ *
+ * The event's location is shared with any other events in the list at
+ * the same location. It keeps its id if it has one above every id in
+ * the list (like one loaded from a file), otherwise it's given a new
+ * one, so the list is always in id order. Ids of events taken out of
+ * the list aren't given out again by it.
  */
 Boolean eventListInsertLast(struct EventList *list,
                             struct Event *to_insert);
 
+/*
+ * Insert the given event just ahead of before, or at the end if
+ * before is NULL, the same as eventListInsertLast.
+ *
+ * Ahead of before, the event has to keep the list in id order, so its
+ * id has to be between those of before and the event ahead of it, as
+ * it is for an event put back where it was removed from. Returns FALSE
+ * if it isn't, or before isn't in the list.
+ */
+Boolean eventListInsertBefore(struct EventList *list,
+                              struct Event *to_insert,
+                              struct Event *before);
+
+/*
+ * Create an event from the list's pool, same as eventCreate. It isn't
+ * put in the list, that still needs eventListInsertLast.
+ *
+ * Only the thread that changes the list can use this.
+ */
+enum EventError eventListCreateEvent(struct EventList *list,
+                                     struct Event **new_event,
+                                     const char *const stDate,
+                                     const char *const stTime,
+                                     int duration,
+                                     const char *const name,
+                                     const char *const location);
+
 /*
  * Reset the internal iterator, so that eventListNext will return the
  * first event in the list.
@@ -64,6 +172,14 @@ struct Event *eventListNext(struct EventList *list);
  */
 char *eventListString(struct EventList *list);
 
+/*
+ * The same string as eventListString, for count events in an array.
+ *
+ * Returns NULL if count is 0 or there was a memory error, otherwise
+ * the string, which the caller frees using free().
+ */
+char *eventListArrayString(struct Event *const *events, int count);
+
 /*
  * Search for event.
  *
@@ -76,12 +192,96 @@ char *eventListString(struct EventList *list);
  */
 struct Event *eventListFind(struct EventList *list, char *search_string);
 
+/*
+ * Position of event.
+ *
+ * Returns the position of the given event in the list, counting from
+ * 0 at the head. Returns -1 if the event isn't in the list.
+ */
+int eventListPosition(struct EventList *list, const struct Event *event);
+
+/*
+ * Number of events in the list.
+ */
+int eventListCount(const struct EventList *list);
+
+/*
+ * The event with the id, NULL if there isn't one in the list.
+ */
+struct Event *eventListFindId(const struct EventList *list, EventId id);
+
 /*
  * Delete event.
  *
- * Given a pointer to an event, delete it from the list.
+ * Given a pointer to an event, delete it from the list. Takes the
+ * same time however long the list is, the list isn't searched.
  * Returns TRUE if the delete succeeded, FALSE otherwise.
  */
 Boolean eventListDelete(struct EventList *list, struct Event *to_delete);
 
+/*
+ * Delete the event with the id, returns FALSE if there isn't one.
+ */
+Boolean eventListDeleteId(struct EventList *list, EventId id);
+
+/*
+ * Edit event.
+ *
+ * Same as eventEdit, but should be used for events in a list so the
+ * list knows it has changed.
+ */
+enum EventError eventListEdit(struct EventList *list,
+                              struct Event *event_to_edit,
+                              const char *const stDate,
+                              const char *const stTime,
+                              const int duration,
+                              const char *const name,
+                              const char *const location);
+
+/*
+ * Edit the event with the id, same as eventListEdit.
+ *
+ * Returns EVENT_NOT_FOUND if there isn't one.
+ */
+enum EventError eventListEditId(struct EventList *list, EventId id,
+                                const char *const stDate,
+                                const char *const stTime,
+                                const int duration,
+                                const char *const name,
+                                const char *const location);
+
+/*
+ * Remove event.
+ *
+ * Like eventListDelete, but the event is only unlinked from the list,
+ * not destroyed. The caller takes ownership of the event.
+ * Returns TRUE if the event was found, FALSE otherwise.
+ */
+Boolean eventListRemove(struct EventList *list, struct Event *to_remove);
+
+/*
+ * Replace event.
+ *
+ * Puts replacement in the position held by original, without
+ * changing the order of the list. The caller takes ownership of
+ * original, the list takes ownership of replacement. The replacement
+ * takes over the original's id, it's the same event as far as anyone
+ * holding the id is concerned.
+ * Returns TRUE if original was found, FALSE otherwise.
+ */
+Boolean eventListReplace(struct EventList *list, struct Event *original,
+                         struct Event *replacement);
+
+/*
+ * Rename a location, every event in the list at that location is
+ * moved to the new one. If there are already events at the new
+ * location they all end up sharing the same entry.
+ *
+ * Returns FALSE if no events are at the old location, or there was a
+ * memory error. Nothing is changed in that case.
+ */
+Boolean eventListRenameLocation(struct EventList *list,
+                                const char *const old_location,
+                                const char *const new_location);
+
 #endif
@@ -0,0 +1,452 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Events sorted by name, for finding them by the start of it.
+ */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "event_prefix.h"
+
+/*
+ * Forward declarations.
+ */
+static void watchAdded(void *data, struct Event *event);
+static void watchChanged(void *data, struct Event *event);
+static void watchRemoved(void *data, struct Event *event);
+static Boolean setKey(struct EventPrefixEntry *entry, struct Event *event);
+static Boolean keyChanged(const struct EventPrefixEntry *entry,
+                          const struct Event *event);
+static Boolean fitsAt(const struct EventPrefixIndex *index, int position,
+                      const struct Event *event);
+static Boolean insertEvent(struct EventPrefixIndex *index,
+                           struct Event *event);
+static void removeAt(struct EventPrefixIndex *index, int position);
+static int findEvent(const struct EventPrefixIndex *index,
+                     const struct Event *event);
+static int scanEvent(const struct EventPrefixIndex *index,
+                     const struct Event *event);
+static int compareNames(const char *first, const char *second);
+static int compareKey(const struct Event *event,
+                      const struct EventPrefixEntry *entry);
+static int compareEntries(const void *first, const void *second);
+static int comparePrefix(const char *name, const char *prefix);
+static int lowerBound(const struct EventPrefixIndex *index,
+                      const char *prefix, Boolean past_prefix);
+
+struct EventPrefixIndex *eventPrefixCreate(struct EventList *list)
+{
+  struct EventPrefixIndex *index;
+  struct EventListNode *node;
+  Boolean memory_ok;
+  int i;
+
+  index = (struct EventPrefixIndex *)
+          malloc(sizeof(struct EventPrefixIndex));
+
+  if (index != NULL) {
+    index->count = 0;
+    index->capacity = eventListCount(list) + 1;
+    index->entries = (struct EventPrefixEntry *)
+                     malloc(sizeof(struct EventPrefixEntry) *
+                            index->capacity);
+    index->list = list;
+    index->watcher.added = watchAdded;
+    index->watcher.changed = watchChanged;
+    index->watcher.removed = watchRemoved;
+    index->watcher.data = index;
+    index->watcher.next = NULL;
+    index->memory_error = FALSE;
+    memory_ok = (index->entries != NULL);
+
+    for (node = list->head; node != NULL && memory_ok; node = node->next) {
+      index->entries[index->count].name = NULL;
+      memory_ok = setKey(&index->entries[index->count], node->event);
+
+      if (memory_ok) {
+        index->entries[index->count].event = node->event;
+        index->count++;
+      }
+    }
+
+    if (memory_ok) {
+      qsort(index->entries, index->count, sizeof(struct EventPrefixEntry),
+            compareEntries);
+      eventListWatch(list, &index->watcher);
+    } else {
+      for (i = 0; i < index->count; i++) {
+        free(index->entries[i].name);
+      }
+
+      free(index->entries);
+      free(index);
+      index = NULL;
+    }
+  }
+
+  return index;
+}
+
+void eventPrefixDestroy(struct EventPrefixIndex *index)
+{
+  int i;
+
+  if (index != NULL) {
+    eventListUnwatch(index->list, &index->watcher);
+
+    for (i = 0; i < index->count; i++) {
+      free(index->entries[i].name);
+    }
+
+    free(index->entries);
+    free(index);
+  }
+}
+
+Boolean eventPrefixIsCurrent(const struct EventPrefixIndex *index,
+                             const struct EventList *list)
+{
+  return (index != NULL && index->list == list && !index->memory_error);
+}
+
+int eventPrefixFind(const struct EventPrefixIndex *index,
+                    const char *const prefix, struct Event **matches,
+                    int max_matches)
+{
+  int first, past, i;
+
+  first = lowerBound(index, prefix, FALSE);
+  past = lowerBound(index, prefix, TRUE);
+
+  for (i = 0; i < past - first && i < max_matches; i++) {
+    matches[i] = index->entries[first + i].event;
+  }
+
+  return past - first;
+}
+
+static void watchAdded(void *data, struct Event *event)
+{
+  struct EventPrefixIndex *index;
+
+  index = (struct EventPrefixIndex *) data;
+
+  if (!insertEvent(index, event)) {
+    index->memory_error = TRUE;
+  }
+}
+
+/*
+ * Most changes leave the name and start alone, and the entry is found
+ * by them. Otherwise it has to be looked for, as only the entry knows
+ * what they were.
+ */
+static void watchChanged(void *data, struct Event *event)
+{
+  struct EventPrefixIndex *index;
+  int position;
+
+  index = (struct EventPrefixIndex *) data;
+  position = findEvent(index, event);
+
+  if (position < 0) {
+    position = scanEvent(index, event);
+  }
+
+  if (position < 0) {
+    if (!insertEvent(index, event)) {
+      index->memory_error = TRUE;
+    }
+  } else if (keyChanged(&index->entries[position], event)) {
+    if (fitsAt(index, position, event)) {
+      if (!setKey(&index->entries[position], event)) {
+        index->memory_error = TRUE;
+      }
+    } else {
+      removeAt(index, position);
+
+      if (!insertEvent(index, event)) {
+        index->memory_error = TRUE;
+      }
+    }
+  }
+}
+
+static void watchRemoved(void *data, struct Event *event)
+{
+  struct EventPrefixIndex *index;
+  int position;
+
+  index = (struct EventPrefixIndex *) data;
+  position = findEvent(index, event);
+
+  if (position >= 0) {
+    removeAt(index, position);
+  }
+}
+
+/*
+ * Copy the event's name into the entry, freeing the old copy (name
+ * has to be NULL if there isn't one). The entry is left alone if there
+ * was a memory error.
+ */
+static Boolean setKey(struct EventPrefixEntry *entry, struct Event *event)
+{
+  char *name;
+  Boolean result;
+
+  name = (char *) malloc(strlen(event->name) + 1);
+  result = (name != NULL);
+
+  if (result) {
+    strcpy(name, event->name);
+
+    free(entry->name);
+    entry->name = name;
+    entry->timestamp = event->timestamp;
+  }
+
+  return result;
+}
+
+/*
+ * Exactly, not ignoring case, so the copy is kept the same as the name.
+ */
+static Boolean keyChanged(const struct EventPrefixEntry *entry,
+                          const struct Event *event)
+{
+  return (entry->timestamp != event->timestamp ||
+          strcmp(entry->name, event->name) != 0);
+}
+
+/*
+ * TRUE if the event still sorts between the entries either side of
+ * position.
+ */
+static Boolean fitsAt(const struct EventPrefixIndex *index, int position,
+                      const struct Event *event)
+{
+  return ((position == 0 ||
+           compareKey(event, &index->entries[position - 1]) >= 0) &&
+          (position == index->count - 1 ||
+           compareKey(event, &index->entries[position + 1]) <= 0));
+}
+
+/*
+ * After the last event that sorts before or with it, so events added
+ * with the same name and time stay in the order they were added.
+ */
+static Boolean insertEvent(struct EventPrefixIndex *index,
+                           struct Event *event)
+{
+  struct EventPrefixEntry *entries;
+  struct EventPrefixEntry entry;
+  Boolean result;
+  int low, high, middle;
+
+  entry.name = NULL;
+  result = setKey(&entry, event);
+
+  if (result && index->count == index->capacity) {
+    entries = (struct EventPrefixEntry *)
+              realloc(index->entries,
+                      sizeof(struct EventPrefixEntry) * index->capacity * 2);
+    result = (entries != NULL);
+
+    if (result) {
+      index->entries = entries;
+      index->capacity *= 2;
+    } else {
+      free(entry.name);
+    }
+  }
+
+  if (result) {
+    entry.event = event;
+    low = 0;
+    high = index->count;
+
+    while (low < high) {
+      middle = low + (high - low) / 2;
+
+      if (compareKey(event, &index->entries[middle]) >= 0) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+
+    memmove(&index->entries[low + 1], &index->entries[low],
+            sizeof(struct EventPrefixEntry) * (index->count - low));
+    index->entries[low] = entry;
+    index->count++;
+  }
+
+  return result;
+}
+
+static void removeAt(struct EventPrefixIndex *index, int position)
+{
+  free(index->entries[position].name);
+  memmove(&index->entries[position], &index->entries[position + 1],
+          sizeof(struct EventPrefixEntry) * (index->count - position - 1));
+  index->count--;
+}
+
+/*
+ * Binary search by the event's name and start to the first entry
+ * sorted the same, then look through those for this one. Only finds
+ * it if they haven't changed since it was sorted.
+ *
+ * Returns its position, -1 if it isn't there.
+ */
+static int findEvent(const struct EventPrefixIndex *index,
+                     const struct Event *event)
+{
+  int low, high, middle, result;
+
+  low = 0;
+  high = index->count;
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+
+    if (compareKey(event, &index->entries[middle]) > 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  result = -1;
+
+  while (low < index->count && result == -1 &&
+         compareKey(event, &index->entries[low]) == 0) {
+    if (index->entries[low].event == event) {
+      result = low;
+    } else {
+      low++;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Look at every entry, for an event whose name or start has changed.
+ *
+ * Returns its position, -1 if it isn't there.
+ */
+static int scanEvent(const struct EventPrefixIndex *index,
+                     const struct Event *event)
+{
+  int result;
+
+  result = 0;
+
+  while (result < index->count && index->entries[result].event != event) {
+    result++;
+  }
+
+  if (result == index->count) {
+    result = -1;
+  }
+
+  return result;
+}
+
+static int compareNames(const char *first, const char *second)
+{
+  while (*first != '\0' &&
+         tolower((unsigned char) *first) ==
+         tolower((unsigned char) *second)) {
+    first++;
+    second++;
+  }
+
+  return tolower((unsigned char) *first) - tolower((unsigned char) *second);
+}
+
+/*
+ * The event's name and start against what the entry was sorted by.
+ */
+static int compareKey(const struct Event *event,
+                      const struct EventPrefixEntry *entry)
+{
+  int result;
+
+  result = compareNames(event->name, entry->name);
+
+  if (result == 0 && event->timestamp != entry->timestamp) {
+    result = (event->timestamp < entry->timestamp) ? -1 : 1;
+  }
+
+  return result;
+}
+
+/*
+ * For qsort, by name then start time.
+ */
+static int compareEntries(const void *first, const void *second)
+{
+  const struct EventPrefixEntry *first_entry, *second_entry;
+  int result;
+
+  first_entry = (const struct EventPrefixEntry *) first;
+  second_entry = (const struct EventPrefixEntry *) second;
+  result = compareNames(first_entry->name, second_entry->name);
+
+  if (result == 0 && first_entry->timestamp != second_entry->timestamp) {
+    result = (first_entry->timestamp < second_entry->timestamp) ? -1 : 1;
+  }
+
+  return result;
+}
+
+/*
+ * Compares just the start of the name, as long as the prefix, so 0
+ * means the name starts with it.
+ */
+static int comparePrefix(const char *name, const char *prefix)
+{
+  while (*prefix != '\0' &&
+         tolower((unsigned char) *name) ==
+         tolower((unsigned char) *prefix)) {
+    name++;
+    prefix++;
+  }
+
+  return (*prefix == '\0') ? 0 :
+         tolower((unsigned char) *name) - tolower((unsigned char) *prefix);
+}
+
+/*
+ * Position of the first event whose name doesn't sort before the
+ * prefix, or with past_prefix, the first after all those starting with
+ * it.
+ */
+static int lowerBound(const struct EventPrefixIndex *index,
+                      const char *prefix, Boolean past_prefix)
+{
+  int low, high, middle, compared;
+
+  low = 0;
+  high = index->count;
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+    compared = comparePrefix(index->entries[middle].name, prefix);
+
+    if (compared < 0 || (past_prefix && compared == 0)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
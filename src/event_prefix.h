@@ -0,0 +1,96 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Finding events by the start of their name, fast enough to do on
+ * every key the user presses.
+ *
+ * The index is the list's events sorted by name (ignoring case), then
+ * start time, so the events whose names start with something are all
+ * together, and a binary search for each end finds them.
+ *
+ * Like an EventTextIndex it watches its list to keep itself up to
+ * date. An added event is put in its place with a binary search. Each
+ * entry keeps a copy of the name and start it was sorted by, so a
+ * changed event whose name and start are the same (a new location or
+ * duration, or a renamed location) is found with a binary search and
+ * left where it is. One that still sorts between its neighbours just
+ * has its copy updated, and anything else is taken out and put back,
+ * moving the entries between along one. That's a memmove, quick even
+ * for big lists, and much quicker than sorting again.
+ */
+
+#ifndef EVENT_PREFIX_H_
+#define EVENT_PREFIX_H_
+
+#include "bool.h"
+#include "event.h"
+#include "event_list.h"
+
+/*
+ * An event in the index.
+ *
+ * event - The event.
+ * name/timestamp - What it was sorted by, its own copy of the name.
+ */
+struct EventPrefixEntry {
+  struct Event *event;
+  char *name;
+  Timestamp timestamp;
+};
+
+/*
+ * The index.
+ *
+ * entries - The events, in order.
+ * count - Number of events.
+ * capacity - Size of entries.
+ * list - The list being watched.
+ * watcher - How the list tells the index about changes.
+ * memory_error - TRUE if a change couldn't be made, the index is no
+ *                good after that.
+ */
+struct EventPrefixIndex {
+  struct EventPrefixEntry *entries;
+  int count;
+  int capacity;
+  struct EventList *list;
+  struct EventListWatcher watcher;
+  Boolean memory_error;
+};
+
+/*
+ * Sort the events in the list, and watch it for changes.
+ *
+ * Returns NULL if there was a memory error.
+ */
+struct EventPrefixIndex *eventPrefixCreate(struct EventList *list);
+
+/*
+ * Stop watching the list and free the index, the events are left
+ * alone. Has to be done before the list is destroyed.
+ */
+void eventPrefixDestroy(struct EventPrefixIndex *index);
+
+/*
+ * Returns TRUE if the index is watching this list and has kept up with
+ * it. NULL indexes are never current.
+ */
+Boolean eventPrefixIsCurrent(const struct EventPrefixIndex *index,
+                             const struct EventList *list);
+
+/*
+ * Find the events with names starting with prefix, ignoring case.
+ *
+ * matches - Filled with the first max_matches of them, by name then
+ *           start time.
+ *
+ * Returns the number of events with the prefix, which can be more
+ * than max_matches.
+ */
+int eventPrefixFind(const struct EventPrefixIndex *index,
+                    const char *const prefix, struct Event **matches,
+                    int max_matches);
+
+#endif
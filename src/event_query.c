@@ -0,0 +1,248 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Query planning and running.
+ */
+
+#include <string.h>
+
+#include "event_query.h"
+
+/*
+ * Forward declarations.
+ */
+static Boolean stringMatches(const char *const value,
+                             const char *const wanted, Boolean prefix);
+static void considerRange(struct EventQueryIterator *iterator,
+                          enum EventQueryPlan plan, struct Event **events,
+                          int first, int count);
+static Boolean columnsMatch(const struct EventQueryIterator *iterator,
+                            int position);
+
+/*
+ * Filters that only need the start and duration of an event.
+ */
+#define QUERY_TIME_FILTERS \
+  (QUERY_START_RANGE | QUERY_TIME_OF_DAY | QUERY_DURATION)
+
+void eventQueryInit(struct EventQuery *query)
+{
+  query->filters = 0;
+  query->start_from = 0;
+  query->start_before = 0;
+  query->time_from = 0;
+  query->time_to = 0;
+  query->min_duration = 0;
+  query->max_duration = 0;
+  query->location = NULL;
+  query->name = NULL;
+}
+
+/*
+ * Cheapest checks first, the string ones last.
+ */
+Boolean eventQueryMatches(const struct EventQuery *const query,
+                          const struct Event *const event)
+{
+  Boolean result;
+
+  result = TRUE;
+
+  if (query->filters & QUERY_START_RANGE) {
+    result = (event->timestamp >= query->start_from &&
+              event->timestamp < query->start_before);
+  }
+
+  if (result && (query->filters & QUERY_TIME_OF_DAY)) {
+    result = (eventStartMinute(event) >= query->time_from &&
+              eventStartMinute(event) < query->time_to);
+  }
+
+  if (result && (query->filters & QUERY_DURATION)) {
+    result = (event->duration >= query->min_duration &&
+              event->duration <= query->max_duration);
+  }
+
+  if (result && (query->filters & (QUERY_LOCATION | QUERY_LOCATION_PREFIX))) {
+    result = (event->location != NULL &&
+              stringMatches(eventLocation(event), query->location,
+                            (query->filters & QUERY_LOCATION_PREFIX) != 0));
+  }
+
+  if (result && (query->filters & QUERY_NAME_EQUALS)) {
+    result = (strcmp(event->name, query->name) == 0);
+  }
+
+  if (result && (query->filters & QUERY_NAME_CONTAINS)) {
+    result = (strstr(event->name, query->name) != NULL);
+  }
+
+  return result;
+}
+
+/*
+ * Start with a scan of the whole list, then see if any index range
+ * would mean looking at fewer events.
+ */
+void eventQueryBegin(struct EventQueryIterator *iterator,
+                     const struct EventQuery *const query,
+                     struct EventList *list,
+                     const struct EventIndex *index)
+{
+  int first, count, last;
+
+  iterator->query = *query;
+  iterator->plan = QUERY_PLAN_SCAN;
+  iterator->next_node = list->head;
+  iterator->candidates = NULL;
+  iterator->candidate_count = 0;
+  iterator->starts = NULL;
+  iterator->durations = NULL;
+  iterator->start_minutes = NULL;
+  iterator->position = 0;
+
+  if (eventIndexIsCurrent(index, list)) {
+    /* Scanning is only as good as an index range with everything. */
+    iterator->candidate_count = index->count;
+
+    if (query->filters & QUERY_TIME_FILTERS) {
+      considerRange(iterator, QUERY_PLAN_START_INDEX, index->by_start, 0,
+                    index->count);
+    }
+
+    if (query->filters & QUERY_START_RANGE) {
+      first = eventIndexSeekStart(index, query->start_from);
+      last = eventIndexSeekStart(index, query->start_before);
+
+      if (last < first) {
+        last = first;
+      }
+
+      considerRange(iterator, QUERY_PLAN_START_INDEX, index->by_start,
+                    first, last - first);
+    }
+
+    if (query->filters & QUERY_NAME_EQUALS) {
+      count = eventIndexNameRange(index, query->name, FALSE, &first);
+      considerRange(iterator, QUERY_PLAN_NAME_INDEX, index->by_name, first,
+                    count);
+    }
+
+    if (query->filters & (QUERY_LOCATION | QUERY_LOCATION_PREFIX)) {
+      count = eventIndexLocationRange(
+                index, query->location,
+                (query->filters & QUERY_LOCATION_PREFIX) != 0, &first);
+      considerRange(iterator, QUERY_PLAN_LOCATION_INDEX, index->by_location,
+                    first, count);
+    }
+
+    if (iterator->plan == QUERY_PLAN_START_INDEX) {
+      first = (int) (iterator->candidates - index->by_start);
+      iterator->starts = index->starts + first;
+      iterator->durations = index->durations + first;
+      iterator->start_minutes = index->start_minutes + first;
+    }
+  }
+}
+
+struct Event *eventQueryNext(struct EventQueryIterator *iterator)
+{
+  struct Event *result;
+  struct Event *candidate;
+
+  result = NULL;
+
+  if (iterator->plan == QUERY_PLAN_SCAN) {
+    while (result == NULL && iterator->next_node != NULL) {
+      candidate = iterator->next_node->event;
+      iterator->next_node = iterator->next_node->next;
+
+      if (eventQueryMatches(&iterator->query, candidate)) {
+        result = candidate;
+      }
+    }
+  } else {
+    while (result == NULL &&
+           iterator->position < iterator->candidate_count) {
+      if (iterator->starts == NULL ||
+          columnsMatch(iterator, iterator->position)) {
+        candidate = iterator->candidates[iterator->position];
+
+        if (eventQueryMatches(&iterator->query, candidate)) {
+          result = candidate;
+        }
+      }
+
+      iterator->position++;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Exact or prefix string match.
+ */
+static Boolean stringMatches(const char *const value,
+                             const char *const wanted, Boolean prefix)
+{
+  Boolean result;
+
+  if (prefix) {
+    result = (strncmp(value, wanted, strlen(wanted)) == 0);
+  } else {
+    result = (strcmp(value, wanted) == 0);
+  }
+
+  return result;
+}
+
+/*
+ * Switch the plan to this index range if it has fewer events than
+ * the best plan so far.
+ */
+static void considerRange(struct EventQueryIterator *iterator,
+                          enum EventQueryPlan plan, struct Event **events,
+                          int first, int count)
+{
+  if (count < iterator->candidate_count ||
+      (iterator->plan == QUERY_PLAN_SCAN &&
+       count == iterator->candidate_count)) {
+    iterator->plan = plan;
+    iterator->candidates = events + first;
+    iterator->candidate_count = count;
+    iterator->position = 0;
+  }
+}
+
+/*
+ * The time filters, checked on the index columns.
+ */
+static Boolean columnsMatch(const struct EventQueryIterator *iterator,
+                            int position)
+{
+  const struct EventQuery *query;
+  Boolean result;
+
+  query = &iterator->query;
+  result = TRUE;
+
+  if (query->filters & QUERY_START_RANGE) {
+    result = (iterator->starts[position] >= query->start_from &&
+              iterator->starts[position] < query->start_before);
+  }
+
+  if (result && (query->filters & QUERY_TIME_OF_DAY)) {
+    result = (iterator->start_minutes[position] >= query->time_from &&
+              iterator->start_minutes[position] < query->time_to);
+  }
+
+  if (result && (query->filters & QUERY_DURATION)) {
+    result = (iterator->durations[position] >= query->min_duration &&
+              iterator->durations[position] <= query->max_duration);
+  }
+
+  return result;
+}
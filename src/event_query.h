@@ -0,0 +1,154 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Searching the event list with a set of filters.
+ *
+ * A query is a set of filters that all have to match. When a query
+ * is started it is turned into a plan: if there's a current
+ * EventIndex, the index range with the fewest events that could
+ * match is used, otherwise it goes through the whole list. Either
+ * way, every filter is checked on each event before it is returned.
+ *
+ * Queries on the times go through the index's start order even if
+ * they can't narrow it down, since the index has the times in their
+ * own arrays and most events can be ruled out without reading them.
+ *
+ * Usage:
+ *
+ *   eventQueryInit(&query);
+ *   query.filters = QUERY_LOCATION | QUERY_DURATION;
+ *   query.location = "The Labs";
+ *   query.min_duration = 30;
+ *   query.max_duration = 120;
+ *
+ *   eventQueryBegin(&iterator, &query, list, index);
+ *   while ((event = eventQueryNext(&iterator)) != NULL) {
+ *     ...
+ *   }
+ */
+
+#ifndef EVENT_QUERY_H_
+#define EVENT_QUERY_H_
+
+#include "date_time.h"
+#include "event.h"
+#include "event_index.h"
+#include "event_list.h"
+
+/*
+ * Filters, these are or'd together in the filters field of the
+ * query. The fields they use are listed with each.
+ *
+ * QUERY_START_RANGE - Starts at or after start_from, and before
+ *                     start_before.
+ * QUERY_TIME_OF_DAY - Starts at or after time_from minutes into the
+ *                     day, and before time_to minutes into the day.
+ * QUERY_DURATION - Duration is from min_duration to max_duration,
+ *                  inclusive.
+ * QUERY_LOCATION - Location is exactly location.
+ * QUERY_LOCATION_PREFIX - Location starts with location. Use this or
+ *                         QUERY_LOCATION, not both.
+ * QUERY_NAME_EQUALS - Name is exactly name.
+ * QUERY_NAME_CONTAINS - Name has name in it somewhere. Use this or
+ *                       QUERY_NAME_EQUALS, not both.
+ */
+#define QUERY_START_RANGE 0x01
+#define QUERY_TIME_OF_DAY 0x02
+#define QUERY_DURATION 0x04
+#define QUERY_LOCATION 0x08
+#define QUERY_LOCATION_PREFIX 0x10
+#define QUERY_NAME_EQUALS 0x20
+#define QUERY_NAME_CONTAINS 0x40
+
+/*
+ * The query, only the fields for the filters that are set are used.
+ * The strings are not copied, they have to stay around until the
+ * query is done.
+ */
+struct EventQuery {
+  unsigned int filters;
+  Timestamp start_from;
+  Timestamp start_before;
+  int time_from;
+  int time_to;
+  int min_duration;
+  int max_duration;
+  const char *location;
+  const char *name;
+};
+
+/*
+ * How the query is going to find its events.
+ */
+enum EventQueryPlan {
+  QUERY_PLAN_SCAN,
+  QUERY_PLAN_START_INDEX,
+  QUERY_PLAN_NAME_INDEX,
+  QUERY_PLAN_LOCATION_INDEX
+};
+
+/*
+ * A running query.
+ *
+ * The events come back in list order for a scan, and in the order
+ * of the index used otherwise.
+ *
+ * query - Copy of the query being run.
+ * plan - How the events are being found.
+ * next_node - For scans, the next node to look at.
+ * candidates - For index plans, the range of the index that could
+ *              match.
+ * candidate_count - Number of events in candidates.
+ * starts/durations/start_minutes - For the start index plan, the
+ *                                  index columns for the candidates,
+ *                                  so the time filters can be checked
+ *                                  without looking at the events.
+ * position - Next candidate to look at.
+ */
+struct EventQueryIterator {
+  struct EventQuery query;
+  enum EventQueryPlan plan;
+  struct EventListNode *next_node;
+  struct Event **candidates;
+  int candidate_count;
+  const Timestamp *starts;
+  const int *durations;
+  const short *start_minutes;
+  int position;
+};
+
+/*
+ * Set up an empty query, one with no filters matches everything.
+ */
+void eventQueryInit(struct EventQuery *query);
+
+/*
+ * Returns TRUE if the event passes all the filters of the query.
+ */
+Boolean eventQueryMatches(const struct EventQuery *const query,
+                          const struct Event *const event);
+
+/*
+ * Plan the query and get ready to return the results.
+ *
+ * The list must not be changed until the query is done.
+ *
+ * iterator - Iterator to set up.
+ * query - Query to run, it's copied so it can be changed after.
+ * list - List to search.
+ * index - Index of the list to use, it's ignored if it's NULL or not
+ *         current.
+ */
+void eventQueryBegin(struct EventQueryIterator *iterator,
+                     const struct EventQuery *const query,
+                     struct EventList *list,
+                     const struct EventIndex *index);
+
+/*
+ * Returns the next matching event, NULL when there are no more.
+ */
+struct Event *eventQueryNext(struct EventQueryIterator *iterator);
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Sweep line free/busy calculations.
+ */
+
+#include <stdlib.h>
+
+#include "event_schedule.h"
+
+/*
+ * Starting size of an intervals array, doubles when full.
+ */
+#define INTERVALS_CHUNK 16
+
+/*
+ * Forward declarations.
+ */
+static Boolean addInterval(struct ScheduleIntervals *intervals,
+                           Timestamp start, Timestamp end);
+static Boolean addEvent(struct ScheduleIntervals *busy, Timestamp start,
+                        int duration, Timestamp window_start,
+                        Timestamp window_end);
+static int compareIntervals(const void *first, const void *second);
+static void mergeIntervals(struct ScheduleIntervals *intervals);
+
+void scheduleIntervalsInit(struct ScheduleIntervals *intervals)
+{
+  intervals->intervals = NULL;
+  intervals->count = 0;
+  intervals->size = 0;
+}
+
+void scheduleIntervalsFree(struct ScheduleIntervals *intervals)
+{
+  free(intervals->intervals);
+  scheduleIntervalsInit(intervals);
+}
+
+/*
+ * Collect the part of each event in the window, get them in order
+ * and merge them.
+ */
+Boolean scheduleBusy(struct EventList *list, const struct EventIndex *index,
+                     Timestamp window_start, Timestamp window_end,
+                     struct ScheduleIntervals *busy)
+{
+  struct EventListNode *current_node;
+  Boolean result;
+  int i;
+
+  result = TRUE;
+  busy->count = 0;
+
+  if (eventIndexIsCurrent(index, list)) {
+    /*
+     * Nothing can last longer than max_duration, so nothing starting
+     * before that can reach the window. Already in order of start.
+     */
+    for (i = eventIndexSeekStart(index, window_start - index->max_duration);
+         result && i < index->count &&
+         index->starts[i] < window_end; i++) {
+      result = addEvent(busy, index->starts[i], index->durations[i],
+                        window_start, window_end);
+    }
+  } else {
+    for (current_node = list->head; result && current_node != NULL;
+         current_node = current_node->next) {
+      result = addEvent(busy, current_node->event->timestamp,
+                        current_node->event->duration, window_start,
+                        window_end);
+    }
+
+    if (result) {
+      qsort(busy->intervals, busy->count, sizeof(struct ScheduleInterval),
+            compareIntervals);
+    }
+  }
+
+  if (result) {
+    mergeIntervals(busy);
+  } else {
+    scheduleIntervalsFree(busy);
+  }
+
+  return result;
+}
+
+/*
+ * Walk through the busy times, anything between them long enough is
+ * a free slot.
+ */
+Boolean scheduleFreeSlots(struct EventList *list,
+                          const struct EventIndex *index,
+                          Timestamp window_start, Timestamp window_end,
+                          int length, int max_slots,
+                          struct ScheduleIntervals *free_slots)
+{
+  struct ScheduleIntervals busy;
+  Timestamp free_from;
+  Boolean result;
+  int i;
+
+  scheduleIntervalsInit(&busy);
+  free_slots->count = 0;
+
+  result = scheduleBusy(list, index, window_start, window_end, &busy);
+  free_from = window_start;
+
+  for (i = 0; result && i < busy.count && free_slots->count < max_slots;
+       i++) {
+    if (busy.intervals[i].start - free_from >= length) {
+      result = addInterval(free_slots, free_from, busy.intervals[i].start);
+    }
+
+    free_from = busy.intervals[i].end;
+  }
+
+  if (result && free_slots->count < max_slots &&
+      window_end - free_from >= length) {
+    result = addInterval(free_slots, free_from, window_end);
+  }
+
+  if (!result) {
+    scheduleIntervalsFree(free_slots);
+  }
+
+  scheduleIntervalsFree(&busy);
+
+  return result;
+}
+
+/*
+ * Add to the end of the array, making it bigger if needed.
+ */
+static Boolean addInterval(struct ScheduleIntervals *intervals,
+                           Timestamp start, Timestamp end)
+{
+  struct ScheduleInterval *new_intervals;
+  Boolean result;
+  int new_size;
+
+  result = TRUE;
+
+  if (intervals->count == intervals->size) {
+    if (intervals->size == 0) {
+      new_size = INTERVALS_CHUNK;
+    } else {
+      new_size = intervals->size * 2;
+    }
+
+    new_intervals = (struct ScheduleInterval *)
+                    realloc(intervals->intervals,
+                            sizeof(struct ScheduleInterval) * new_size);
+
+    if (new_intervals != NULL) {
+      intervals->intervals = new_intervals;
+      intervals->size = new_size;
+    } else {
+      result = FALSE;
+    }
+  }
+
+  if (result) {
+    intervals->intervals[intervals->count].start = start;
+    intervals->intervals[intervals->count].end = end;
+    intervals->count++;
+  }
+
+  return result;
+}
+
+/*
+ * Add the part of an event inside the window, if there is any.
+ */
+static Boolean addEvent(struct ScheduleIntervals *busy, Timestamp start,
+                        int duration, Timestamp window_start,
+                        Timestamp window_end)
+{
+  Timestamp end;
+  Boolean result;
+
+  result = TRUE;
+
+  end = start + duration;
+
+  if (start < window_start) {
+    start = window_start;
+  }
+
+  if (end > window_end) {
+    end = window_end;
+  }
+
+  if (start < end) {
+    result = addInterval(busy, start, end);
+  }
+
+  return result;
+}
+
+static int compareIntervals(const void *first, const void *second)
+{
+  const struct ScheduleInterval *first_interval, *second_interval;
+  int result;
+
+  first_interval = (const struct ScheduleInterval *) first;
+  second_interval = (const struct ScheduleInterval *) second;
+
+  if (first_interval->start < second_interval->start) {
+    result = -1;
+  } else if (first_interval->start > second_interval->start) {
+    result = 1;
+  } else {
+    result = 0;
+  }
+
+  return result;
+}
+
+/*
+ * The sweep, intervals must be in order of start. Anything starting
+ * before the current merged interval ends is joined onto it.
+ */
+static void mergeIntervals(struct ScheduleIntervals *intervals)
+{
+  int merged, i;
+
+  merged = 0;
+
+  for (i = 1; i < intervals->count; i++) {
+    if (intervals->intervals[i].start <= intervals->intervals[merged].end) {
+      if (intervals->intervals[i].end > intervals->intervals[merged].end) {
+        intervals->intervals[merged].end = intervals->intervals[i].end;
+      }
+    } else {
+      merged++;
+      intervals->intervals[merged] = intervals->intervals[i];
+    }
+  }
+
+  if (intervals->count > 0) {
+    intervals->count = merged + 1;
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Free/busy times of the calendar.
+ *
+ * Busy times are worked out by sweeping the events in order of their
+ * start, merging any that overlap or touch into one interval. With a
+ * current EventIndex the events are already in order and only those
+ * that can reach the window are looked at, otherwise every event in
+ * the list is checked and the ones in the window are sorted.
+ *
+ * Times are Timestamps, so intervals can cross midnight. Every
+ * interval includes its start and not its end, so an event at 09:00
+ * for 30 minutes is busy from 09:00 up to 09:30, and something else
+ * can start at 09:30.
+ */
+
+#ifndef EVENT_SCHEDULE_H_
+#define EVENT_SCHEDULE_H_
+
+#include "bool.h"
+#include "date_time.h"
+#include "event_index.h"
+#include "event_list.h"
+
+/*
+ * A period of time, from start up to end.
+ */
+struct ScheduleInterval {
+  Timestamp start;
+  Timestamp end;
+};
+
+/*
+ * A growable array of intervals, in order of start, none
+ * overlapping.
+ *
+ * intervals - The intervals.
+ * count - Number of intervals.
+ * size - Space allocated in intervals.
+ */
+struct ScheduleIntervals {
+  struct ScheduleInterval *intervals;
+  int count;
+  int size;
+};
+
+/*
+ * Set up an empty array of intervals.
+ */
+void scheduleIntervalsInit(struct ScheduleIntervals *intervals);
+
+/*
+ * Free the array of intervals, it is left empty so can be used again.
+ */
+void scheduleIntervalsFree(struct ScheduleIntervals *intervals);
+
+/*
+ * Work out when the calendar is busy during a window.
+ *
+ * Events with no duration don't make the calendar busy. Busy times
+ * are cut off at the edges of the window.
+ *
+ * list - Events to look at.
+ * index - Index of the list to use, ignored if NULL or not current.
+ * window_start - Start of the time to look at.
+ * window_end - End of the time to look at.
+ * busy - Updated with the busy intervals, anything already in it is
+ *        replaced.
+ *
+ * Returns FALSE if there was a memory error, busy is empty in that
+ * case.
+ */
+Boolean scheduleBusy(struct EventList *list, const struct EventIndex *index,
+                     Timestamp window_start, Timestamp window_end,
+                     struct ScheduleIntervals *busy);
+
+/*
+ * Find free time during a window.
+ *
+ * Each free slot found is a whole gap between busy times that is at
+ * least length minutes long, in order, so anything length minutes long
+ * can start at the start of any of them.
+ *
+ * list/index/window_start/window_end - Same as scheduleBusy.
+ * length - Minutes of free time needed.
+ * max_slots - Stop after finding this many.
+ * free_slots - Updated with the free slots, anything already in it is
+ *              replaced.
+ *
+ * Returns FALSE if there was a memory error, free_slots is empty in
+ * that case.
+ */
+Boolean scheduleFreeSlots(struct EventList *list,
+                          const struct EventIndex *index,
+                          Timestamp window_start, Timestamp window_end,
+                          int length, int max_slots,
+                          struct ScheduleIntervals *free_slots);
+
+#endif
@@ -0,0 +1,417 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Working out the calendar totals.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bool.h"
+#include "event_stats.h"
+#include "hash.h"
+
+/*
+ * Starting number of entries in a range, it at least doubles every
+ * time it has to grow.
+ */
+#define STATS_RANGE_CHUNK 32
+
+/*
+ * Starting number of chains in the locations hash table, it doubles
+ * when hashTableFull says so.
+ */
+#define STATS_LOCATION_BUCKETS 16
+
+/*
+ * Forward declarations.
+ */
+static Boolean addEvent(struct EventStats *stats,
+                        const struct Event *const event);
+static Boolean rangeAdd(struct StatsRange *range, long key, long minutes);
+static long rangeGet(const struct StatsRange *range, long key);
+static long monthKey(int year, int month);
+static struct StatsLocation *findLocation(const struct EventStats *stats,
+                                          const char *const location);
+static Boolean locationAdd(struct EventStats *stats,
+                           const struct LocationEntry *entry, long minutes);
+static Boolean nameLocations(struct EventStats *stats);
+static Boolean growLocations(struct EventStats *stats);
+
+struct EventStats *eventStatsCreate(struct EventList *list)
+{
+  struct EventStats *stats;
+  struct EventListNode *current_node;
+  Boolean result;
+
+  stats = (struct EventStats *) malloc(sizeof(struct EventStats));
+
+  if (stats != NULL) {
+    stats->days.first = 0;
+    stats->days.count = 0;
+    stats->days.minutes = NULL;
+    stats->weeks = stats->days;
+    stats->months = stats->days;
+    stats->location_buckets = STATS_LOCATION_BUCKETS;
+    stats->location_count = 0;
+    stats->total_minutes = 0;
+    stats->locations = (struct StatsLocation **)
+                       calloc(STATS_LOCATION_BUCKETS,
+                              sizeof(struct StatsLocation *));
+
+    result = (stats->locations != NULL);
+
+    for (current_node = list->head; result && current_node != NULL;
+         current_node = current_node->next) {
+      result = addEvent(stats, current_node->event);
+    }
+
+    if (result) {
+      result = nameLocations(stats);
+    }
+
+    if (!result) {
+      eventStatsDestroy(stats);
+      stats = NULL;
+    }
+  }
+
+  return stats;
+}
+
+void eventStatsDestroy(struct EventStats *stats)
+{
+  struct StatsLocation *current_location, *next_location;
+  int i;
+
+  if (stats != NULL) {
+    if (stats->locations != NULL) {
+      for (i = 0; i < stats->location_buckets; i++) {
+        current_location = stats->locations[i];
+
+        while (current_location != NULL) {
+          next_location = current_location->next;
+          free(current_location->location);
+          free(current_location);
+          current_location = next_location;
+        }
+      }
+    }
+
+    free(stats->locations);
+    free(stats->days.minutes);
+    free(stats->weeks.minutes);
+    free(stats->months.minutes);
+    free(stats);
+  }
+}
+
+long eventStatsDayMinutes(const struct EventStats *stats,
+                          const struct Date *const date)
+{
+  return rangeGet(&stats->days, dateToDays(date));
+}
+
+long eventStatsWeekMinutes(const struct EventStats *stats,
+                           const struct Date *const date)
+{
+  return rangeGet(&stats->weeks, dateToDays(date) / STATS_DAYS_IN_WEEK);
+}
+
+long eventStatsMonthMinutes(const struct EventStats *stats, int year,
+                            int month)
+{
+  return rangeGet(&stats->months, monthKey(year, month));
+}
+
+long eventStatsLocationMinutes(const struct EventStats *stats,
+                               const char *const location)
+{
+  struct StatsLocation *found;
+  long result;
+
+  result = 0;
+  found = findLocation(stats, location);
+
+  if (found != NULL) {
+    result = found->minutes;
+  }
+
+  return result;
+}
+
+/*
+ * Walk through the event a day at a time, so the part on each day is
+ * added to that day, and its week and month.
+ */
+static Boolean addEvent(struct EventStats *stats,
+                        const struct Event *const event)
+{
+  struct Date date;
+  Timestamp current, end, midnight;
+  long day, minutes;
+  Boolean result;
+
+  result = TRUE;
+  current = event->timestamp;
+  end = eventEndTimestamp(event);
+
+  while (result && current < end) {
+    day = (long) (current / MINUTES_IN_DAY);
+    midnight = (Timestamp) (day + 1) * MINUTES_IN_DAY;
+
+    if (end < midnight) {
+      minutes = (long) (end - current);
+    } else {
+      minutes = (long) (midnight - current);
+    }
+
+    dateFromDays(day, &date);
+
+    result = (rangeAdd(&stats->days, day, minutes) &&
+              rangeAdd(&stats->weeks, day / STATS_DAYS_IN_WEEK, minutes) &&
+              rangeAdd(&stats->months, monthKey(date.year, date.month),
+                       minutes));
+
+    current = midnight;
+  }
+
+  if (result) {
+    stats->total_minutes += event->duration;
+
+    if (event->location != NULL && event->duration > 0) {
+      result = locationAdd(stats, event->location, event->duration);
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Add to the entry for the key, growing the range to cover it if
+ * needed. The range grows by at least its own size, towards the key,
+ * so adding keys in any order only copies each entry a few times.
+ */
+static Boolean rangeAdd(struct StatsRange *range, long key, long minutes)
+{
+  long *new_minutes;
+  long new_first, grow;
+  int new_count;
+  Boolean result;
+
+  result = TRUE;
+
+  if (range->count == 0 || key < range->first ||
+      key >= range->first + range->count) {
+    if (range->count == 0) {
+      new_first = key;
+      new_count = STATS_RANGE_CHUNK;
+    } else if (key < range->first) {
+      grow = range->first - key;
+
+      if (grow < range->count) {
+        grow = range->count;
+      }
+
+      /* Keys are never negative, so there's no point going below 0. */
+      new_first = range->first - grow;
+
+      if (new_first < 0) {
+        new_first = 0;
+      }
+
+      new_count = (int) (range->first - new_first) + range->count;
+    } else {
+      grow = key - (range->first + range->count) + 1;
+
+      if (grow < range->count) {
+        grow = range->count;
+      }
+
+      new_first = range->first;
+      new_count = range->count + (int) grow;
+    }
+
+    new_minutes = (long *) calloc(new_count, sizeof(long));
+
+    if (new_minutes != NULL) {
+      if (range->count > 0) {
+        memcpy(new_minutes + (range->first - new_first), range->minutes,
+               sizeof(long) * range->count);
+      }
+
+      free(range->minutes);
+      range->minutes = new_minutes;
+      range->first = new_first;
+      range->count = new_count;
+    } else {
+      result = FALSE;
+    }
+  }
+
+  if (result) {
+    range->minutes[key - range->first] += minutes;
+  }
+
+  return result;
+}
+
+static long rangeGet(const struct StatsRange *range, long key)
+{
+  long result;
+
+  result = 0;
+
+  if (key >= range->first && key < range->first + range->count) {
+    result = range->minutes[key - range->first];
+  }
+
+  return result;
+}
+
+static long monthKey(int year, int month)
+{
+  return (long) year * STATS_MONTHS_IN_YEAR + month - 1;
+}
+
+/*
+ * Only for once the locations have their names.
+ */
+static struct StatsLocation *findLocation(const struct EventStats *stats,
+                                          const char *const location)
+{
+  struct StatsLocation *current_location;
+  unsigned long hash;
+
+  hash = hashString(location, strlen(location));
+  current_location = stats->locations[hash % stats->location_buckets];
+
+  while (current_location != NULL &&
+         (current_location->hash != hash ||
+          strcmp(current_location->location, location) != 0)) {
+    current_location = current_location->next;
+  }
+
+  return current_location;
+}
+
+/*
+ * Add to the entry's total, adding the location if it's new. The
+ * entry's own hash is used, so the name isn't looked at.
+ */
+static Boolean locationAdd(struct EventStats *stats,
+                           const struct LocationEntry *entry, long minutes)
+{
+  struct StatsLocation *found;
+  unsigned long bucket;
+  Boolean result;
+
+  result = TRUE;
+  found = stats->locations[entry->hash % stats->location_buckets];
+
+  while (found != NULL && found->entry != entry) {
+    found = found->next;
+  }
+
+  if (found == NULL) {
+    if (hashTableFull(stats->location_count, stats->location_buckets)) {
+      result = growLocations(stats);
+    }
+
+    if (result) {
+      found = (struct StatsLocation *) malloc(sizeof(struct StatsLocation));
+
+      if (found != NULL) {
+        found->entry = entry;
+        found->location = NULL;
+        found->hash = entry->hash;
+        found->minutes = 0;
+
+        bucket = found->hash % stats->location_buckets;
+        found->next = stats->locations[bucket];
+        stats->locations[bucket] = found;
+        stats->location_count++;
+      } else {
+        result = FALSE;
+      }
+    }
+  }
+
+  if (result) {
+    found->minutes += minutes;
+  }
+
+  return result;
+}
+
+/*
+ * Copy each location's name from its entry, and let go of the entry.
+ */
+static Boolean nameLocations(struct EventStats *stats)
+{
+  struct StatsLocation *current_location;
+  Boolean result;
+  int i;
+
+  result = TRUE;
+
+  for (i = 0; i < stats->location_buckets && result; i++) {
+    for (current_location = stats->locations[i];
+         current_location != NULL && result;
+         current_location = current_location->next) {
+      current_location->location =
+        (char *) malloc(strlen(current_location->entry->name) + 1);
+
+      if (current_location->location != NULL) {
+        strcpy(current_location->location, current_location->entry->name);
+        current_location->entry = NULL;
+      } else {
+        result = FALSE;
+      }
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Double the number of chains, moving every location to its new
+ * chain.
+ */
+static Boolean growLocations(struct EventStats *stats)
+{
+  struct StatsLocation **new_locations;
+  struct StatsLocation *current_location, *next_location;
+  unsigned long bucket;
+  int new_buckets, i;
+  Boolean result;
+
+  result = TRUE;
+  new_buckets = stats->location_buckets * 2;
+  new_locations = (struct StatsLocation **)
+                  calloc(new_buckets, sizeof(struct StatsLocation *));
+
+  if (new_locations != NULL) {
+    for (i = 0; i < stats->location_buckets; i++) {
+      current_location = stats->locations[i];
+
+      while (current_location != NULL) {
+        next_location = current_location->next;
+        bucket = current_location->hash % new_buckets;
+        current_location->next = new_locations[bucket];
+        new_locations[bucket] = current_location;
+        current_location = next_location;
+      }
+    }
+
+    free(stats->locations);
+    stats->locations = new_locations;
+    stats->location_buckets = new_buckets;
+  } else {
+    result = FALSE;
+  }
+
+  return result;
+}
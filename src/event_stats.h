@@ -0,0 +1,125 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Totals of the time booked in the calendar.
+ *
+ * All the totals are worked out in one go through the list. Events
+ * that run past midnight have each part counted on the day (and week
+ * and month) it is on. Locations get the whole duration of their
+ * events. Events in a list share one entry per location, so the
+ * totals are added up by entry and the names are only copied once
+ * every event has been counted.
+ *
+ * The day, week and month totals are kept in arrays with an entry for
+ * every day/week/month from the first one with something in it to the
+ * last, so looking one up is just indexing. Locations are kept in a
+ * hash table.
+ */
+
+#ifndef EVENT_STATS_H_
+#define EVENT_STATS_H_
+
+#include "date_time.h"
+#include "event_list.h"
+
+/*
+ * Used to make the week and month keys.
+ */
+#define STATS_DAYS_IN_WEEK 7
+#define STATS_MONTHS_IN_YEAR 12
+
+/*
+ * Minutes booked for a run of days, weeks or months.
+ *
+ * first - Key of the first entry in minutes, what the keys are
+ *         depends on what's being counted (see EventStats).
+ * count - Number of entries in minutes.
+ * minutes - Minutes booked for each key, 0 for keys with nothing
+ *           booked.
+ */
+struct StatsRange {
+  long first;
+  int count;
+  long *minutes;
+};
+
+/*
+ * Minutes booked at a location, an entry in the hash table.
+ *
+ * entry - The list's entry for the location, only used while the
+ *         totals are being worked out and NULL after.
+ * location - Copy of the location's name.
+ * hash - Hash of the name, the same as the list entry's.
+ * minutes - Minutes booked at the location.
+ * next - Next location in the same chain.
+ */
+struct StatsLocation {
+  const struct LocationEntry *entry;
+  char *location;
+  unsigned long hash;
+  long minutes;
+  struct StatsLocation *next;
+};
+
+/*
+ * The totals.
+ *
+ * days - Keys are days since 0001-01-01, see dateToDays.
+ * weeks - Keys are the Monday of the week, in days since 0001-01-01,
+ *         divided by 7. Weeks are ISO weeks (Monday to Sunday).
+ * months - Keys are the year times 12 plus the month, minus 1.
+ * locations - Hash table of the locations, with location_buckets
+ *             chains.
+ * location_count - Number of different locations.
+ * total_minutes - Minutes booked altogether.
+ */
+struct EventStats {
+  struct StatsRange days;
+  struct StatsRange weeks;
+  struct StatsRange months;
+  struct StatsLocation **locations;
+  int location_buckets;
+  int location_count;
+  long total_minutes;
+};
+
+/*
+ * Work out the totals for the list.
+ *
+ * Returns NULL if there was a memory error.
+ */
+struct EventStats *eventStatsCreate(struct EventList *list);
+
+/*
+ * Free the totals.
+ */
+void eventStatsDestroy(struct EventStats *stats);
+
+/*
+ * Minutes booked on the date.
+ */
+long eventStatsDayMinutes(const struct EventStats *stats,
+                          const struct Date *const date);
+
+/*
+ * Minutes booked in the ISO week the date is in.
+ */
+long eventStatsWeekMinutes(const struct EventStats *stats,
+                           const struct Date *const date);
+
+/*
+ * Minutes booked in the month, month is 1 to 12.
+ */
+long eventStatsMonthMinutes(const struct EventStats *stats, int year,
+                            int month);
+
+/*
+ * Minutes booked at the location, events without a location aren't
+ * counted anywhere.
+ */
+long eventStatsLocationMinutes(const struct EventStats *stats,
+                               const char *const location);
+
+#endif
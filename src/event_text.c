@@ -0,0 +1,1005 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Inverted index of the words in event names and locations.
+ */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "event_text.h"
+#include "hash.h"
+
+/*
+ * Starting sizes, they double as needed.
+ */
+#define TEXT_INITIAL_BUCKETS 256
+#define TEXT_INITIAL_IDS 64
+#define TEXT_INITIAL_POSTINGS 8
+#define TEXT_INITIAL_SORTED 256
+
+/*
+ * Most bytes a gap takes, seven bits a byte.
+ */
+#define TEXT_MAX_GAP_BYTES 5
+
+/*
+ * Dead ids allowed past the live ones before the postings are
+ * rewritten, so small indexes aren't rewritten all the time.
+ */
+#define TEXT_DEAD_SLACK 64
+
+#define TEXT_NAME_FIELD "name:"
+#define TEXT_LOCATION_FIELD "location:"
+#define TEXT_OR "OR"
+#define TEXT_PREFIX '*'
+
+/*
+ * A sorted set of ids, built up while running a query.
+ */
+struct TextIds {
+  int *ids;
+  int count;
+};
+
+/*
+ * Forward declarations.
+ */
+static void watchAdded(void *data, struct Event *event);
+static void watchChanged(void *data, struct Event *event);
+static void watchRemoved(void *data, struct Event *event);
+static Boolean indexEvent(struct EventTextIndex *index, struct Event *event);
+static Boolean indexText(struct EventTextIndex *index, const char *text,
+                         int field, int id);
+static void unindexEvent(struct EventTextIndex *index, struct Event *event);
+static void compact(struct EventTextIndex *index);
+static int nextWord(const char **text, const char *end, char *word);
+static Boolean isWordCharacter(char character);
+static unsigned long hashTerm(const char *text, int field);
+static struct EventTextTerm *findTerm(const struct EventTextIndex *index,
+                                      const char *text, int field);
+static struct EventTextTerm *addTerm(struct EventTextIndex *index,
+                                     const char *text, int field);
+static Boolean growTerms(struct EventTextIndex *index);
+static int compareTerm(const struct EventTextTerm *term, const char *text,
+                       int field);
+static int compareTerms(const void *first, const void *second);
+static int sortedFind(const struct EventTextIndex *index, const char *text,
+                      int field);
+static Boolean appendPosting(struct EventTextTerm *term, int id);
+static unsigned int readGap(const unsigned char *postings, int *read);
+static Boolean decodePostings(const struct EventTextIndex *index,
+                              const struct EventTextTerm *term,
+                              struct TextIds *ids);
+static int queryWord(const struct EventTextIndex *index, const char *start,
+                     const char *end, struct TextIds *ids);
+static Boolean wordIds(const struct EventTextIndex *index, const char *word,
+                       int fields, Boolean prefix, struct TextIds *ids);
+static Boolean combineIds(struct TextIds *into, struct TextIds *other,
+                          Boolean intersect);
+static Boolean mergeIds(struct TextIds *lists, int count,
+                        struct TextIds *ids);
+
+struct EventTextIndex *eventTextCreate(struct EventList *list)
+{
+  struct EventTextIndex *index;
+  struct EventListNode *node;
+  Boolean memory_ok;
+
+  index = (struct EventTextIndex *) malloc(sizeof(struct EventTextIndex));
+
+  if (index != NULL) {
+    index->terms = (struct EventTextTerm **)
+                   calloc(TEXT_INITIAL_BUCKETS, sizeof(struct EventTextTerm *));
+    index->term_buckets = TEXT_INITIAL_BUCKETS;
+    index->term_count = 0;
+    index->sorted = (struct EventTextTerm **)
+                    malloc(sizeof(struct EventTextTerm *) *
+                           TEXT_INITIAL_SORTED);
+    index->sorted_capacity = TEXT_INITIAL_SORTED;
+    index->sorted_dirty = FALSE;
+    index->events = (struct Event **)
+                    malloc(sizeof(struct Event *) * TEXT_INITIAL_IDS);
+    index->id_count = 0;
+    index->id_capacity = TEXT_INITIAL_IDS;
+    index->live_count = 0;
+    eventIdMapInit(&index->text_ids);
+    index->list = list;
+    index->watcher.added = watchAdded;
+    index->watcher.changed = watchChanged;
+    index->watcher.removed = watchRemoved;
+    index->watcher.data = index;
+    index->watcher.next = NULL;
+    index->memory_error = FALSE;
+
+    memory_ok = (index->terms != NULL && index->sorted != NULL &&
+                 index->events != NULL);
+
+    for (node = list->head; node != NULL && memory_ok; node = node->next) {
+      memory_ok = indexEvent(index, node->event);
+    }
+
+    if (memory_ok) {
+      eventListWatch(list, &index->watcher);
+    } else {
+      /* Not watching yet, so make sure destroy doesn't try to stop. */
+      index->list = NULL;
+      eventTextDestroy(index);
+      index = NULL;
+    }
+  }
+
+  return index;
+}
+
+void eventTextDestroy(struct EventTextIndex *index)
+{
+  struct EventTextTerm *term, *next_term;
+  int i;
+
+  if (index != NULL) {
+    if (index->list != NULL) {
+      eventListUnwatch(index->list, &index->watcher);
+    }
+
+    if (index->terms != NULL) {
+      for (i = 0; i < index->term_buckets; i++) {
+        for (term = index->terms[i]; term != NULL; term = next_term) {
+          next_term = term->next;
+          free(term->text);
+          free(term->postings);
+          free(term);
+        }
+      }
+    }
+
+    free(index->terms);
+    free(index->sorted);
+    free(index->events);
+    eventIdMapFree(&index->text_ids);
+    free(index);
+  }
+}
+
+/*
+ * Each word of the query narrows the ids down, except that a word
+ * after OR widens the previous word's ids instead, so the ids for a
+ * run of words joined by OR are built up before they're used.
+ */
+int eventTextSearch(struct EventTextIndex *index, const char *const query,
+                    struct Event ***results)
+{
+  struct TextIds matched, group, word;
+  struct Event **events;
+  const char *start, *end;
+  Boolean have_matched, have_group, after_or, memory_ok;
+  int word_count, result, i;
+
+  matched.ids = NULL;
+  matched.count = 0;
+  group.ids = NULL;
+  group.count = 0;
+  have_matched = FALSE;
+  have_group = FALSE;
+  after_or = FALSE;
+  memory_ok = !index->memory_error;
+  start = query;
+
+  /* New terms were only added to the end, put them in order once. */
+  if (memory_ok && index->sorted_dirty) {
+    qsort(index->sorted, index->term_count, sizeof(struct EventTextTerm *),
+          compareTerms);
+    index->sorted_dirty = FALSE;
+  }
+
+  while (*start != '\0' && memory_ok) {
+    while (isspace((unsigned char) *start)) {
+      start++;
+    }
+
+    end = start;
+
+    while (*end != '\0' && !isspace((unsigned char) *end)) {
+      end++;
+    }
+
+    if (end - start == (int) strlen(TEXT_OR) &&
+        strncmp(start, TEXT_OR, end - start) == 0) {
+      after_or = TRUE;
+    } else if (end > start) {
+      word_count = queryWord(index, start, end, &word);
+      memory_ok = (word_count >= 0);
+
+      if (word_count > 0 && have_group && after_or) {
+        memory_ok = combineIds(&group, &word, FALSE);
+      } else if (word_count > 0) {
+        if (have_group && have_matched) {
+          memory_ok = combineIds(&matched, &group, TRUE);
+        } else if (have_group) {
+          matched = group;
+          have_matched = TRUE;
+        }
+
+        group = word;
+        have_group = TRUE;
+      }
+
+      after_or = FALSE;
+    }
+
+    start = end;
+  }
+
+  if (memory_ok && have_group && have_matched) {
+    memory_ok = combineIds(&matched, &group, TRUE);
+  } else if (memory_ok && have_group) {
+    matched = group;
+    have_matched = TRUE;
+  } else if (!memory_ok) {
+    free(group.ids);
+  }
+
+  events = NULL;
+
+  if (memory_ok) {
+    events = (struct Event **)
+             malloc(sizeof(struct Event *) * (matched.count + 1));
+  }
+
+  if (events != NULL) {
+    for (i = 0; i < matched.count; i++) {
+      events[i] = index->events[matched.ids[i]];
+    }
+
+    *results = events;
+    result = matched.count;
+  } else {
+    result = -1;
+  }
+
+  free(matched.ids);
+
+  return result;
+}
+
+static void watchAdded(void *data, struct Event *event)
+{
+  struct EventTextIndex *index;
+
+  index = (struct EventTextIndex *) data;
+
+  if (!indexEvent(index, event)) {
+    index->memory_error = TRUE;
+  }
+}
+
+/*
+ * The old words are gone by now, so the old id is killed and the event
+ * indexed again under a new one.
+ */
+static void watchChanged(void *data, struct Event *event)
+{
+  struct EventTextIndex *index;
+
+  index = (struct EventTextIndex *) data;
+  unindexEvent(index, event);
+
+  if (!indexEvent(index, event)) {
+    index->memory_error = TRUE;
+  }
+}
+
+static void watchRemoved(void *data, struct Event *event)
+{
+  struct EventTextIndex *index;
+
+  index = (struct EventTextIndex *) data;
+  unindexEvent(index, event);
+}
+
+/*
+ * Give the event the next id and add it to the postings of its words.
+ */
+static Boolean indexEvent(struct EventTextIndex *index, struct Event *event)
+{
+  struct Event **events;
+  Boolean result;
+  int id;
+
+  result = TRUE;
+
+  if (index->id_count == index->id_capacity) {
+    events = (struct Event **)
+             realloc(index->events,
+                     sizeof(struct Event *) * index->id_capacity * 2);
+    result = (events != NULL);
+
+    if (result) {
+      index->events = events;
+      index->id_capacity *= 2;
+    }
+  }
+
+  if (result) {
+    result = eventIdMapPut(&index->text_ids, event->id, event,
+                           index->id_count);
+  }
+
+  if (result) {
+    id = index->id_count;
+    index->events[id] = event;
+    index->id_count++;
+    index->live_count++;
+
+    result = indexText(index, event->name, EVENT_TEXT_NAME, id);
+
+    if (result && event->location != NULL) {
+      result = indexText(index, eventLocation(event), EVENT_TEXT_LOCATION,
+                         id);
+    }
+  }
+
+  return result;
+}
+
+static Boolean indexText(struct EventTextIndex *index, const char *text,
+                         int field, int id)
+{
+  struct EventTextTerm *term;
+  char word[EVENT_TEXT_MAX_WORD + 1];
+  const char *end;
+  Boolean result;
+
+  result = TRUE;
+  end = text + strlen(text);
+
+  while (result && nextWord(&text, end, word) > 0) {
+    term = findTerm(index, word, field);
+
+    if (term == NULL) {
+      term = addTerm(index, word, field);
+    }
+
+    /* A word twice in the same name is only posted once. */
+    if (term == NULL) {
+      result = FALSE;
+    } else if (term->last_id != id) {
+      result = appendPosting(term, id);
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Kill the event's id, its postings stay until there are enough dead
+ * ids to be worth compacting.
+ */
+static void unindexEvent(struct EventTextIndex *index, struct Event *event)
+{
+  if (eventIdMapGet(&index->text_ids, event->id) == event) {
+    index->events[eventIdMapValue(&index->text_ids, event->id)] = NULL;
+    index->live_count--;
+    eventIdMapRemove(&index->text_ids, event->id);
+
+    if (index->id_count - index->live_count >
+        index->live_count + TEXT_DEAD_SLACK) {
+      compact(index);
+    }
+  }
+}
+
+/*
+ * Number the live ids again from 0, in the same order, and rewrite the
+ * postings with the new ids. The new gaps are never bigger than the
+ * old gaps they replace, so each list can be rewritten where it is.
+ * Terms left without postings are taken out of their buckets, then
+ * out of the sorted terms and freed.
+ */
+static void compact(struct EventTextIndex *index)
+{
+  struct EventTextTerm **link, *term;
+  int *new_ids;
+  int old_id, new_id, last_id, read, write, kept, i;
+  unsigned int gap;
+
+  new_ids = (int *) malloc(sizeof(int) * (index->id_count + 1));
+
+  /* Without the memory it's still right, just bigger. */
+  if (new_ids != NULL) {
+    new_id = 0;
+
+    for (i = 0; i < index->id_count; i++) {
+      if (index->events[i] != NULL) {
+        new_ids[i] = new_id;
+        index->events[new_id] = index->events[i];
+        new_id++;
+      } else {
+        new_ids[i] = -1;
+      }
+    }
+
+    index->id_count = new_id;
+
+    for (i = 0; i < index->text_ids.capacity; i++) {
+      if (index->text_ids.slots[i].id != EVENT_NO_ID) {
+        index->text_ids.slots[i].value =
+          new_ids[index->text_ids.slots[i].value];
+      }
+    }
+
+    for (i = 0; i < index->term_buckets; i++) {
+      link = &index->terms[i];
+
+      while (*link != NULL) {
+        term = *link;
+        old_id = -1;
+        last_id = -1;
+        read = 0;
+        write = 0;
+
+        while (read < term->size) {
+          old_id += (int) readGap(term->postings, &read);
+
+          if (new_ids[old_id] >= 0) {
+            gap = (unsigned int) (new_ids[old_id] - last_id);
+            last_id = new_ids[old_id];
+
+            while (gap >= 0x80) {
+              term->postings[write] = (unsigned char) ((gap & 0x7f) | 0x80);
+              gap >>= 7;
+              write++;
+            }
+
+            term->postings[write] = (unsigned char) gap;
+            write++;
+          }
+        }
+
+        term->size = write;
+        term->last_id = last_id;
+
+        if (term->size == 0) {
+          *link = term->next;
+        } else {
+          link = &term->next;
+        }
+      }
+    }
+
+    kept = 0;
+
+    for (i = 0; i < index->term_count; i++) {
+      term = index->sorted[i];
+
+      if (term->size == 0) {
+        free(term->text);
+        free(term->postings);
+        free(term);
+      } else {
+        index->sorted[kept] = term;
+        kept++;
+      }
+    }
+
+    index->term_count = kept;
+    free(new_ids);
+  }
+}
+
+/*
+ * Copy the next word from text to word, folded to lower case, and move
+ * text past it. Bytes over 127 count as letters, so words in UTF-8 stay
+ * together.
+ *
+ * Returns the length of the word, 0 when there are no more.
+ */
+static int nextWord(const char **text, const char *end, char *word)
+{
+  const char *current;
+  int length;
+
+  current = *text;
+  length = 0;
+
+  while (current < end && !isWordCharacter(*current)) {
+    current++;
+  }
+
+  while (current < end && isWordCharacter(*current)) {
+    if (length < EVENT_TEXT_MAX_WORD) {
+      word[length] = (char) tolower((unsigned char) *current);
+      length++;
+    }
+
+    current++;
+  }
+
+  word[length] = '\0';
+  *text = current;
+
+  return length;
+}
+
+static Boolean isWordCharacter(char character)
+{
+  return (isalnum((unsigned char) character) ||
+          (unsigned char) character > 127);
+}
+
+/*
+ * The text's hash, with the field mixed in last.
+ */
+static unsigned long hashTerm(const char *text, int field)
+{
+  return hashAdd(hashString(text, strlen(text)), (unsigned long) field);
+}
+
+static struct EventTextTerm *findTerm(const struct EventTextIndex *index,
+                                      const char *text, int field)
+{
+  struct EventTextTerm *result;
+
+  result = index->terms[hashTerm(text, field) & (index->term_buckets - 1)];
+
+  while (result != NULL &&
+         (result->field != field || strcmp(result->text, text) != 0)) {
+    result = result->next;
+  }
+
+  return result;
+}
+
+/*
+ * The new term goes in its bucket, and on the end of the sorted terms
+ * to be put in order by the next search. Both have room made first,
+ * so a memory error leaves them as they were.
+ */
+static struct EventTextTerm *addTerm(struct EventTextIndex *index,
+                                     const char *text, int field)
+{
+  struct EventTextTerm *result, **sorted;
+  unsigned long bucket;
+
+  result = NULL;
+
+  if (index->term_count == index->sorted_capacity) {
+    sorted = (struct EventTextTerm **)
+             realloc(index->sorted, sizeof(struct EventTextTerm *) *
+                     index->sorted_capacity * 2);
+
+    if (sorted != NULL) {
+      index->sorted = sorted;
+      index->sorted_capacity *= 2;
+    }
+  }
+
+  if (index->term_count < index->sorted_capacity &&
+      (index->term_count < index->term_buckets || growTerms(index))) {
+    result = (struct EventTextTerm *) malloc(sizeof(struct EventTextTerm));
+  }
+
+  if (result != NULL) {
+    result->text = (char *) malloc(strlen(text) + 1);
+    result->postings = (unsigned char *) malloc(TEXT_INITIAL_POSTINGS);
+
+    if (result->text != NULL && result->postings != NULL) {
+      strcpy(result->text, text);
+      result->field = field;
+      result->size = 0;
+      result->capacity = TEXT_INITIAL_POSTINGS;
+      result->last_id = -1;
+
+      bucket = hashTerm(text, field) & (index->term_buckets - 1);
+      result->next = index->terms[bucket];
+      index->terms[bucket] = result;
+
+      index->sorted[index->term_count] = result;
+      index->term_count++;
+      index->sorted_dirty = TRUE;
+    } else {
+      free(result->text);
+      free(result->postings);
+      free(result);
+      result = NULL;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Double the buckets and move the terms over.
+ */
+static Boolean growTerms(struct EventTextIndex *index)
+{
+  struct EventTextTerm **terms, *term, *next_term;
+  unsigned long bucket;
+  int i;
+
+  terms = (struct EventTextTerm **)
+          calloc(index->term_buckets * 2, sizeof(struct EventTextTerm *));
+
+  if (terms != NULL) {
+    for (i = 0; i < index->term_buckets; i++) {
+      for (term = index->terms[i]; term != NULL; term = next_term) {
+        next_term = term->next;
+        bucket = hashTerm(term->text, term->field) &
+                 (index->term_buckets * 2 - 1);
+        term->next = terms[bucket];
+        terms[bucket] = term;
+      }
+    }
+
+    free(index->terms);
+    index->terms = terms;
+    index->term_buckets *= 2;
+  }
+
+  return (terms != NULL);
+}
+
+/*
+ * Order of the sorted terms, by text then field. Less than zero if the
+ * term comes before text and field.
+ */
+static int compareTerm(const struct EventTextTerm *term, const char *text,
+                       int field)
+{
+  int result;
+
+  result = strcmp(term->text, text);
+
+  if (result == 0) {
+    result = term->field - field;
+  }
+
+  return result;
+}
+
+/*
+ * compareTerm for qsort, on two pointers to terms.
+ */
+static int compareTerms(const void *first, const void *second)
+{
+  const struct EventTextTerm *other;
+
+  other = *(struct EventTextTerm *const *) second;
+
+  return compareTerm(*(struct EventTextTerm *const *) first, other->text,
+                     other->field);
+}
+
+/*
+ * Binary search for the first sorted term that isn't before text and
+ * field, term_count if they all are.
+ */
+static int sortedFind(const struct EventTextIndex *index, const char *text,
+                      int field)
+{
+  int low, high, middle;
+
+  low = 0;
+  high = index->term_count;
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+
+    if (compareTerm(index->sorted[middle], text, field) < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+static Boolean appendPosting(struct EventTextTerm *term, int id)
+{
+  unsigned char *postings;
+  unsigned int gap;
+  Boolean result;
+
+  result = TRUE;
+
+  if (term->size + TEXT_MAX_GAP_BYTES > term->capacity) {
+    postings = (unsigned char *) realloc(term->postings, term->capacity * 2);
+    result = (postings != NULL);
+
+    if (result) {
+      term->postings = postings;
+      term->capacity *= 2;
+    }
+  }
+
+  if (result) {
+    gap = (unsigned int) (id - term->last_id);
+    term->last_id = id;
+
+    while (gap >= 0x80) {
+      term->postings[term->size] = (unsigned char) ((gap & 0x7f) | 0x80);
+      gap >>= 7;
+      term->size++;
+    }
+
+    term->postings[term->size] = (unsigned char) gap;
+    term->size++;
+  }
+
+  return result;
+}
+
+/*
+ * Read the gap starting at read, and move read past it.
+ */
+static unsigned int readGap(const unsigned char *postings, int *read)
+{
+  unsigned int gap, shift;
+
+  gap = 0;
+  shift = 0;
+
+  while (postings[*read] & 0x80) {
+    gap |= (unsigned int) (postings[*read] & 0x7f) << shift;
+    shift += 7;
+    (*read)++;
+  }
+
+  gap |= (unsigned int) postings[*read] << shift;
+  (*read)++;
+
+  return gap;
+}
+
+/*
+ * The live ids in the term's postings, which are already in order.
+ * Every gap takes at least a byte, so there are no more ids than
+ * bytes.
+ */
+static Boolean decodePostings(const struct EventTextIndex *index,
+                              const struct EventTextTerm *term,
+                              struct TextIds *ids)
+{
+  int id, read;
+
+  ids->count = 0;
+  ids->ids = (int *) malloc(sizeof(int) * (term->size + 1));
+
+  if (ids->ids != NULL) {
+    id = -1;
+    read = 0;
+
+    while (read < term->size) {
+      id += (int) readGap(term->postings, &read);
+
+      if (index->events[id] != NULL) {
+        ids->ids[ids->count] = id;
+        ids->count++;
+      }
+    }
+  }
+
+  return (ids->ids != NULL);
+}
+
+/*
+ * Work out a query word's field and whether it's a prefix, then match
+ * each of its words, the last one as a prefix if it is.
+ *
+ * Returns the number of words it had, 0 if it had none and ids was
+ * left alone, or -1 if there was a memory error.
+ */
+static int queryWord(const struct EventTextIndex *index, const char *start,
+                     const char *end, struct TextIds *ids)
+{
+  struct TextIds next_ids;
+  char word[EVENT_TEXT_MAX_WORD + 1];
+  char next_word[EVENT_TEXT_MAX_WORD + 1];
+  Boolean prefix, more, memory_ok;
+  int fields, result;
+
+  fields = EVENT_TEXT_ANYWHERE;
+
+  if (end - start > (int) strlen(TEXT_NAME_FIELD) &&
+      strncmp(start, TEXT_NAME_FIELD, strlen(TEXT_NAME_FIELD)) == 0) {
+    fields = EVENT_TEXT_NAME;
+    start += strlen(TEXT_NAME_FIELD);
+  } else if (end - start > (int) strlen(TEXT_LOCATION_FIELD) &&
+             strncmp(start, TEXT_LOCATION_FIELD,
+                     strlen(TEXT_LOCATION_FIELD)) == 0) {
+    fields = EVENT_TEXT_LOCATION;
+    start += strlen(TEXT_LOCATION_FIELD);
+  }
+
+  prefix = (end > start && *(end - 1) == TEXT_PREFIX);
+
+  if (prefix) {
+    end--;
+  }
+
+  result = 0;
+  memory_ok = TRUE;
+  more = (nextWord(&start, end, word) > 0);
+
+  while (more && memory_ok) {
+    more = (nextWord(&start, end, next_word) > 0);
+    memory_ok = wordIds(index, word, fields, prefix && !more, &next_ids);
+
+    if (memory_ok && result == 0) {
+      *ids = next_ids;
+    } else if (memory_ok) {
+      memory_ok = combineIds(ids, &next_ids, TRUE);
+    } else if (result > 0) {
+      free(ids->ids);
+    }
+
+    if (memory_ok) {
+      result++;
+      strcpy(word, next_word);
+    }
+  }
+
+  if (!memory_ok) {
+    result = -1;
+  }
+
+  return result;
+}
+
+/*
+ * The live ids of one word. The terms it matches are next to each
+ * other in the sorted terms, the word's own terms (one for each field)
+ * first, then any longer words starting with it. Only the first lot
+ * are used unless it's a prefix. Each term's ids are decoded and the
+ * lists merged.
+ */
+static Boolean wordIds(const struct EventTextIndex *index, const char *word,
+                       int fields, Boolean prefix, struct TextIds *ids)
+{
+  struct TextIds *lists;
+  size_t length;
+  Boolean memory_ok;
+  int first, last, count, i;
+
+  length = strlen(word);
+  first = sortedFind(index, word, 0);
+  last = first;
+
+  while (last < index->term_count &&
+         strncmp(index->sorted[last]->text, word, length) == 0 &&
+         (prefix || index->sorted[last]->text[length] == '\0')) {
+    last++;
+  }
+
+  lists = (struct TextIds *)
+          malloc(sizeof(struct TextIds) * (last - first + 1));
+  memory_ok = (lists != NULL);
+  count = 0;
+
+  for (i = first; i < last && memory_ok; i++) {
+    if ((index->sorted[i]->field & fields) != 0) {
+      memory_ok = decodePostings(index, index->sorted[i], &lists[count]);
+      count++;
+    }
+  }
+
+  if (memory_ok) {
+    memory_ok = mergeIds(lists, count, ids);
+  } else {
+    for (i = 0; i < count; i++) {
+      free(lists[i].ids);
+    }
+  }
+
+  free(lists);
+
+  return memory_ok;
+}
+
+/*
+ * Merge other into into, keeping the ids in both if intersect is set,
+ * otherwise those in either. other is freed either way, into is freed
+ * too if there's a memory error.
+ */
+static Boolean combineIds(struct TextIds *into, struct TextIds *other,
+                          Boolean intersect)
+{
+  int *ids;
+  int count, i, j;
+
+  ids = (int *) malloc(sizeof(int) * (into->count + other->count + 1));
+  count = 0;
+
+  if (ids != NULL) {
+    i = 0;
+    j = 0;
+
+    while (i < into->count && j < other->count) {
+      if (into->ids[i] == other->ids[j]) {
+        ids[count] = into->ids[i];
+        count++;
+        i++;
+        j++;
+      } else if (into->ids[i] < other->ids[j]) {
+        if (!intersect) {
+          ids[count] = into->ids[i];
+          count++;
+        }
+
+        i++;
+      } else {
+        if (!intersect) {
+          ids[count] = other->ids[j];
+          count++;
+        }
+
+        j++;
+      }
+    }
+
+    while (!intersect && i < into->count) {
+      ids[count] = into->ids[i];
+      count++;
+      i++;
+    }
+
+    while (!intersect && j < other->count) {
+      ids[count] = other->ids[j];
+      count++;
+      j++;
+    }
+  }
+
+  free(into->ids);
+  free(other->ids);
+  into->ids = ids;
+  into->count = count;
+
+  return (ids != NULL);
+}
+
+/*
+ * Union of all the lists into ids, merged in pairs so each id is only
+ * copied about log(count) times. The lists are freed either way.
+ */
+static Boolean mergeIds(struct TextIds *lists, int count,
+                        struct TextIds *ids)
+{
+  Boolean result;
+  int merged, i;
+
+  result = TRUE;
+
+  while (count > 1) {
+    merged = 0;
+
+    for (i = 0; i < count; i += 2) {
+      if (i + 1 < count) {
+        result = combineIds(&lists[i], &lists[i + 1], FALSE) && result;
+      }
+
+      lists[merged] = lists[i];
+      merged++;
+    }
+
+    count = merged;
+  }
+
+  if (count == 1) {
+    *ids = lists[0];
+  } else {
+    ids->count = 0;
+    ids->ids = (int *) malloc(sizeof(int));
+  }
+
+  if (!result) {
+    free(ids->ids);
+    ids->ids = NULL;
+  }
+
+  return (ids->ids != NULL);
+}
@@ -0,0 +1,133 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Searching events by the words in their names and locations.
+ *
+ * The index splits names and locations into words (runs of letters and
+ * digits, folded to lower case) and keeps, for every word, the events
+ * it's in. Each event gets an id when it's indexed and the ids in a
+ * word's list only go up, so they're stored as the gap from the one
+ * before, seven bits to a byte with the top bit set on all but the
+ * last byte of each gap. Most gaps fit in a byte.
+ *
+ * Unlike an EventIndex, this one watches its list and keeps itself up
+ * to date. A removed event's id is just marked dead, an edited event is
+ * removed and added again under a new id, and once there are more dead
+ * ids than live ones the lists are rewritten without them.
+ *
+ * Queries are words, and an event has to match all of them. Words
+ * joined by OR match if any of them does. A word ending in * matches
+ * any word starting with it, and one starting with name: or location:
+ * only looks there. A query word with punctuation in it is split into
+ * words the same way names are, all of which have to match.
+ */
+
+#ifndef EVENT_TEXT_H_
+#define EVENT_TEXT_H_
+
+#include "bool.h"
+#include "event.h"
+#include "event_id_map.h"
+#include "event_list.h"
+
+/*
+ * Where a word was found.
+ */
+#define EVENT_TEXT_NAME 1
+#define EVENT_TEXT_LOCATION 2
+#define EVENT_TEXT_ANYWHERE (EVENT_TEXT_NAME | EVENT_TEXT_LOCATION)
+
+/*
+ * Longest word kept, longer ones are cut short.
+ */
+#define EVENT_TEXT_MAX_WORD 64
+
+/*
+ * A word and the events it's in.
+ *
+ * text - The word.
+ * field - EVENT_TEXT_NAME or EVENT_TEXT_LOCATION, the same word in
+ *         both is two terms.
+ * postings - The ids, as gaps.
+ * size - Bytes used in postings.
+ * capacity - Bytes allocated for postings.
+ * last_id - Last id in postings, -1 if there aren't any.
+ * next - Next term in the same hash bucket.
+ */
+struct EventTextTerm {
+  char *text;
+  int field;
+  unsigned char *postings;
+  int size;
+  int capacity;
+  int last_id;
+  struct EventTextTerm *next;
+};
+
+/*
+ * The index.
+ *
+ * terms - Hash table of the terms.
+ * term_buckets - Size of terms, a power of two.
+ * term_count - Number of terms.
+ * sorted - Every term, by text then field, so the terms starting with
+ *          a prefix can be binary searched for.
+ * sorted_capacity - Size of sorted.
+ * sorted_dirty - TRUE if terms were added to the end of sorted since it
+ *                was last put in order.
+ * events - The event with each id, NULL once it's removed.
+ * id_count - Ids handed out, the next one to use.
+ * id_capacity - Size of events.
+ * live_count - Ids that aren't dead.
+ * text_ids - Each event's id in the index, as the value kept with the
+ *            event under its own id.
+ * list - The list being watched.
+ * watcher - How the list tells the index about changes.
+ * memory_error - TRUE if a change couldn't be indexed, the index is no
+ *                good after that.
+ */
+struct EventTextIndex {
+  struct EventTextTerm **terms;
+  int term_buckets;
+  int term_count;
+  struct EventTextTerm **sorted;
+  int sorted_capacity;
+  Boolean sorted_dirty;
+  struct Event **events;
+  int id_count;
+  int id_capacity;
+  int live_count;
+  struct EventIdMap text_ids;
+  struct EventList *list;
+  struct EventListWatcher watcher;
+  Boolean memory_error;
+};
+
+/*
+ * Index the events in the list, and watch it for changes.
+ *
+ * Returns NULL if there was a memory error.
+ */
+struct EventTextIndex *eventTextCreate(struct EventList *list);
+
+/*
+ * Stop watching the list and free the index, the events are left
+ * alone. Has to be done before the list is destroyed.
+ */
+void eventTextDestroy(struct EventTextIndex *index);
+
+/*
+ * Find the events matching the query, in the order they were added to
+ * the index (an edited event counts as added when it was edited).
+ *
+ * results - Set to an array of the events, which the caller frees
+ *           using free(). Left alone if there was an error.
+ *
+ * Returns the number of events, or -1 if there was a memory error.
+ */
+int eventTextSearch(struct EventTextIndex *index, const char *const query,
+                    struct Event ***results);
+
+#endif
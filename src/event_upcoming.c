@@ -0,0 +1,172 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Upcoming events, by index seek or bounded heap.
+ */
+
+#include <stdlib.h>
+
+#include "bool.h"
+#include "event_upcoming.h"
+
+/*
+ * An event in the heap, with where it was in the list so events
+ * starting at the same time keep their list order.
+ */
+struct HeapEntry {
+  struct Event *event;
+  int position;
+};
+
+/*
+ * Forward declarations.
+ */
+static Boolean entryLater(const struct HeapEntry *first,
+                          const struct HeapEntry *second);
+static void siftUp(struct HeapEntry *heap, int child);
+static void siftDown(struct HeapEntry *heap, int size, int parent);
+static int upcomingScan(struct EventList *list, Timestamp from, int count,
+                        struct Event **upcoming);
+
+int eventUpcoming(struct EventList *list, const struct EventIndex *index,
+                  Timestamp from, int count, struct Event **upcoming)
+{
+  int found, first;
+
+  if (count <= 0) {
+    found = 0;
+  } else if (eventIndexIsCurrent(index, list)) {
+    first = eventIndexSeekStart(index, from);
+
+    for (found = 0; found < count && first + found < index->count;
+         found++) {
+      upcoming[found] = index->by_start[first + found];
+    }
+  } else {
+    found = upcomingScan(list, from, count, upcoming);
+  }
+
+  return found;
+}
+
+/*
+ * TRUE if first comes after second, by start then list position.
+ */
+static Boolean entryLater(const struct HeapEntry *first,
+                          const struct HeapEntry *second)
+{
+  Boolean result;
+
+  if (first->event->timestamp != second->event->timestamp) {
+    result = (first->event->timestamp > second->event->timestamp);
+  } else {
+    result = (first->position > second->position);
+  }
+
+  return result;
+}
+
+/*
+ * The heap keeps the latest entry at the top, so it is the one pushed
+ * out when something earlier is found.
+ */
+static void siftUp(struct HeapEntry *heap, int child)
+{
+  struct HeapEntry swap;
+  int parent;
+
+  while (child > 0) {
+    parent = (child - 1) / 2;
+
+    if (entryLater(&heap[child], &heap[parent])) {
+      swap = heap[child];
+      heap[child] = heap[parent];
+      heap[parent] = swap;
+      child = parent;
+    } else {
+      child = 0;
+    }
+  }
+}
+
+static void siftDown(struct HeapEntry *heap, int size, int parent)
+{
+  struct HeapEntry swap;
+  int child, latest;
+
+  latest = parent;
+
+  do {
+    parent = latest;
+    child = parent * 2 + 1;
+
+    if (child < size && entryLater(&heap[child], &heap[latest])) {
+      latest = child;
+    }
+
+    if (child + 1 < size && entryLater(&heap[child + 1], &heap[latest])) {
+      latest = child + 1;
+    }
+
+    if (latest != parent) {
+      swap = heap[parent];
+      heap[parent] = heap[latest];
+      heap[latest] = swap;
+    }
+  } while (latest != parent);
+}
+
+/*
+ * One pass through the list with a heap of at most count entries,
+ * then take the latest off the top each time to fill upcoming from
+ * the back.
+ */
+static int upcomingScan(struct EventList *list, Timestamp from, int count,
+                        struct Event **upcoming)
+{
+  struct EventListNode *current_node;
+  struct HeapEntry *heap;
+  struct HeapEntry entry;
+  int size, position;
+
+  heap = (struct HeapEntry *) malloc(sizeof(struct HeapEntry) * count);
+
+  if (heap != NULL) {
+    size = 0;
+    position = 0;
+
+    for (current_node = list->head; current_node != NULL;
+         current_node = current_node->next) {
+      entry.event = current_node->event;
+      entry.position = position++;
+
+      if (entry.event->timestamp >= from) {
+        if (size < count) {
+          heap[size] = entry;
+          siftUp(heap, size);
+          size++;
+        } else if (entryLater(&heap[0], &entry)) {
+          heap[0] = entry;
+          siftDown(heap, size, 0);
+        }
+      }
+    }
+
+    position = size;
+
+    while (position > 0) {
+      position--;
+      upcoming[position] = heap[0].event;
+      heap[0] = heap[position];
+      siftDown(heap, position, 0);
+    }
+
+    free(heap);
+  } else {
+    size = -1;
+  }
+
+  return size;
+}
@@ -0,0 +1,42 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Finding the next few events from a time.
+ *
+ * With a current EventIndex this is a binary search of by_start and
+ * copying out the events from there. Without one, the list is
+ * scanned once keeping the earliest events found so far in a heap
+ * that never holds more than the number asked for, so nothing is
+ * ever sorted but those.
+ */
+
+#ifndef EVENT_UPCOMING_H_
+#define EVENT_UPCOMING_H_
+
+#include "date_time.h"
+#include "event.h"
+#include "event_index.h"
+#include "event_list.h"
+
+/*
+ * Find the first events starting at or after a time.
+ *
+ * Events are returned in order of start, events starting at the same
+ * time are in list order, the same as in an EventIndex.
+ *
+ * list - Events to look through.
+ * index - Index of the list to use, ignored if NULL or not current.
+ * from - Time to look from.
+ * count - Most events to find.
+ * upcoming - Updated with the events found, must have space for
+ *            count events. The events still belong to the list.
+ *
+ * Returns the number of events found, or -1 if there was a memory
+ * error.
+ */
+int eventUpcoming(struct EventList *list, const struct EventIndex *index,
+                  Timestamp from, int count, struct Event **upcoming);
+
+#endif
@@ -311,6 +311,166 @@ int dialogBox(Window *window, char *dialogTitle,
   return response;
 }
 
+/**
+ * Used internally by the searchBox function, and the searchChanged static
+ * function. Contains the search function and what it needs, and the widgets
+ * showing its rows.
+ */
+typedef struct {
+  int (*function)(const char *, char **, int, int *, void *);
+  void *data;
+  char **rows;
+  int maxRows;
+  GtkListStore *store;
+  GtkWidget *view;
+} Search;
+
+/**
+ * Not visible outside this file. Runs the search again whenever the text in
+ * the input space changes, and shows the rows it comes back with.
+ */
+static void searchChanged(GtkWidget *widget, gpointer data)
+{
+  Search *search = (Search *)data;
+  GtkTreeIter iter;
+  int i, nRows, pick;
+
+  pick = -1;
+  nRows = search->function(gtk_entry_get_text(GTK_ENTRY(widget)),
+                           search->rows, search->maxRows, &pick,
+                           search->data);
+
+  gtk_list_store_clear(search->store);
+
+  for (i = 0; i < nRows; i++) {
+    gtk_list_store_append(search->store, &iter);
+    gtk_list_store_set(search->store, &iter, 0, search->rows[i], -1);
+  }
+
+  /* Clearing the rows took away any selection, only pick's is put back. */
+  if (pick >= 0 && pick < nRows &&
+      gtk_tree_model_iter_nth_child(GTK_TREE_MODEL(search->store), &iter,
+                                    NULL, pick)) {
+    gtk_tree_selection_select_iter(
+      gtk_tree_view_get_selection(GTK_TREE_VIEW(search->view)), &iter);
+  }
+}
+
+/**
+ * Not visible outside this file. Double clicking a row picks it, the same as
+ * pressing "Ok".
+ */
+static void searchRowActivated(GtkTreeView *view, GtkTreePath *path,
+                               GtkTreeViewColumn *column, gpointer data)
+{
+  gtk_dialog_response(GTK_DIALOG(data), GTK_RESPONSE_OK);
+}
+
+/**
+ * Displays a dialog box with one input space and a list of rows under it,
+ * that search fills in again every time the input changes. See gui.h for the
+ * parameters.
+ */
+int searchBox(Window *window, char *dialogTitle, InputProperties *properties,
+              char *input,
+              int (*search)(const char *text, char **rows, int maxRows,
+                            int *pick, void *data),
+              void *data, int maxRows, int *selected)
+{
+  int response;
+  Search searchDetails;
+  GtkWidget *dialog, *contentArea, *label, *entry, *scrolled;
+  GtkTreeIter iter;
+  GtkTreePath *path;
+
+  assert(window != NULL);
+  assert(dialogTitle != NULL);
+  assert(properties != NULL);
+  assert(input != NULL);
+  assert(search != NULL);
+  assert(maxRows >= 1);
+  assert(selected != NULL);
+
+  dialog = gtk_dialog_new_with_buttons(
+             dialogTitle,
+             GTK_WINDOW(window->gtkWindow),
+             GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+             GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL,
+             GTK_STOCK_OK,     GTK_RESPONSE_OK,
+             NULL
+           );
+  gtk_dialog_set_default_response(GTK_DIALOG(dialog), GTK_RESPONSE_OK);
+  contentArea = gtk_dialog_get_content_area(GTK_DIALOG(dialog));
+
+  label = gtk_label_new(properties->label);
+  gtk_box_pack_start(GTK_BOX(contentArea), label, FALSE, TRUE, 0);
+
+  entry = gtk_entry_new();
+  gtk_entry_set_max_length(GTK_ENTRY(entry), properties->maxLength);
+  gtk_entry_set_activates_default(GTK_ENTRY(entry), TRUE);
+  gtk_label_set_mnemonic_widget(GTK_LABEL(label), entry);
+  gtk_box_pack_start(GTK_BOX(contentArea), entry, FALSE, TRUE, 0);
+
+  /* The rows are a one column list of strings, without a header. */
+  searchDetails.function = search;
+  searchDetails.data = data;
+  searchDetails.rows = (char **)malloc(maxRows * sizeof(char *));
+  searchDetails.maxRows = maxRows;
+  searchDetails.store = gtk_list_store_new(1, G_TYPE_STRING);
+  searchDetails.view = gtk_tree_view_new_with_model(
+                         GTK_TREE_MODEL(searchDetails.store));
+  assert(searchDetails.rows != NULL);
+
+  gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(searchDetails.view), FALSE);
+  gtk_tree_view_insert_column_with_attributes(
+    GTK_TREE_VIEW(searchDetails.view), -1, NULL,
+    gtk_cell_renderer_text_new(), "text", 0, NULL);
+
+  scrolled = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled),
+                                 GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_scrolled_window_set_shadow_type(GTK_SCROLLED_WINDOW(scrolled),
+                                      GTK_SHADOW_IN);
+  gtk_widget_set_size_request(scrolled, -1, DEFAULT_HEIGHT / 2);
+  gtk_container_add(GTK_CONTAINER(scrolled), searchDetails.view);
+  gtk_box_pack_start(GTK_BOX(contentArea), scrolled, TRUE, TRUE, 0);
+
+  g_signal_connect(G_OBJECT(entry), "changed", G_CALLBACK(searchChanged),
+                   (gpointer)&searchDetails);
+  g_signal_connect(G_OBJECT(searchDetails.view), "row-activated",
+                   G_CALLBACK(searchRowActivated), (gpointer)dialog);
+
+  /* Setting the text fires "changed", which fills in the first rows. */
+  gtk_entry_set_text(GTK_ENTRY(entry), input);
+
+  if (input[0] == '\0') {
+    searchChanged(entry, (gpointer)&searchDetails);
+  }
+
+  gtk_widget_show_all(dialog);
+  response = (GTK_RESPONSE_OK == gtk_dialog_run(GTK_DIALOG(dialog)));
+  *selected = -1;
+
+  if (response) {
+    strncpy(input, gtk_entry_get_text(GTK_ENTRY(entry)),
+            properties->maxLength);
+
+    if (gtk_tree_selection_get_selected(
+          gtk_tree_view_get_selection(GTK_TREE_VIEW(searchDetails.view)),
+          NULL, &iter)) {
+      path = gtk_tree_model_get_path(GTK_TREE_MODEL(searchDetails.store),
+                                     &iter);
+      *selected = gtk_tree_path_get_indices(path)[0];
+      gtk_tree_path_free(path);
+    }
+  }
+
+  gtk_widget_destroy(dialog);
+  g_object_unref(searchDetails.store);
+  free(searchDetails.rows);
+  return response;
+}
+
 /**
  * Displays a simple message box window, with a message and a "Close" button.
  */
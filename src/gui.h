@@ -117,6 +117,37 @@ int dialogBox(Window *window, char *dialogTitle, int nInputs,
               InputProperties *properties, char **inputs);
 
 
+/**
+ * Displays a dialog box with one input space, like dialogBox, and a list of
+ * rows under it that is filled in again every time the input changes. The
+ * parameters are as follows:
+ *
+ * window      -- as returned by createWindow.
+ * dialogTitle -- the title of the dialog box.
+ * properties  -- the input space, isMultiLine is ignored.
+ * input       -- as for dialogBox, the initial value and where the final one
+ *                is copied to.
+ * search      -- called with the text in the input space when the dialog box
+ *                opens and whenever the text changes. It must point up to
+ *                maxRows elements of rows at strings to show, and return how
+ *                many it set. The strings must last until the next call. It
+ *                can set pick to a row to select for the user, it's -1 (no
+ *                row selected) otherwise.
+ * data        -- passed to search.
+ * maxRows     -- the most rows search can set.
+ * selected    -- set to the row that was selected, by the user or by search,
+ *                or -1 if none was.
+ *
+ * Pressing Enter or double clicking a row is the same as pressing "Ok".
+ * Returns TRUE for "Ok" or FALSE otherwise, like dialogBox.
+ */
+int searchBox(Window *window, char *dialogTitle, InputProperties *properties,
+              char *input,
+              int (*search)(const char *text, char **rows, int maxRows,
+                            int *pick, void *data),
+              void *data, int maxRows, int *selected);
+
+
 /**
  * Displays a simple message box window, with a message and a "Close" button.
  */
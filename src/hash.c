@@ -0,0 +1,40 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * FNV-1a string hashing.
+ */
+
+#include "hash.h"
+
+/*
+ * FNV-1a hash constants, 32 bit.
+ */
+#define HASH_OFFSET 2166136261UL
+#define HASH_PRIME 16777619UL
+#define HASH_MASK 0xffffffffUL
+
+unsigned long hashString(const char *text, size_t length)
+{
+  unsigned long hash;
+  size_t i;
+
+  hash = HASH_OFFSET;
+
+  for (i = 0; i < length; i++) {
+    hash = hashAdd(hash, (unsigned char) text[i]);
+  }
+
+  return hash;
+}
+
+unsigned long hashAdd(unsigned long hash, unsigned long value)
+{
+  return ((hash ^ value) * HASH_PRIME) & HASH_MASK;
+}
+
+Boolean hashTableFull(int count, int bucket_count)
+{
+  return (count * 4 >= bucket_count * 3);
+}
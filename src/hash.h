@@ -0,0 +1,37 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * String hashing for the hash tables.
+ *
+ * It's 32 bit FNV-1a, kept to 32 bits even where long is bigger so a
+ * string hashes the same everywhere. A hash can be carried on with
+ * more values after the string, like the field of a text term.
+ */
+
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <stddef.h>
+
+#include "bool.h"
+
+/*
+ * Hash of the first length characters of text, which doesn't need to
+ * be terminated.
+ */
+unsigned long hashString(const char *text, size_t length);
+
+/*
+ * Carry the hash on with one more value.
+ */
+unsigned long hashAdd(unsigned long hash, unsigned long value);
+
+/*
+ * TRUE if a chained table with count entries in bucket_count chains
+ * should double its chains, which is at 3 entries for every 4 chains.
+ */
+Boolean hashTableFull(int count, int bucket_count);
+
+#endif
@@ -0,0 +1,495 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Command line tools.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "calendar_file.h"
+#include "date_time.h"
+#include "event_index.h"
+#include "event_list.h"
+#include "event_schedule.h"
+#include "event_stats.h"
+#include "event_text.h"
+#include "event_upcoming.h"
+#include "headless.h"
+
+/*
+ * Arguments before the ones for the command, the program and the
+ * command itself, then the calendar file.
+ */
+#define HEADLESS_COMMAND_ARG 1
+#define HEADLESS_FILE_ARG 2
+#define HEADLESS_FIRST_ARG 3
+
+/*
+ * A command line tool.
+ *
+ * name - What is given on the command line to run it.
+ * arg_count - Number of arguments after the calendar file.
+ * usage - The arguments, for the usage message.
+ * needs_index - TRUE if the command is faster with an index, building
+ *               one costs more than a single scan of the list.
+ * run - Does the work, given the loaded calendar, its index (or NULL
+ *       if it doesn't need one), and the arguments after the calendar
+ *       file.
+ */
+struct HeadlessCommand {
+  const char *name;
+  int arg_count;
+  const char *usage;
+  Boolean needs_index;
+  enum HeadlessResult (*run)(struct EventList *list,
+                             const struct EventIndex *index,
+                             char *args[]);
+};
+
+/*
+ * Forward declarations.
+ */
+static enum HeadlessResult runBusy(struct EventList *list,
+                                   const struct EventIndex *index,
+                                   char *args[]);
+static enum HeadlessResult runFree(struct EventList *list,
+                                   const struct EventIndex *index,
+                                   char *args[]);
+static enum HeadlessResult runSearch(struct EventList *list,
+                                     const struct EventIndex *index,
+                                     char *args[]);
+static enum HeadlessResult runStats(struct EventList *list,
+                                    const struct EventIndex *index,
+                                    char *args[]);
+static enum HeadlessResult runUpcoming(struct EventList *list,
+                                       const struct EventIndex *index,
+                                       char *args[]);
+static void printUsage(const char *program);
+static Boolean parseTimestamp(const char *const stDate,
+                              const char *const stTime,
+                              Timestamp *timestamp);
+static Boolean parseWindow(char *args[], Timestamp *window_start,
+                           Timestamp *window_end);
+static void printTimestamp(Timestamp timestamp);
+static void printEvent(const struct Event *event);
+static void printIntervals(const struct ScheduleIntervals *intervals);
+static int compareLocations(const void *first, const void *second);
+static Boolean printLocations(const struct EventStats *stats);
+
+static const struct HeadlessCommand commands[] = {
+  {"--busy", 4, "FROM_DATE FROM_TIME TO_DATE TO_TIME", TRUE, runBusy},
+  {"--free", 6, "FROM_DATE FROM_TIME TO_DATE TO_TIME LENGTH COUNT", TRUE,
+   runFree},
+  {"--search", 1, "QUERY", FALSE, runSearch},
+  {"--stats", 0, "", FALSE, runStats},
+  {"--upcoming", 3, "FROM_DATE FROM_TIME COUNT", FALSE, runUpcoming}
+};
+
+#define HEADLESS_COMMAND_COUNT \
+  ((int) (sizeof(commands) / sizeof(commands[0])))
+
+Boolean headlessRequested(int argc, char *argv[])
+{
+  return (argc > HEADLESS_COMMAND_ARG &&
+          strncmp(argv[HEADLESS_COMMAND_ARG], "--", 2) == 0);
+}
+
+/*
+ * Find the command, load the calendar and index it, then run it.
+ */
+enum HeadlessResult headlessRun(int argc, char *argv[])
+{
+  const struct HeadlessCommand *command;
+  struct EventList *list;
+  struct EventIndex *index;
+  enum FileError load_result;
+  enum HeadlessResult result;
+  int i;
+
+  command = NULL;
+
+  for (i = 0; i < HEADLESS_COMMAND_COUNT && command == NULL; i++) {
+    if (strcmp(argv[HEADLESS_COMMAND_ARG], commands[i].name) == 0) {
+      command = &commands[i];
+    }
+  }
+
+  if (command == NULL ||
+      argc != HEADLESS_FIRST_ARG + command->arg_count) {
+    printUsage(argv[0]);
+    result = HEADLESS_USAGE_ERROR;
+  } else {
+    list = eventListCreate();
+    load_result = loadCalendar(list, argv[HEADLESS_FILE_ARG]);
+
+    /* Check calendar_file.h for details on FILE_EOF. */
+    if (load_result != FILE_NO_ERROR && load_result != FILE_EOF) {
+      fprintf(stderr, "%s: %s\n", argv[HEADLESS_FILE_ARG],
+              calendarErrorString(load_result));
+      result = HEADLESS_FILE_ERROR;
+    } else {
+      index = NULL;
+
+      if (command->needs_index) {
+        index = eventIndexCreate(list);
+      }
+
+      if (index != NULL || !command->needs_index) {
+        result = command->run(list, index, argv + HEADLESS_FIRST_ARG);
+      } else {
+        result = HEADLESS_INTERNAL_ERROR;
+      }
+
+      eventIndexDestroy(index);
+    }
+
+    eventListDestroy(list);
+  }
+
+  return result;
+}
+
+/*
+ * Print the busy intervals in the window.
+ */
+static enum HeadlessResult runBusy(struct EventList *list,
+                                   const struct EventIndex *index,
+                                   char *args[])
+{
+  struct ScheduleIntervals busy;
+  Timestamp window_start, window_end;
+  enum HeadlessResult result;
+
+  result = HEADLESS_NO_ERROR;
+  scheduleIntervalsInit(&busy);
+
+  if (!parseWindow(args, &window_start, &window_end)) {
+    result = HEADLESS_USAGE_ERROR;
+  } else if (!scheduleBusy(list, index, window_start, window_end, &busy)) {
+    result = HEADLESS_INTERNAL_ERROR;
+  } else {
+    printIntervals(&busy);
+  }
+
+  scheduleIntervalsFree(&busy);
+
+  return result;
+}
+
+/*
+ * Print the first COUNT free slots of at least LENGTH minutes.
+ */
+static enum HeadlessResult runFree(struct EventList *list,
+                                   const struct EventIndex *index,
+                                   char *args[])
+{
+  struct ScheduleIntervals free_slots;
+  Timestamp window_start, window_end;
+  enum HeadlessResult result;
+  int length, max_slots;
+
+  result = HEADLESS_NO_ERROR;
+  scheduleIntervalsInit(&free_slots);
+
+  length = atoi(args[4]);
+  max_slots = atoi(args[5]);
+
+  if (length <= 0 || max_slots <= 0) {
+    fprintf(stderr, "LENGTH and COUNT must be more than 0.\n");
+    result = HEADLESS_USAGE_ERROR;
+  } else if (!parseWindow(args, &window_start, &window_end)) {
+    result = HEADLESS_USAGE_ERROR;
+  } else if (!scheduleFreeSlots(list, index, window_start, window_end,
+                                length, max_slots, &free_slots)) {
+    result = HEADLESS_INTERNAL_ERROR;
+  } else {
+    printIntervals(&free_slots);
+  }
+
+  scheduleIntervalsFree(&free_slots);
+
+  return result;
+}
+
+/*
+ * Print the events matching the query, one per line like --upcoming.
+ */
+static enum HeadlessResult runSearch(struct EventList *list,
+                                     const struct EventIndex *index,
+                                     char *args[])
+{
+  struct EventTextIndex *text_index;
+  struct Event **found;
+  enum HeadlessResult result;
+  int count, i;
+
+  (void) index;
+
+  result = HEADLESS_INTERNAL_ERROR;
+  text_index = eventTextCreate(list);
+
+  if (text_index != NULL) {
+    count = eventTextSearch(text_index, args[0], &found);
+
+    if (count >= 0) {
+      for (i = 0; i < count; i++) {
+        printEvent(found[i]);
+      }
+
+      free(found);
+      result = HEADLESS_NO_ERROR;
+    }
+
+    eventTextDestroy(text_index);
+  }
+
+  return result;
+}
+
+/*
+ * Print the minutes booked for each day, week, month and location
+ * that has anything booked, then the total.
+ */
+static enum HeadlessResult runStats(struct EventList *list,
+                                    const struct EventIndex *index,
+                                    char *args[])
+{
+  struct EventStats *stats;
+  struct Date date;
+  enum HeadlessResult result;
+  int i, week_year, week;
+
+  (void) index;
+  (void) args;
+
+  result = HEADLESS_NO_ERROR;
+  stats = eventStatsCreate(list);
+
+  if (stats == NULL) {
+    result = HEADLESS_INTERNAL_ERROR;
+  } else {
+    for (i = 0; i < stats->days.count; i++) {
+      if (stats->days.minutes[i] > 0) {
+        dateFromDays(stats->days.first + i, &date);
+        printf("day " FILE_DATE_FORMAT " %ld\n", date.year, date.month,
+               date.day, stats->days.minutes[i]);
+      }
+    }
+
+    for (i = 0; i < stats->weeks.count; i++) {
+      if (stats->weeks.minutes[i] > 0) {
+        dateFromDays((stats->weeks.first + i) * STATS_DAYS_IN_WEEK, &date);
+        dateIsoWeek(&date, &week_year, &week);
+        printf("week %04d-W%02d %ld\n", week_year, week,
+               stats->weeks.minutes[i]);
+      }
+    }
+
+    for (i = 0; i < stats->months.count; i++) {
+      if (stats->months.minutes[i] > 0) {
+        printf("month %04ld-%02ld %ld\n",
+               (stats->months.first + i) / STATS_MONTHS_IN_YEAR,
+               (stats->months.first + i) % STATS_MONTHS_IN_YEAR + 1,
+               stats->months.minutes[i]);
+      }
+    }
+
+    if (!printLocations(stats)) {
+      result = HEADLESS_INTERNAL_ERROR;
+    }
+
+    printf("total %ld\n", stats->total_minutes);
+  }
+
+  eventStatsDestroy(stats);
+
+  return result;
+}
+
+/*
+ * Print the next COUNT events from the time, like they are in the
+ * calendar file but on one line.
+ */
+static enum HeadlessResult runUpcoming(struct EventList *list,
+                                       const struct EventIndex *index,
+                                       char *args[])
+{
+  struct Event **upcoming;
+  Timestamp from;
+  enum HeadlessResult result;
+  int count, found, i;
+
+  result = HEADLESS_NO_ERROR;
+  upcoming = NULL;
+  count = atoi(args[2]);
+
+  if (count <= 0) {
+    fprintf(stderr, "COUNT must be more than 0.\n");
+    result = HEADLESS_USAGE_ERROR;
+  } else if (!parseTimestamp(args[0], args[1], &from)) {
+    fprintf(stderr, "Invalid time, dates are YYYY-MM-DD and times are"
+            " HH:MM.\n");
+    result = HEADLESS_USAGE_ERROR;
+  } else {
+    upcoming = (struct Event **) malloc(sizeof(struct Event *) * count);
+    found = -1;
+
+    if (upcoming != NULL) {
+      found = eventUpcoming(list, index, from, count, upcoming);
+    }
+
+    if (found < 0) {
+      result = HEADLESS_INTERNAL_ERROR;
+    }
+
+    for (i = 0; i < found; i++) {
+      printEvent(upcoming[i]);
+    }
+  }
+
+  free(upcoming);
+
+  return result;
+}
+
+static void printUsage(const char *program)
+{
+  int i;
+
+  fprintf(stderr, "Usage:\n");
+
+  for (i = 0; i < HEADLESS_COMMAND_COUNT; i++) {
+    fprintf(stderr, "  %s %s CALENDAR %s\n", program, commands[i].name,
+            commands[i].usage);
+  }
+}
+
+static Boolean parseTimestamp(const char *const stDate,
+                              const char *const stTime,
+                              Timestamp *timestamp)
+{
+  struct Date date;
+  struct Time time;
+  Boolean result;
+
+  result = FALSE;
+
+  if (dateParse(stDate, &date) == DATETIME_NO_ERROR &&
+      timeParse(stTime, &time) == DATETIME_NO_ERROR) {
+    *timestamp = timestampFromDateTime(&date, &time);
+    result = TRUE;
+  }
+
+  return result;
+}
+
+/*
+ * The window is the first four arguments of the command.
+ */
+static Boolean parseWindow(char *args[], Timestamp *window_start,
+                           Timestamp *window_end)
+{
+  Boolean result;
+
+  result = (parseTimestamp(args[0], args[1], window_start) &&
+            parseTimestamp(args[2], args[3], window_end) &&
+            *window_start < *window_end);
+
+  if (!result) {
+    fprintf(stderr, "Invalid window, dates are YYYY-MM-DD and times are"
+            " HH:MM, and it must end after it starts.\n");
+  }
+
+  return result;
+}
+
+static void printTimestamp(Timestamp timestamp)
+{
+  struct Date date;
+  struct Time time;
+
+  timestampToDateTime(timestamp, &date, &time);
+  printf(FILE_DATE_FORMAT " " FILE_TIME_FORMAT, date.year, date.month,
+         date.day, time.hour, time.minutes);
+}
+
+/*
+ * Start, duration, name and location if it has one, on a line.
+ */
+static void printEvent(const struct Event *event)
+{
+  printTimestamp(event->timestamp);
+  printf(" %d %s", event->duration, event->name);
+
+  if (event->location != NULL) {
+    printf(" @ %s", eventLocation(event));
+  }
+
+  printf("\n");
+}
+
+/*
+ * One interval per line, start then end.
+ */
+static void printIntervals(const struct ScheduleIntervals *intervals)
+{
+  int i;
+
+  for (i = 0; i < intervals->count; i++) {
+    printTimestamp(intervals->intervals[i].start);
+    printf(" ");
+    printTimestamp(intervals->intervals[i].end);
+    printf("\n");
+  }
+}
+
+static int compareLocations(const void *first, const void *second)
+{
+  return strcmp((*(struct StatsLocation *const *) first)->location,
+                (*(struct StatsLocation *const *) second)->location);
+}
+
+/*
+ * Locations in name order, the hash table has them in no order.
+ */
+static Boolean printLocations(const struct EventStats *stats)
+{
+  struct StatsLocation **sorted;
+  struct StatsLocation *current_location;
+  Boolean result;
+  int count, i;
+
+  result = TRUE;
+
+  /* +1 so no locations doesn't look like a memory error. */
+  sorted = (struct StatsLocation **)
+           malloc(sizeof(struct StatsLocation *) *
+                  (stats->location_count + 1));
+
+  if (sorted != NULL) {
+    count = 0;
+
+    for (i = 0; i < stats->location_buckets; i++) {
+      for (current_location = stats->locations[i]; current_location != NULL;
+           current_location = current_location->next) {
+        sorted[count++] = current_location;
+      }
+    }
+
+    qsort(sorted, count, sizeof(struct StatsLocation *), compareLocations);
+
+    for (i = 0; i < count; i++) {
+      printf("location %s %ld\n", sorted[i]->location, sorted[i]->minutes);
+    }
+
+    free(sorted);
+  } else {
+    result = FALSE;
+  }
+
+  return result;
+}
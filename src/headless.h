@@ -0,0 +1,48 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Command line tools that work on a calendar file without the GUI.
+ *
+ * These are run by giving a command as the first argument, the
+ * calendar file as the second, then whatever the command needs:
+ *
+ *   ucp-assignment --busy calendar.txt 2013-05-01 09:00 2013-05-01 17:00
+ *   ucp-assignment --free calendar.txt 2013-05-01 09:00 2013-05-01 17:00 30 3
+ *   ucp-assignment --search calendar.txt "team lunch OR meet*"
+ *   ucp-assignment --stats calendar.txt
+ *   ucp-assignment --upcoming calendar.txt 2013-05-01 09:00 5
+ *
+ * Results are written to stdout one per line, errors to stderr.
+ */
+
+#ifndef HEADLESS_H_
+#define HEADLESS_H_
+
+#include "bool.h"
+
+/*
+ * Exit codes of the command line tools.
+ */
+enum HeadlessResult {
+  HEADLESS_NO_ERROR,
+  HEADLESS_USAGE_ERROR, /* Unknown command or bad arguments. */
+  HEADLESS_FILE_ERROR, /* Couldn't load the calendar. */
+  HEADLESS_INTERNAL_ERROR /* Generally a memory allocation fault. */
+};
+
+/*
+ * Returns TRUE if the arguments are asking for a command line tool
+ * rather than the GUI, that is the first one starts with "--".
+ */
+Boolean headlessRequested(int argc, char *argv[]);
+
+/*
+ * Run the command line tool asked for.
+ *
+ * Returns the exit code for the program.
+ */
+enum HeadlessResult headlessRun(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Counters, timers and writing them out.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "instrument.h"
+#include "monotonic.h"
+
+/*
+ * A group of numbers in the JSON, a timer and the counters that go
+ * with it.
+ *
+ * name - Key of the group.
+ * timer - Timer for the group.
+ * counters/counter_names - Counters in the group, and their keys.
+ * parse_timer - TRUE to include INSTRUMENT_PARSE as "parse_ns".
+ */
+struct InstrumentGroup {
+  const char *name;
+  enum InstrumentTimer timer;
+  int counter_count;
+  enum InstrumentCounter counters[3];
+  const char *counter_names[3];
+  Boolean parse_timer;
+};
+
+static const struct InstrumentGroup groups[] = {
+  {"load", INSTRUMENT_LOAD, 3,
+   {INSTRUMENT_LOAD_BYTES, INSTRUMENT_LOAD_RECORDS, INSTRUMENT_LOAD_MALLOCS},
+   {"bytes", "records", "mallocs"}, TRUE},
+  {"render", INSTRUMENT_RENDER, 1,
+   {INSTRUMENT_RENDER_BYTES}, {"bytes"}, FALSE},
+  {"find", INSTRUMENT_FIND, 1,
+   {INSTRUMENT_FIND_PROBES}, {"probes"}, FALSE},
+  {"save", INSTRUMENT_SAVE, 2,
+   {INSTRUMENT_SAVE_BYTES, INSTRUMENT_SAVE_SYSCALLS}, {"bytes", "syscalls"},
+   FALSE}
+};
+
+#define INSTRUMENT_GROUP_COUNT \
+  ((int) (sizeof(groups) / sizeof(groups[0])))
+
+static long long counters[INSTRUMENT_COUNTER_COUNT];
+static struct InstrumentTiming timings[INSTRUMENT_TIMER_COUNT];
+
+void instrumentCount(enum InstrumentCounter counter, long long amount)
+{
+  counters[counter] += amount;
+}
+
+void *instrumentMalloc(size_t size)
+{
+  void *result;
+
+  result = malloc(size);
+
+  if (result != NULL) {
+    counters[INSTRUMENT_MALLOCS]++;
+  }
+
+  return result;
+}
+
+void *instrumentCalloc(size_t count, size_t size)
+{
+  void *result;
+
+  result = calloc(count, size);
+
+  if (result != NULL) {
+    counters[INSTRUMENT_MALLOCS]++;
+  }
+
+  return result;
+}
+
+void *instrumentRealloc(void *block, size_t size)
+{
+  void *result;
+
+  result = realloc(block, size);
+
+  if (result != NULL) {
+    counters[INSTRUMENT_MALLOCS]++;
+  }
+
+  return result;
+}
+
+long long instrumentValue(enum InstrumentCounter counter)
+{
+  return counters[counter];
+}
+
+void instrumentStart(enum InstrumentTimer timer)
+{
+  timings[timer].started = monotonicNow();
+}
+
+void instrumentStop(enum InstrumentTimer timer)
+{
+  long long elapsed;
+
+  elapsed = monotonicNow() - timings[timer].started;
+
+  timings[timer].calls++;
+  timings[timer].total += elapsed;
+
+  if (elapsed > timings[timer].longest) {
+    timings[timer].longest = elapsed;
+  }
+}
+
+const struct InstrumentTiming *instrumentTiming(enum InstrumentTimer timer)
+{
+  return &timings[timer];
+}
+
+void instrumentReset()
+{
+  memset(counters, 0, sizeof(counters));
+  memset(timings, 0, sizeof(timings));
+}
+
+/*
+ * One line per group, so it's easy to diff too.
+ */
+Boolean instrumentDumpJson(FILE *output)
+{
+  const struct InstrumentGroup *group;
+  const struct InstrumentTiming *timing;
+  int i, j;
+
+  fprintf(output, "{\n");
+
+  for (i = 0; i < INSTRUMENT_GROUP_COUNT; i++) {
+    group = &groups[i];
+    timing = &timings[group->timer];
+
+    fprintf(output, "  \"%s\": {\"calls\": %lu, \"ns\": %lld, "
+            "\"max_ns\": %lld", group->name, timing->calls, timing->total,
+            timing->longest);
+
+    for (j = 0; j < group->counter_count; j++) {
+      fprintf(output, ", \"%s\": %lld", group->counter_names[j],
+              counters[group->counters[j]]);
+    }
+
+    if (group->parse_timer) {
+      fprintf(output, ", \"parse_ns\": %lld",
+              timings[INSTRUMENT_PARSE].total);
+    }
+
+    fprintf(output, "},\n");
+  }
+
+  fprintf(output, "  \"mallocs\": %lld\n}\n", counters[INSTRUMENT_MALLOCS]);
+
+  return (ferror(output) == 0);
+}
+
+void instrumentDumpRequested()
+{
+  const char *filename;
+  FILE *output;
+
+  filename = getenv(INSTRUMENT_ENV);
+
+  if (filename != NULL && filename[0] != '\0') {
+    if (strcmp(filename, "-") == 0) {
+      instrumentDumpJson(stderr);
+    } else {
+      output = fopen(filename, "w");
+
+      if (output != NULL) {
+        instrumentDumpJson(output);
+        fclose(output);
+      } else {
+        fprintf(stderr, "Couldn't write instrumentation to %s.\n", filename);
+      }
+    }
+  }
+}
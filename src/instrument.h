@@ -0,0 +1,165 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Counters and timers for the expensive operations.
+ *
+ * Loading, rendering the calendar text, finding an event and saving
+ * all count what they did and how long it took, so changes that make
+ * them slower show up. Everything is used through the macros below,
+ * which are only compiled in when INSTRUMENT is defined (it is by
+ * default, see the Makefile). Without it they compile to nothing and
+ * this module isn't needed at all.
+ *
+ * If the environment variable named by INSTRUMENT_ENV is set when the
+ * program finishes, everything is written there as JSON. "-" means
+ * standard error. This works the same for the GUI and the command
+ * line tools.
+ *
+ * The counts are plain globals, they should only be changed from one
+ * thread (the one using the EventList, not SharedEventList readers).
+ */
+
+#ifndef INSTRUMENT_H_
+#define INSTRUMENT_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bool.h"
+
+/*
+ * Environment variable with the file to write the JSON to.
+ */
+#define INSTRUMENT_ENV "CALENDAR_INSTRUMENT"
+
+/*
+ * Things that are counted.
+ *
+ * INSTRUMENT_MALLOCS - Every successful malloc, calloc or realloc made
+ *                      for events, their strings, locations, pool
+ *                      slabs, the list's id map, the load buffers and
+ *                      the calendar text. They're all made through
+ *                      INSTRUMENT_MALLOC and friends.
+ * INSTRUMENT_LOAD_BYTES - Bytes of calendar files read.
+ * INSTRUMENT_LOAD_RECORDS - Events loaded.
+ * INSTRUMENT_LOAD_MALLOCS - The INSTRUMENT_MALLOCS made while loading.
+ * INSTRUMENT_RENDER_BYTES - Bytes of calendar text made.
+ * INSTRUMENT_FIND_PROBES - Events compared when finding by name.
+ * INSTRUMENT_SAVE_BYTES - Bytes of calendar files written.
+ * INSTRUMENT_SAVE_SYSCALLS - Opens, writes and closes for saving.
+ */
+enum InstrumentCounter {
+  INSTRUMENT_MALLOCS,
+  INSTRUMENT_LOAD_BYTES,
+  INSTRUMENT_LOAD_RECORDS,
+  INSTRUMENT_LOAD_MALLOCS,
+  INSTRUMENT_RENDER_BYTES,
+  INSTRUMENT_FIND_PROBES,
+  INSTRUMENT_SAVE_BYTES,
+  INSTRUMENT_SAVE_SYSCALLS,
+  INSTRUMENT_COUNTER_COUNT
+};
+
+/*
+ * Things that are timed. INSTRUMENT_PARSE is the part of loading
+ * spent checking the fields and making the events.
+ */
+enum InstrumentTimer {
+  INSTRUMENT_LOAD,
+  INSTRUMENT_PARSE,
+  INSTRUMENT_RENDER,
+  INSTRUMENT_FIND,
+  INSTRUMENT_SAVE,
+  INSTRUMENT_TIMER_COUNT
+};
+
+/*
+ * Totals for a timer, times are in nanoseconds.
+ *
+ * calls - Number of times it was started and stopped.
+ * total - Time for all of them added up.
+ * longest - Time of the longest one.
+ * started - When the current one was started.
+ */
+struct InstrumentTiming {
+  unsigned long calls;
+  long long total;
+  long long longest;
+  long long started;
+};
+
+#ifdef INSTRUMENT
+
+#define INSTRUMENT_COUNT(counter, amount) \
+  instrumentCount((counter), (long long) (amount))
+#define INSTRUMENT_VALUE(counter) instrumentValue(counter)
+#define INSTRUMENT_START(timer) instrumentStart(timer)
+#define INSTRUMENT_STOP(timer) instrumentStop(timer)
+#define INSTRUMENT_DUMP() instrumentDumpRequested()
+#define INSTRUMENT_MALLOC(size) instrumentMalloc(size)
+#define INSTRUMENT_CALLOC(count, size) instrumentCalloc((count), (size))
+#define INSTRUMENT_REALLOC(block, size) instrumentRealloc((block), (size))
+
+#else
+
+#define INSTRUMENT_COUNT(counter, amount) ((void) 0)
+#define INSTRUMENT_VALUE(counter) 0
+#define INSTRUMENT_START(timer) ((void) 0)
+#define INSTRUMENT_STOP(timer) ((void) 0)
+#define INSTRUMENT_DUMP() ((void) 0)
+#define INSTRUMENT_MALLOC(size) malloc(size)
+#define INSTRUMENT_CALLOC(count, size) calloc((count), (size))
+#define INSTRUMENT_REALLOC(block, size) realloc((block), (size))
+
+#endif
+
+/*
+ * Add to a counter.
+ */
+void instrumentCount(enum InstrumentCounter counter, long long amount);
+
+/*
+ * malloc, calloc and realloc, adding one to INSTRUMENT_MALLOCS if they
+ * worked.
+ */
+void *instrumentMalloc(size_t size);
+void *instrumentCalloc(size_t count, size_t size);
+void *instrumentRealloc(void *block, size_t size);
+
+/*
+ * Current value of a counter.
+ */
+long long instrumentValue(enum InstrumentCounter counter);
+
+/*
+ * Start and stop a timer. A timer can't be started again before it's
+ * stopped, different timers can run at the same time.
+ */
+void instrumentStart(enum InstrumentTimer timer);
+void instrumentStop(enum InstrumentTimer timer);
+
+/*
+ * Totals for a timer so far.
+ */
+const struct InstrumentTiming *instrumentTiming(enum InstrumentTimer timer);
+
+/*
+ * Set all counters and timers back to 0.
+ */
+void instrumentReset();
+
+/*
+ * Write everything as a single JSON object.
+ *
+ * Returns FALSE if there was a write error.
+ */
+Boolean instrumentDumpJson(FILE *output);
+
+/*
+ * Write the JSON to where INSTRUMENT_ENV says, if it's set.
+ */
+void instrumentDumpRequested();
+
+#endif
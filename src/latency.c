@@ -0,0 +1,247 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Latency histograms for the GUI actions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "latency.h"
+#include "monotonic.h"
+
+#define MICROSECONDS_IN_MILLISECOND 1000.0
+
+/*
+ * Longest the report can be, a header and a line for each action.
+ */
+#define LATENCY_REPORT_SIZE 1024
+
+/*
+ * Largest value that gets its own bucket.
+ */
+#define LATENCY_HIGHEST ((1LL << LATENCY_MAX_POWER) - 1)
+
+static const char *action_names[LATENCY_ACTION_COUNT] = {
+  "Load", "Save", "Add", "Edit", "Delete"
+};
+
+/*
+ * histograms - One for each action.
+ * started - When each action was started, -1 if it isn't running.
+ */
+static struct LatencyHistogram histograms[LATENCY_ACTION_COUNT];
+static long long started[LATENCY_ACTION_COUNT] = {-1, -1, -1, -1, -1};
+
+/*
+ * Forward declarations.
+ */
+static int bucketOf(long long value);
+static long long bucketTop(int bucket);
+
+void latencyHistogramReset(struct LatencyHistogram *histogram)
+{
+  memset(histogram, 0, sizeof(struct LatencyHistogram));
+}
+
+void latencyHistogramRecord(struct LatencyHistogram *histogram,
+                            long long value)
+{
+  if (value < 0) {
+    value = 0;
+  }
+
+  histogram->counts[bucketOf(value)]++;
+  histogram->total++;
+
+  if (value > histogram->max) {
+    histogram->max = value;
+  }
+}
+
+/*
+ * Find the bucket the value at that rank falls in, counting up from
+ * the smallest.
+ */
+long long latencyHistogramPercentile(const struct LatencyHistogram *histogram,
+                                     double percent)
+{
+  unsigned long rank, seen;
+  long long result;
+  int bucket;
+
+  result = 0;
+
+  if (histogram->total > 0) {
+    rank = (unsigned long) (percent / 100.0 * histogram->total + 0.5);
+
+    if (rank < 1) {
+      rank = 1;
+    } else if (rank > histogram->total) {
+      rank = histogram->total;
+    }
+
+    seen = 0;
+    bucket = 0;
+
+    while (seen + histogram->counts[bucket] < rank) {
+      seen += histogram->counts[bucket];
+      bucket++;
+    }
+
+    result = bucketTop(bucket);
+
+    if (result > histogram->max) {
+      result = histogram->max;
+    }
+  }
+
+  return result;
+}
+
+void latencyStart(enum LatencyAction action)
+{
+  started[action] = monotonicNow() / NANOSECONDS_IN_MICROSECOND;
+}
+
+void latencyStop(enum LatencyAction action)
+{
+  if (started[action] >= 0) {
+    latencyHistogramRecord(&histograms[action],
+                           monotonicNow() / NANOSECONDS_IN_MICROSECOND -
+                           started[action]);
+    started[action] = -1;
+  }
+}
+
+const struct LatencyHistogram *latencyHistogram(enum LatencyAction action)
+{
+  return &histograms[action];
+}
+
+void latencyReset()
+{
+  int i;
+
+  for (i = 0; i < LATENCY_ACTION_COUNT; i++) {
+    latencyHistogramReset(&histograms[i]);
+    started[i] = -1;
+  }
+}
+
+/*
+ * Times are shown in milliseconds, that's what the targets are in.
+ */
+char *latencyReport(int event_count)
+{
+  const struct LatencyHistogram *histogram;
+  char *result;
+  int length, i;
+
+  result = (char *) malloc(LATENCY_REPORT_SIZE);
+
+  if (result != NULL) {
+    length = sprintf(result, "Calendar: %d events\n"
+                     "%-8s %6s %9s %9s %9s %9s\n", event_count,
+                     "Action", "Count", "p50 ms", "p90 ms", "p99 ms",
+                     "max ms");
+
+    for (i = 0; i < LATENCY_ACTION_COUNT; i++) {
+      histogram = &histograms[i];
+
+      length += sprintf(result + length,
+                        "%-8s %6lu %9.3f %9.3f %9.3f %9.3f\n",
+                        action_names[i], histogram->total,
+                        latencyHistogramPercentile(histogram, 50.0) /
+                        MICROSECONDS_IN_MILLISECOND,
+                        latencyHistogramPercentile(histogram, 90.0) /
+                        MICROSECONDS_IN_MILLISECOND,
+                        latencyHistogramPercentile(histogram, 99.0) /
+                        MICROSECONDS_IN_MILLISECOND,
+                        histogram->max / MICROSECONDS_IN_MILLISECOND);
+    }
+  }
+
+  return result;
+}
+
+void latencyReportRequested(int event_count)
+{
+  const char *filename;
+  char *report;
+  FILE *output;
+
+  filename = getenv(LATENCY_ENV);
+
+  if (filename != NULL && filename[0] != '\0') {
+    report = latencyReport(event_count);
+
+    if (report != NULL) {
+      if (strcmp(filename, "-") == 0) {
+        fputs(report, stderr);
+      } else {
+        output = fopen(filename, "w");
+
+        if (output != NULL) {
+          fputs(report, output);
+          fclose(output);
+        } else {
+          fprintf(stderr, "Couldn't write latencies to %s.\n", filename);
+        }
+      }
+
+      free(report);
+    }
+  }
+}
+
+/*
+ * Values under LATENCY_SUB_BUCKETS get a bucket each. Bigger ones are
+ * grouped by their highest bit, and split by the LATENCY_SUB_BUCKET_BITS
+ * bits under it.
+ */
+static int bucketOf(long long value)
+{
+  int shift, result;
+
+  if (value > LATENCY_HIGHEST) {
+    value = LATENCY_HIGHEST;
+  }
+
+  if (value < LATENCY_SUB_BUCKETS) {
+    result = (int) value;
+  } else {
+    shift = 0;
+
+    while ((value >> shift) >= 2 * LATENCY_SUB_BUCKETS) {
+      shift++;
+    }
+
+    result = (shift + 1) * LATENCY_SUB_BUCKETS +
+             (int) (value >> shift) - LATENCY_SUB_BUCKETS;
+  }
+
+  return result;
+}
+
+/*
+ * Largest value that goes in a bucket.
+ */
+static long long bucketTop(int bucket)
+{
+  long long result;
+  int shift;
+
+  if (bucket < LATENCY_SUB_BUCKETS) {
+    result = bucket;
+  } else {
+    shift = bucket / LATENCY_SUB_BUCKETS - 1;
+    result = ((long long) (bucket % LATENCY_SUB_BUCKETS +
+                           LATENCY_SUB_BUCKETS + 1) << shift) - 1;
+  }
+
+  return result;
+}
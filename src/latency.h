@@ -0,0 +1,118 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * How long the user waits for each GUI action.
+ *
+ * Every Load, Save, Add, Edit and Delete is timed from the user
+ * confirming its last dialog to the calendar being shown again, so
+ * time spent typing isn't counted, and recorded in a histogram for
+ * that action. The report gives the 50th, 90th and 99th percentiles
+ * and the slowest for each, along with the calendar size, and can be
+ * shown at any time or written out when the program finishes if the
+ * environment variable named by LATENCY_ENV is set ("-" for standard
+ * error).
+ *
+ * The histograms are log bucketed like HdrHistogram: each power of
+ * two is split into LATENCY_SUB_BUCKETS, so a percentile is never
+ * off by more than 1 / LATENCY_SUB_BUCKETS of its value, for any
+ * value, in a fixed amount of memory.
+ *
+ * The actions are plain globals, only use them from the GUI thread.
+ */
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include "bool.h"
+
+/*
+ * Environment variable with the file to write the report to.
+ */
+#define LATENCY_ENV "CALENDAR_LATENCY"
+
+/*
+ * Values are in microseconds, anything from 2^LATENCY_MAX_POWER (about
+ * 12 days) is counted as that.
+ */
+#define LATENCY_SUB_BUCKET_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_MAX_POWER 40
+#define LATENCY_BUCKETS \
+  ((LATENCY_MAX_POWER - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+/*
+ * counts - Number of values in each bucket.
+ * total - Number of values.
+ * max - Largest value, exactly.
+ */
+struct LatencyHistogram {
+  unsigned long counts[LATENCY_BUCKETS];
+  unsigned long total;
+  long long max;
+};
+
+/*
+ * The actions that are timed.
+ */
+enum LatencyAction {
+  LATENCY_LOAD,
+  LATENCY_SAVE,
+  LATENCY_ADD,
+  LATENCY_EDIT,
+  LATENCY_DELETE,
+  LATENCY_ACTION_COUNT
+};
+
+/*
+ * Empty a histogram.
+ */
+void latencyHistogramReset(struct LatencyHistogram *histogram);
+
+/*
+ * Add a value, negative ones are counted as 0.
+ */
+void latencyHistogramRecord(struct LatencyHistogram *histogram,
+                            long long value);
+
+/*
+ * The value that percent of the values are at or below, rounded up
+ * to the top of its bucket but never over the max. 0 if the histogram
+ * is empty.
+ */
+long long latencyHistogramPercentile(const struct LatencyHistogram *histogram,
+                                     double percent);
+
+/*
+ * Start and stop timing an action. Stopping an action that wasn't
+ * started does nothing, so an action the user cancelled can just not
+ * be started.
+ */
+void latencyStart(enum LatencyAction action);
+void latencyStop(enum LatencyAction action);
+
+/*
+ * Histogram for an action so far.
+ */
+const struct LatencyHistogram *latencyHistogram(enum LatencyAction action);
+
+/*
+ * Empty all the actions' histograms.
+ */
+void latencyReset();
+
+/*
+ * A table of the percentiles for every action, with the number of
+ * events in the calendar. The caller frees it using free().
+ *
+ * Returns NULL if there was a memory error.
+ */
+char *latencyReport(int event_count);
+
+/*
+ * Write the report to where LATENCY_ENV says, if it's set.
+ */
+void latencyReportRequested(int event_count);
+
+#endif
@@ -0,0 +1,285 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Reference counted, interned location strings.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hash.h"
+#include "instrument.h"
+#include "location_table.h"
+
+/*
+ * Starting number of chains in a table, it doubles when hashTableFull
+ * says so.
+ */
+#define LOCATION_BUCKETS 16
+
+/*
+ * Forward declarations.
+ */
+static struct LocationEntry *entryCreate(const char *const name,
+                                         size_t name_length,
+                                         unsigned long hash);
+static Boolean nameIsInline(const struct LocationEntry *entry);
+static void tableAdd(struct LocationTable *table,
+                     struct LocationEntry *entry);
+static void tableGrow(struct LocationTable *table);
+
+struct LocationTable *locationTableCreate()
+{
+  struct LocationTable *table;
+
+  table = (struct LocationTable *)
+          INSTRUMENT_MALLOC(sizeof(struct LocationTable));
+
+  if (table != NULL) {
+    table->bucket_count = LOCATION_BUCKETS;
+    table->count = 0;
+    table->buckets = (struct LocationEntry **)
+                     INSTRUMENT_CALLOC(LOCATION_BUCKETS,
+                                       sizeof(struct LocationEntry *));
+
+    if (table->buckets == NULL) {
+      free(table);
+      table = NULL;
+    }
+  }
+
+  return table;
+}
+
+void locationTableDestroy(struct LocationTable *table)
+{
+  struct LocationEntry *current_entry, *next_entry;
+  int i;
+
+  if (table != NULL) {
+    for (i = 0; i < table->bucket_count; i++) {
+      current_entry = table->buckets[i];
+
+      while (current_entry != NULL) {
+        next_entry = current_entry->next;
+        current_entry->table = NULL;
+        current_entry->next = NULL;
+        current_entry = next_entry;
+      }
+    }
+
+    free(table->buckets);
+    free(table);
+  }
+}
+
+struct LocationEntry *locationCreate(const char *const name,
+                                     size_t name_length)
+{
+  return entryCreate(name, name_length, hashString(name, name_length));
+}
+
+struct LocationEntry *locationIntern(struct LocationTable *table,
+                                     const char *const name)
+{
+  struct LocationEntry *entry;
+  unsigned long hash;
+  size_t name_length;
+
+  name_length = strlen(name);
+  hash = hashString(name, name_length);
+  entry = table->buckets[hash % table->bucket_count];
+
+  while (entry != NULL &&
+         (entry->hash != hash || strcmp(entry->name, name) != 0)) {
+    entry = entry->next;
+  }
+
+  if (entry != NULL) {
+    entry->ref_count++;
+  } else {
+    entry = entryCreate(name, name_length, hash);
+
+    if (entry != NULL) {
+      tableAdd(table, entry);
+    }
+  }
+
+  return entry;
+}
+
+struct LocationEntry *locationFind(const struct LocationTable *table,
+                                   const char *const name)
+{
+  struct LocationEntry *entry;
+  unsigned long hash;
+
+  hash = hashString(name, strlen(name));
+  entry = table->buckets[hash % table->bucket_count];
+
+  while (entry != NULL &&
+         (entry->hash != hash || strcmp(entry->name, name) != 0)) {
+    entry = entry->next;
+  }
+
+  return entry;
+}
+
+void locationAcquire(struct LocationEntry *entry)
+{
+  entry->ref_count++;
+}
+
+void locationRelease(struct LocationEntry *entry)
+{
+  if (entry != NULL) {
+    entry->ref_count--;
+
+    if (entry->ref_count == 0) {
+      locationDetach(entry);
+
+      if (!nameIsInline(entry)) {
+        free(entry->name);
+      }
+
+      free(entry);
+    }
+  }
+}
+
+/*
+ * Take it out of the table, change the name, and put it back in the
+ * chain for the new name.
+ */
+Boolean locationRename(struct LocationEntry *entry, const char *const name)
+{
+  struct LocationTable *table;
+  char *new_name;
+  Boolean result;
+
+  result = FALSE;
+  new_name = (char *) INSTRUMENT_MALLOC(strlen(name) + 1);
+
+  if (new_name != NULL) {
+    strcpy(new_name, name);
+    table = entry->table;
+    locationDetach(entry);
+
+    if (!nameIsInline(entry)) {
+      free(entry->name);
+    }
+
+    entry->name = new_name;
+    entry->hash = hashString(new_name, strlen(new_name));
+
+    if (table != NULL) {
+      tableAdd(table, entry);
+    }
+
+    result = TRUE;
+  }
+
+  return result;
+}
+
+void locationDetach(struct LocationEntry *entry)
+{
+  struct LocationEntry **link;
+
+  if (entry->table != NULL) {
+    link = &entry->table->buckets[entry->hash % entry->table->bucket_count];
+
+    while (*link != entry) {
+      link = &(*link)->next;
+    }
+
+    *link = entry->next;
+    entry->table->count--;
+    entry->table = NULL;
+    entry->next = NULL;
+  }
+}
+
+/*
+ * The entry and its name are one allocation, the name straight after
+ * the entry. Renamed entries have their name allocated separately.
+ */
+static struct LocationEntry *entryCreate(const char *const name,
+                                         size_t name_length,
+                                         unsigned long hash)
+{
+  struct LocationEntry *entry;
+
+  entry = (struct LocationEntry *)
+          INSTRUMENT_MALLOC(sizeof(struct LocationEntry) + name_length + 1);
+
+  if (entry != NULL) {
+    entry->name = (char *) (entry + 1);
+    memcpy(entry->name, name, name_length);
+    entry->name[name_length] = '\0';
+    entry->hash = hash;
+    entry->ref_count = 1;
+    entry->table = NULL;
+    entry->next = NULL;
+  }
+
+  return entry;
+}
+
+static Boolean nameIsInline(const struct LocationEntry *entry)
+{
+  return (entry->name == (const char *) (entry + 1));
+}
+
+static void tableAdd(struct LocationTable *table,
+                     struct LocationEntry *entry)
+{
+  unsigned long bucket;
+
+  if (hashTableFull(table->count, table->bucket_count)) {
+    tableGrow(table);
+  }
+
+  bucket = entry->hash % table->bucket_count;
+  entry->table = table;
+  entry->next = table->buckets[bucket];
+  table->buckets[bucket] = entry;
+  table->count++;
+}
+
+/*
+ * Double the chains, if there isn't memory for that the chains just
+ * get longer.
+ */
+static void tableGrow(struct LocationTable *table)
+{
+  struct LocationEntry **new_buckets;
+  struct LocationEntry *current_entry, *next_entry;
+  unsigned long bucket;
+  int new_count, i;
+
+  new_count = table->bucket_count * 2;
+  new_buckets = (struct LocationEntry **)
+                INSTRUMENT_CALLOC(new_count,
+                                  sizeof(struct LocationEntry *));
+
+  if (new_buckets != NULL) {
+    for (i = 0; i < table->bucket_count; i++) {
+      current_entry = table->buckets[i];
+
+      while (current_entry != NULL) {
+        next_entry = current_entry->next;
+        bucket = current_entry->hash % new_count;
+        current_entry->next = new_buckets[bucket];
+        new_buckets[bucket] = current_entry;
+        current_entry = next_entry;
+      }
+    }
+
+    free(table->buckets);
+    table->buckets = new_buckets;
+    table->bucket_count = new_count;
+  }
+}
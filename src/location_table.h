@@ -0,0 +1,130 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Shared location strings.
+ *
+ * Calendars use the same few locations over and over, so rather than
+ * every event having its own copy, events in a list share one
+ * LocationEntry per location from the list's LocationTable. Two
+ * events from the same table are at the same location if and only if
+ * they have the same entry.
+ *
+ * Entries are reference counted, each event holding one counts as a
+ * reference, and an entry is freed when the last one is released.
+ * Entries don't need their table to still be around, when a table is
+ * destroyed its entries are detached and live on until released.
+ *
+ * An event that isn't in a list has an entry of its own that isn't
+ * in any table.
+ *
+ * None of this is thread safe, tables and entries must only be
+ * changed by one thread (the writer for a SharedEventList).
+ */
+
+#ifndef LOCATION_TABLE_H_
+#define LOCATION_TABLE_H_
+
+#include <stddef.h>
+
+#include "bool.h"
+
+struct LocationTable;
+
+/*
+ * A location.
+ *
+ * name - The location string.
+ * hash - Hash of name, so the table doesn't have to work it out
+ *        again.
+ * ref_count - Number of events (or anything else) using this.
+ * table - Table this entry is in, NULL if it isn't in one.
+ * next - Next entry in the same chain of the table.
+ */
+struct LocationEntry {
+  char *name;
+  unsigned long hash;
+  int ref_count;
+  struct LocationTable *table;
+  struct LocationEntry *next;
+};
+
+/*
+ * Hash table of the entries.
+ *
+ * buckets - Chains of entries, bucket_count of them.
+ * count - Number of entries in the table.
+ */
+struct LocationTable {
+  struct LocationEntry **buckets;
+  int bucket_count;
+  int count;
+};
+
+/*
+ * Create an empty table, returns NULL if there was a memory error.
+ */
+struct LocationTable *locationTableCreate();
+
+/*
+ * Destroy the table. Entries still being used are detached from it,
+ * and freed when they are released.
+ */
+void locationTableDestroy(struct LocationTable *table);
+
+/*
+ * Create an entry that isn't in any table, with one reference.
+ *
+ * name - Location string, doesn't need to be terminated.
+ * name_length - Number of characters of name to use.
+ *
+ * Returns NULL if there was a memory error.
+ */
+struct LocationEntry *locationCreate(const char *const name,
+                                     size_t name_length);
+
+/*
+ * Get the table's entry for the location, adding it if it isn't
+ * there yet, and add a reference to it.
+ *
+ * Returns NULL if there was a memory error.
+ */
+struct LocationEntry *locationIntern(struct LocationTable *table,
+                                     const char *const name);
+
+/*
+ * Find the table's entry for the location without adding a
+ * reference. Returns NULL if no events are at that location.
+ */
+struct LocationEntry *locationFind(const struct LocationTable *table,
+                                   const char *const name);
+
+/*
+ * Add a reference to the entry.
+ */
+void locationAcquire(struct LocationEntry *entry);
+
+/*
+ * Release a reference to the entry, freeing it if it was the last.
+ * Nothing is done if entry is NULL.
+ */
+void locationRelease(struct LocationEntry *entry);
+
+/*
+ * Change the name of the entry, everything using it sees the new
+ * name. If the entry is in a table it must not already have an entry
+ * with the new name.
+ *
+ * Returns FALSE if there was a memory error, the entry isn't changed
+ * in that case.
+ */
+Boolean locationRename(struct LocationEntry *entry, const char *const name);
+
+/*
+ * Take the entry out of its table, so it can't be found or interned
+ * anymore. Anything using it still can.
+ */
+void locationDetach(struct LocationEntry *entry);
+
+#endif
@@ -0,0 +1,24 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Reading the monotonic clock.
+ */
+
+/* For clock_gettime. */
+#define _POSIX_C_SOURCE 199309L
+
+#include <time.h>
+
+#include "monotonic.h"
+
+long long monotonicNow(void)
+{
+  struct timespec current;
+
+  clock_gettime(CLOCK_MONOTONIC, &current);
+
+  return (long long) current.tv_sec * NANOSECONDS_IN_SECOND +
+         current.tv_nsec;
+}
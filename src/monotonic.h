@@ -0,0 +1,24 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * The time for measuring how long things take.
+ *
+ * It's from a monotonic clock, so it only ever goes forward, even if
+ * the system clock is changed. It means nothing on its own, only the
+ * difference between two readings does.
+ */
+
+#ifndef MONOTONIC_H_
+#define MONOTONIC_H_
+
+#define NANOSECONDS_IN_SECOND 1000000000LL
+#define NANOSECONDS_IN_MICROSECOND 1000
+
+/*
+ * The time now, in nanoseconds.
+ */
+long long monotonicNow(void);
+
+#endif
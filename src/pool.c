@@ -0,0 +1,255 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Slab allocation of fixed size objects.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "instrument.h"
+#include "pool.h"
+
+#ifdef POOL_VALGRIND
+#include <valgrind/memcheck.h>
+#else
+#define VALGRIND_CREATE_MEMPOOL(pool, redzone, zeroed)
+#define VALGRIND_DESTROY_MEMPOOL(pool)
+#define VALGRIND_MEMPOOL_ALLOC(pool, address, size)
+#define VALGRIND_MEMPOOL_FREE(pool, address)
+#define VALGRIND_MAKE_MEM_NOACCESS(address, size)
+#define VALGRIND_MAKE_MEM_DEFINED(address, size)
+#define VALGRIND_MAKE_MEM_UNDEFINED(address, size)
+#endif
+
+/*
+ * A slab, the objects come straight after it.
+ */
+struct PoolSlab {
+  struct PoolSlab *next;
+};
+
+/*
+ * A freed object, the link is kept in the object itself.
+ */
+struct PoolFreeObject {
+  struct PoolFreeObject *next;
+};
+
+/*
+ * Something with the strictest alignment the objects could need.
+ */
+union PoolAlign {
+  long long whole;
+  double real;
+  void *pointer;
+};
+
+/*
+ * Forward declarations.
+ */
+static size_t alignSize(size_t size, size_t align);
+static Boolean addSlab(struct Pool *pool);
+static void poolDestroy(struct Pool *pool);
+static void poisonFreed(struct Pool *pool, void *object);
+static void checkFreed(struct Pool *pool, void *object);
+
+struct Pool *poolCreate(size_t object_size, int slab_objects, size_t align)
+{
+  struct Pool *pool;
+
+  pool = (struct Pool *) INSTRUMENT_MALLOC(sizeof(struct Pool));
+
+  if (pool != NULL) {
+    if (object_size < sizeof(struct PoolFreeObject)) {
+      object_size = sizeof(struct PoolFreeObject);
+    }
+
+    if (align < sizeof(union PoolAlign)) {
+      align = sizeof(union PoolAlign);
+    }
+
+    pool->object_size = alignSize(object_size, align);
+    pool->align = align;
+    pool->slab_objects = slab_objects;
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    pool->unused = NULL;
+    pool->unused_count = 0;
+    pool->in_use = 0;
+    pool->released = FALSE;
+
+    VALGRIND_CREATE_MEMPOOL(pool, 0, 0);
+  }
+
+  return pool;
+}
+
+void poolRelease(struct Pool *pool)
+{
+  if (pool != NULL) {
+    pool->released = TRUE;
+
+    if (pool->in_use == 0) {
+      poolDestroy(pool);
+    }
+  }
+}
+
+/*
+ * Freed objects first, then ones never handed out, and only then a
+ * new slab.
+ */
+void *poolAlloc(struct Pool *pool)
+{
+  void *result;
+
+  result = NULL;
+
+  if (pool->free_list != NULL) {
+    result = pool->free_list;
+    VALGRIND_MAKE_MEM_DEFINED(result, sizeof(struct PoolFreeObject));
+    pool->free_list = pool->free_list->next;
+    checkFreed(pool, result);
+  } else if (pool->unused_count > 0 || addSlab(pool)) {
+    result = pool->unused;
+    pool->unused += pool->object_size;
+    pool->unused_count--;
+  }
+
+  if (result != NULL) {
+    VALGRIND_MEMPOOL_ALLOC(pool, result, pool->object_size);
+#ifdef POOL_DEBUG
+    memset(result, POOL_ALLOC_BYTE, pool->object_size);
+#endif
+    pool->in_use++;
+  }
+
+  return result;
+}
+
+void poolFree(struct Pool *pool, void *object)
+{
+  struct PoolFreeObject *freed;
+
+  if (object != NULL) {
+    poisonFreed(pool, object);
+    VALGRIND_MEMPOOL_FREE(pool, object);
+
+    /* Only the link is touched from here on. */
+    freed = (struct PoolFreeObject *) object;
+    VALGRIND_MAKE_MEM_UNDEFINED(freed, sizeof(struct PoolFreeObject));
+    freed->next = pool->free_list;
+    VALGRIND_MAKE_MEM_NOACCESS(freed, sizeof(struct PoolFreeObject));
+    pool->free_list = freed;
+    pool->in_use--;
+
+    if (pool->released && pool->in_use == 0) {
+      poolDestroy(pool);
+    }
+  }
+}
+
+/*
+ * Round up to a multiple of the alignment.
+ */
+static size_t alignSize(size_t size, size_t align)
+{
+  return (size + align - 1) / align * align;
+}
+
+/*
+ * Objects of a new slab are all unused, and the free list is empty
+ * whenever this is called, so there's nothing to link up.
+ *
+ * malloc only promises a PoolAlign boundary, so for anything stricter
+ * the slab gets enough spare bytes to move the first object up to the
+ * next boundary after the header.
+ */
+static Boolean addSlab(struct Pool *pool)
+{
+  struct PoolSlab *slab;
+  size_t header_size;
+  size_t misalignment;
+  Boolean result;
+
+  header_size = alignSize(sizeof(struct PoolSlab), sizeof(union PoolAlign));
+  slab = (struct PoolSlab *)
+         INSTRUMENT_MALLOC(header_size + pool->align -
+                           sizeof(union PoolAlign) +
+                           pool->object_size * pool->slab_objects);
+  result = (slab != NULL);
+
+  if (result) {
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->unused = (char *) slab + header_size;
+    misalignment = (size_t) pool->unused % pool->align;
+
+    if (misalignment != 0) {
+      pool->unused += pool->align - misalignment;
+    }
+
+    pool->unused_count = pool->slab_objects;
+
+    VALGRIND_MAKE_MEM_NOACCESS(pool->unused,
+                               pool->object_size * pool->slab_objects);
+  }
+
+  return result;
+}
+
+static void poolDestroy(struct Pool *pool)
+{
+  struct PoolSlab *slab;
+  struct PoolSlab *next;
+
+  slab = pool->slabs;
+
+  while (slab != NULL) {
+    next = slab->next;
+    free(slab);
+    slab = next;
+  }
+
+  VALGRIND_DESTROY_MEMPOOL(pool);
+  free(pool);
+}
+
+/*
+ * Fill everything but the free list link.
+ */
+static void poisonFreed(struct Pool *pool, void *object)
+{
+#ifdef POOL_DEBUG
+  memset((char *) object + sizeof(struct PoolFreeObject), POOL_FREED_BYTE,
+         pool->object_size - sizeof(struct PoolFreeObject));
+#else
+  (void) pool;
+  (void) object;
+#endif
+}
+
+/*
+ * Anything not still POOL_FREED_BYTE was written after it was freed.
+ */
+static void checkFreed(struct Pool *pool, void *object)
+{
+#ifdef POOL_DEBUG
+  size_t i;
+  const unsigned char *bytes;
+
+  VALGRIND_MAKE_MEM_DEFINED(object, pool->object_size);
+  bytes = (const unsigned char *) object;
+
+  for (i = sizeof(struct PoolFreeObject); i < pool->object_size; i++) {
+    assert(bytes[i] == POOL_FREED_BYTE);
+  }
+#else
+  (void) pool;
+  (void) object;
+#endif
+}
@@ -0,0 +1,108 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Fixed size object pools.
+ *
+ * A pool hands out objects of one size from slabs, big blocks holding
+ * many objects at once. Freed objects go on the pool's free list and
+ * are handed out again before any new slab is allocated, so lots of
+ * adding and deleting doesn't go back to malloc each time. Slabs are
+ * only freed when the pool is.
+ *
+ * Pools don't need to outlive their objects. Releasing a pool that
+ * still has objects handed out just marks it, and it is freed when
+ * the last of them is freed.
+ *
+ * None of this is thread safe, a pool must only be used by one thread
+ * at a time (the writer for a SharedEventList).
+ *
+ * Debugging, set when compiling:
+ *
+ * POOL_DEBUG - Objects are filled with POOL_ALLOC_BYTE when handed out
+ *              and POOL_FREED_BYTE when freed, and an assert checks
+ *              nothing wrote to an object while it was free.
+ * POOL_VALGRIND - Tells valgrind about the pool, so reading a freed
+ *                 object or leaking one is reported the same as for
+ *                 malloc. Needs the valgrind headers.
+ */
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <stddef.h>
+
+#include "bool.h"
+
+/*
+ * Fill bytes for POOL_DEBUG.
+ */
+#define POOL_ALLOC_BYTE 0xcd
+#define POOL_FREED_BYTE 0xdd
+
+/*
+ * Size of a cache line, for objects that shouldn't share or straddle
+ * one.
+ */
+#define POOL_CACHE_LINE 64
+
+struct PoolSlab;
+struct PoolFreeObject;
+
+/*
+ * The pool.
+ *
+ * object_size - Size of each object, rounded up to a multiple of align
+ *               and so it can hold a free list link.
+ * align - Every object starts on a multiple of this.
+ * slab_objects - Number of objects in each slab.
+ * slabs - All the slabs, newest first.
+ * free_list - Objects that have been freed, ready to hand out again.
+ * unused - Next object in the newest slab that has never been handed
+ *          out, unused_count of them are left.
+ * in_use - Number of objects handed out and not freed yet.
+ * released - TRUE once poolRelease has been called.
+ */
+struct Pool {
+  size_t object_size;
+  size_t align;
+  int slab_objects;
+  struct PoolSlab *slabs;
+  struct PoolFreeObject *free_list;
+  char *unused;
+  int unused_count;
+  int in_use;
+  Boolean released;
+};
+
+/*
+ * Create an empty pool, no slabs are allocated until the first
+ * object is. Returns NULL if there was a memory error.
+ *
+ * object_size - Size of the objects.
+ * slab_objects - Number of objects to allocate at a time.
+ * align - Objects start on a multiple of this, a power of two. Objects
+ *         are always aligned for any type, so 0 is enough unless they
+ *         should start on a cache line (POOL_CACHE_LINE).
+ */
+struct Pool *poolCreate(size_t object_size, int slab_objects, size_t align);
+
+/*
+ * Give up the pool. It's freed now if no objects are in use,
+ * otherwise when the last one is freed.
+ */
+void poolRelease(struct Pool *pool);
+
+/*
+ * Returns an object from the pool, NULL if there was a memory error.
+ * The object's contents are not set to anything.
+ */
+void *poolAlloc(struct Pool *pool);
+
+/*
+ * Return an object to the pool it came from.
+ */
+void poolFree(struct Pool *pool, void *object);
+
+#endif
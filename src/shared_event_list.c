@@ -0,0 +1,400 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Snapshot based thread safe event list.
+ */
+
+#include <stdlib.h>
+
+#include "shared_event_list.h"
+
+/*
+ * Starting size of the retired events array of a snapshot, doubles
+ * when full.
+ */
+#define RETIRED_CHUNK 4
+
+/*
+ * Forward declarations.
+ */
+static struct EventListSnapshot *snapshotCreate(struct EventList *list,
+                                                unsigned long version);
+static void snapshotDestroy(struct EventListSnapshot *snapshot);
+static Boolean publishSnapshot(struct SharedEventList *shared);
+static Boolean retireEvent(struct EventListSnapshot *snapshot,
+                           struct Event *event);
+
+/*
+ * Create the shared list, with the first snapshot of what is already
+ * in the list.
+ */
+struct SharedEventList *sharedEventListCreate(struct EventList *list)
+{
+  struct SharedEventList *shared;
+
+  shared = (struct SharedEventList *) malloc(sizeof(struct SharedEventList));
+
+  if (shared != NULL) {
+    shared->list = list;
+    shared->current = snapshotCreate(list, 0);
+    shared->oldest = shared->current;
+
+    if (shared->current != NULL) {
+      pthread_mutex_init(&shared->writer_lock, NULL);
+      pthread_mutex_init(&shared->snapshot_lock, NULL);
+    } else {
+      free(shared);
+      shared = NULL;
+    }
+  }
+
+  return shared;
+}
+
+/*
+ * Destroy everything, the retired events in the snapshot chain are
+ * not in the list anymore so they have to be destroyed separately.
+ */
+void sharedEventListDestroy(struct SharedEventList *shared)
+{
+  struct EventListSnapshot *snapshot;
+  struct EventListSnapshot *newer;
+
+  if (shared != NULL) {
+    snapshot = shared->oldest;
+
+    while (snapshot != NULL) {
+      newer = snapshot->newer;
+      snapshotDestroy(snapshot);
+      snapshot = newer;
+    }
+
+    eventListDestroy(shared->list);
+    pthread_mutex_destroy(&shared->writer_lock);
+    pthread_mutex_destroy(&shared->snapshot_lock);
+    free(shared);
+  }
+}
+
+/*
+ * Insert and publish.
+ */
+Boolean sharedEventListInsertLast(struct SharedEventList *shared,
+                                  struct Event *to_insert)
+{
+  Boolean result;
+
+  pthread_mutex_lock(&shared->writer_lock);
+
+  result = eventListInsertLast(shared->list, to_insert);
+
+  if (result) {
+    if (!publishSnapshot(shared)) {
+      /* Readers would never see it, so back it out. */
+      eventListRemove(shared->list, to_insert);
+      result = FALSE;
+    }
+  }
+
+  pthread_mutex_unlock(&shared->writer_lock);
+
+  sharedEventListReclaim(shared);
+
+  return result;
+}
+
+/*
+ * Unlink the event, it can't be destroyed yet since the current
+ * snapshot still has it. It goes onto the retired list of the
+ * current snapshot instead.
+ */
+Boolean sharedEventListDelete(struct SharedEventList *shared,
+                              struct Event *to_delete)
+{
+  Boolean result;
+
+  pthread_mutex_lock(&shared->writer_lock);
+
+  result = FALSE;
+
+  if (retireEvent(shared->current, to_delete)) {
+    result = eventListRemove(shared->list, to_delete);
+
+    if (result) {
+      /*
+       * If this fails the old snapshot stays current. The event is
+       * still out of the list, and is destroyed along with that
+       * snapshot later.
+       */
+      publishSnapshot(shared);
+    } else {
+      /* Wasn't in our list, so don't retire it. */
+      shared->current->retired_count--;
+    }
+  }
+
+  pthread_mutex_unlock(&shared->writer_lock);
+
+  sharedEventListReclaim(shared);
+
+  return result;
+}
+
+/*
+ * Edit by replacement, so readers holding the old event see no
+ * change at all.
+ */
+enum EventError sharedEventListEdit(struct SharedEventList *shared,
+                                    struct Event *event_to_edit,
+                                    struct Event **edited_event,
+                                    const char *const stDate,
+                                    const char *const stTime,
+                                    const int duration,
+                                    const char *const name,
+                                    const char *const location)
+{
+  enum EventError error_result;
+  struct Event *new_event;
+
+  *edited_event = event_to_edit;
+
+  error_result = eventCreate(&new_event, stDate, stTime, duration, name,
+                             location);
+
+  if (error_result == EVENT_NO_ERROR) {
+    pthread_mutex_lock(&shared->writer_lock);
+
+    if (retireEvent(shared->current, event_to_edit)) {
+      if (eventListReplace(shared->list, event_to_edit, new_event)) {
+        *edited_event = new_event;
+        new_event = NULL;
+        publishSnapshot(shared);
+      } else {
+        shared->current->retired_count--;
+        error_result = EVENT_INTERNAL_ERROR;
+      }
+    } else {
+      error_result = EVENT_INTERNAL_ERROR;
+    }
+
+    pthread_mutex_unlock(&shared->writer_lock);
+
+    /* Only still set if it didn't make it into the list. */
+    eventDestroy(new_event);
+
+    sharedEventListReclaim(shared);
+  }
+
+  return error_result;
+}
+
+/*
+ * Walk from the oldest snapshot, anything before the current one
+ * with no readers can go. They have to go in order, an event retired
+ * by a snapshot may still be in any older snapshot.
+ *
+ * The chain is cut while holding the snapshot lock, but the freeing
+ * is done after, so readers aren't kept waiting on it.
+ */
+void sharedEventListReclaim(struct SharedEventList *shared)
+{
+  struct EventListSnapshot *reclaim_start;
+  struct EventListSnapshot *reclaim_end;
+  struct EventListSnapshot *newer;
+
+  pthread_mutex_lock(&shared->writer_lock);
+  pthread_mutex_lock(&shared->snapshot_lock);
+
+  reclaim_start = shared->oldest;
+  reclaim_end = shared->oldest;
+
+  while (reclaim_end != shared->current && reclaim_end->reader_count == 0) {
+    reclaim_end = reclaim_end->newer;
+  }
+
+  shared->oldest = reclaim_end;
+
+  pthread_mutex_unlock(&shared->snapshot_lock);
+
+  while (reclaim_start != reclaim_end) {
+    newer = reclaim_start->newer;
+    snapshotDestroy(reclaim_start);
+    reclaim_start = newer;
+  }
+
+  pthread_mutex_unlock(&shared->writer_lock);
+}
+
+/*
+ * Readers just bump the count of the current snapshot.
+ */
+const struct EventListSnapshot *sharedEventListAcquire(
+  struct SharedEventList *shared)
+{
+  struct EventListSnapshot *snapshot;
+
+  pthread_mutex_lock(&shared->snapshot_lock);
+  snapshot = shared->current;
+  snapshot->reader_count++;
+  pthread_mutex_unlock(&shared->snapshot_lock);
+
+  return snapshot;
+}
+
+/*
+ * Drop the count, the writer does the actual freeing.
+ */
+void sharedEventListRelease(struct SharedEventList *shared,
+                            const struct EventListSnapshot *snapshot)
+{
+  pthread_mutex_lock(&shared->snapshot_lock);
+  ((struct EventListSnapshot *) snapshot)->reader_count--;
+  pthread_mutex_unlock(&shared->snapshot_lock);
+}
+
+/*
+ * Build the calendar string the same way eventListString does.
+ */
+char *eventListSnapshotString(const struct EventListSnapshot *snapshot)
+{
+  return eventListArrayString(snapshot->events, snapshot->count);
+}
+
+/*
+ * Copy the event pointers of the list into a new snapshot.
+ *
+ * Returns NULL on a memory error.
+ */
+static struct EventListSnapshot *snapshotCreate(struct EventList *list,
+                                                unsigned long version)
+{
+  struct EventListSnapshot *snapshot;
+  struct EventListNode *current_node;
+  int count;
+
+  snapshot = (struct EventListSnapshot *)
+             malloc(sizeof(struct EventListSnapshot));
+
+  if (snapshot != NULL) {
+    count = 0;
+
+    for (current_node = list->head; current_node != NULL;
+         current_node = current_node->next) {
+      count++;
+    }
+
+    /* Always allocate at least one, so NULL means a memory error. */
+    snapshot->events = (struct Event **)
+                       malloc(sizeof(struct Event *) * (count + 1));
+
+    if (snapshot->events != NULL) {
+      snapshot->count = 0;
+
+      for (current_node = list->head; current_node != NULL;
+           current_node = current_node->next) {
+        snapshot->events[snapshot->count++] = current_node->event;
+      }
+
+      snapshot->version = version;
+      snapshot->reader_count = 0;
+      snapshot->retired = NULL;
+      snapshot->retired_count = 0;
+      snapshot->retired_size = 0;
+      snapshot->newer = NULL;
+    } else {
+      free(snapshot);
+      snapshot = NULL;
+    }
+  }
+
+  return snapshot;
+}
+
+/*
+ * Free a snapshot, and destroy any events it retired.
+ */
+static void snapshotDestroy(struct EventListSnapshot *snapshot)
+{
+  int i;
+
+  for (i = 0; i < snapshot->retired_count; i++) {
+    eventDestroy(snapshot->retired[i]);
+  }
+
+  free(snapshot->retired);
+  free(snapshot->events);
+  free(snapshot);
+}
+
+/*
+ * Make a snapshot of the writer's list the current one.
+ *
+ * Must be called holding the writer lock.
+ *
+ * Returns FALSE if the snapshot could not be created, the old one
+ * stays current.
+ */
+static Boolean publishSnapshot(struct SharedEventList *shared)
+{
+  struct EventListSnapshot *snapshot;
+  Boolean result;
+
+  result = FALSE;
+
+  snapshot = snapshotCreate(shared->list, shared->current->version + 1);
+
+  if (snapshot != NULL) {
+    pthread_mutex_lock(&shared->snapshot_lock);
+    shared->current->newer = snapshot;
+    shared->current = snapshot;
+    pthread_mutex_unlock(&shared->snapshot_lock);
+
+    result = TRUE;
+  }
+
+  return result;
+}
+
+/*
+ * Add an event to the retired list of the snapshot. Done before
+ * unlinking the event, so if we run out of memory the list is left
+ * alone.
+ *
+ * Must be called holding the writer lock.
+ */
+static Boolean retireEvent(struct EventListSnapshot *snapshot,
+                           struct Event *event)
+{
+  Boolean result;
+
+  result = TRUE;
+
+  if (snapshot->retired_count == snapshot->retired_size) {
+    struct Event **new_retired;
+    int new_size;
+
+    if (snapshot->retired_size == 0) {
+      new_size = RETIRED_CHUNK;
+    } else {
+      new_size = snapshot->retired_size * 2;
+    }
+
+    new_retired = (struct Event **) realloc(snapshot->retired,
+                                            sizeof(struct Event *) * new_size);
+
+    if (new_retired != NULL) {
+      snapshot->retired = new_retired;
+      snapshot->retired_size = new_size;
+    } else {
+      result = FALSE;
+    }
+  }
+
+  if (result) {
+    snapshot->retired[snapshot->retired_count++] = event;
+  }
+
+  return result;
+}
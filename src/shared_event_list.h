@@ -0,0 +1,166 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Thread safe wrapper around the EventList.
+ *
+ * There is a single writer thread that changes the list, and any
+ * number of reader threads (rendering, saving, queries) that work
+ * from snapshots. A snapshot is an immutable array of the events as
+ * they were when it was published. Readers never wait on a writer
+ * that is busy changing the list, they only take a short lock to
+ * grab or drop a snapshot.
+ *
+ * Events are never changed in place once they are in a shared list.
+ * An edit creates a new event and swaps it in, the old event is
+ * retired and only destroyed once no snapshot can still see it.
+ */
+
+#ifndef SHARED_EVENT_LIST_H_
+#define SHARED_EVENT_LIST_H_
+
+#include <pthread.h>
+
+#include "bool.h"
+#include "event.h"
+#include "event_list.h"
+
+/*
+ * A published version of the list.
+ *
+ * Readers can only look at events and count, nothing in a snapshot
+ * will change or be freed while the reader holds it.
+ *
+ * events - Array of the events in list order.
+ * count - Number of events in the array.
+ * version - Increases by one each time a new snapshot is published.
+ * reader_count - Readers holding this snapshot. Protected by the
+ *                snapshot_lock of the shared list.
+ * retired - Events that are in this snapshot, but were dropped from
+ *           the next one. Destroyed when this snapshot is reclaimed.
+ * newer - The snapshot published after this one, NULL if current.
+ */
+struct EventListSnapshot {
+  struct Event **events;
+  int count;
+  unsigned long version;
+  int reader_count;
+  struct Event **retired;
+  int retired_count;
+  int retired_size;
+  struct EventListSnapshot *newer;
+};
+
+/*
+ * The shared list.
+ *
+ * list - The writer's list, only touched while holding writer_lock.
+ * oldest - Oldest snapshot that has not been reclaimed yet.
+ * current - Latest snapshot, this is what readers get.
+ * writer_lock - Serialises writers.
+ * snapshot_lock - Only held to publish, acquire or release snapshots.
+ */
+struct SharedEventList {
+  struct EventList *list;
+  struct EventListSnapshot *oldest;
+  struct EventListSnapshot *current;
+  pthread_mutex_t writer_lock;
+  pthread_mutex_t snapshot_lock;
+};
+
+/*
+ * Create a shared list.
+ *
+ * list - List to share, the shared list takes ownership of it. The
+ *        first snapshot is published from what is already in it.
+ *
+ * Returns NULL if there was a memory error, the list is left with
+ * the caller in that case.
+ */
+struct SharedEventList *sharedEventListCreate(struct EventList *list);
+
+/*
+ * Destroy the shared list, including the list and all its events.
+ *
+ * There must be no readers still holding snapshots.
+ */
+void sharedEventListDestroy(struct SharedEventList *shared);
+
+/*
+ * Insert the event at the end of the list, and publish a new
+ * snapshot.
+ *
+ * Returns FALSE if the event could not be added, the caller still
+ * owns the event in that case.
+ */
+Boolean sharedEventListInsertLast(struct SharedEventList *shared,
+                                  struct Event *to_insert);
+
+/*
+ * Delete the event from the list, and publish a new snapshot.
+ *
+ * The event is not destroyed until no snapshot holds it.
+ *
+ * Returns TRUE if the event was found.
+ */
+Boolean sharedEventListDelete(struct SharedEventList *shared,
+                              struct Event *to_delete);
+
+/*
+ * Edit an event in the list, and publish a new snapshot.
+ *
+ * Takes the same fields as eventEdit. A new event is created with
+ * those fields and takes the place of event_to_edit, which is
+ * retired.
+ *
+ * edited_event - Set to the new event if there was no error,
+ *                otherwise set to event_to_edit.
+ *
+ * Returns the eventCreate error if the fields were invalid, or
+ * EVENT_INTERNAL_ERROR if event_to_edit wasn't in the list.
+ */
+enum EventError sharedEventListEdit(struct SharedEventList *shared,
+                                    struct Event *event_to_edit,
+                                    struct Event **edited_event,
+                                    const char *const stDate,
+                                    const char *const stTime,
+                                    const int duration,
+                                    const char *const name,
+                                    const char *const location);
+
+/*
+ * Free any snapshots, and retired events, that no reader can see
+ * anymore.
+ *
+ * This is done by the writer functions above, but a writer thread
+ * can call it when idle to hand back memory sooner.
+ */
+void sharedEventListReclaim(struct SharedEventList *shared);
+
+/*
+ * Get the current snapshot for reading.
+ *
+ * Must be handed back with sharedEventListRelease once the reader is
+ * done with it.
+ */
+const struct EventListSnapshot *sharedEventListAcquire(
+  struct SharedEventList *shared);
+
+/*
+ * Hand back a snapshot from sharedEventListAcquire.
+ *
+ * This never frees anything, so it's cheap to call from any thread.
+ */
+void sharedEventListRelease(struct SharedEventList *shared,
+                            const struct EventListSnapshot *snapshot);
+
+/*
+ * Same as eventListString, but for a snapshot.
+ *
+ * Returns a string that the caller must free, NULL if the snapshot
+ * is empty or there was a memory error.
+ */
+char *eventListSnapshotString(const struct EventListSnapshot *snapshot);
+
+#endif
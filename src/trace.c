@@ -0,0 +1,215 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * The trace buffer, and writing it as Chrome trace JSON.
+ */
+
+/* For getpid. */
+#define _POSIX_C_SOURCE 199309L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "monotonic.h"
+#include "trace.h"
+
+/*
+ * Most threads that get their own row in the trace, any more share
+ * the last one.
+ */
+#define TRACE_MAX_THREADS 64
+
+/*
+ * A begin or an end.
+ *
+ * name - Name of the span.
+ * begin - TRUE for a begin, FALSE for an end.
+ * time - Monotonic time in nanoseconds.
+ * thread - Thread it happened on.
+ */
+struct TraceEvent {
+  const char *name;
+  Boolean begin;
+  long long time;
+  pthread_t thread;
+};
+
+/*
+ * The ring buffer, NULL when tracing is off. next is where the next
+ * event goes, count is how many are in it.
+ */
+static struct TraceEvent *events = NULL;
+static int next_event;
+static int count;
+static const char *filename;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Forward declarations.
+ */
+static void record(const char *name, Boolean begin);
+static int threadNumber(pthread_t *threads, int *thread_count,
+                        pthread_t thread);
+
+void traceStart()
+{
+  filename = getenv(TRACE_ENV);
+
+  if (filename != NULL && filename[0] != '\0') {
+    events = (struct TraceEvent *)
+             malloc(sizeof(struct TraceEvent) * TRACE_BUFFER_EVENTS);
+    next_event = 0;
+    count = 0;
+  }
+}
+
+Boolean traceEnabled()
+{
+  return (events != NULL);
+}
+
+void traceBegin(const char *name)
+{
+  if (events != NULL) {
+    record(name, TRUE);
+  }
+}
+
+void traceEnd(const char *name)
+{
+  if (events != NULL) {
+    record(name, FALSE);
+  }
+}
+
+/*
+ * Go through the buffer oldest first. If it has wrapped around, the
+ * ends of spans that started before the oldest event are left out,
+ * so every end written has its begin. Times are in microseconds from
+ * the first event.
+ */
+Boolean traceWrite()
+{
+  pthread_t threads[TRACE_MAX_THREADS];
+  int depths[TRACE_MAX_THREADS];
+  const struct TraceEvent *event;
+  FILE *output;
+  long long first_time;
+  int thread_count, position, thread, i;
+  Boolean result, first;
+
+  result = TRUE;
+
+  if (events != NULL) {
+    pthread_mutex_lock(&trace_lock);
+
+    output = fopen(filename, "w");
+    result = (output != NULL);
+
+    if (result) {
+      thread_count = 0;
+      first = TRUE;
+      position = (next_event - count + TRACE_BUFFER_EVENTS) %
+                 TRACE_BUFFER_EVENTS;
+      first_time = (count > 0 ? events[position].time : 0);
+
+      for (i = 0; i < TRACE_MAX_THREADS; i++) {
+        depths[i] = 0;
+      }
+
+      fprintf(output, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+
+      for (i = 0; i < count; i++) {
+        event = &events[(position + i) % TRACE_BUFFER_EVENTS];
+        thread = threadNumber(threads, &thread_count, event->thread);
+
+        if (event->begin || depths[thread] > 0) {
+          depths[thread] += event->begin ? 1 : -1;
+
+          fprintf(output, "%s\n{\"name\": \"%s\", \"ph\": \"%c\", "
+                  "\"ts\": %lld.%03lld, \"pid\": %ld, \"tid\": %d}",
+                  first ? "" : ",", event->name, event->begin ? 'B' : 'E',
+                  (event->time - first_time) / NANOSECONDS_IN_MICROSECOND,
+                  (event->time - first_time) % NANOSECONDS_IN_MICROSECOND,
+                  (long) getpid(), thread + 1);
+          first = FALSE;
+        }
+      }
+
+      fprintf(output, "\n]}\n");
+      result = (ferror(output) == 0);
+      fclose(output);
+    }
+
+    pthread_mutex_unlock(&trace_lock);
+  }
+
+  return result;
+}
+
+void traceFinish()
+{
+  if (events != NULL) {
+    if (!traceWrite()) {
+      fprintf(stderr, "Couldn't write the trace to %s.\n", filename);
+    }
+
+    free(events);
+    events = NULL;
+  }
+}
+
+/*
+ * The time is taken inside the lock, so the buffer is always in time
+ * order.
+ */
+static void record(const char *name, Boolean begin)
+{
+  struct TraceEvent *event;
+
+  pthread_mutex_lock(&trace_lock);
+
+  event = &events[next_event];
+  event->name = name;
+  event->begin = begin;
+  event->time = monotonicNow();
+  event->thread = pthread_self();
+
+  next_event = (next_event + 1) % TRACE_BUFFER_EVENTS;
+
+  if (count < TRACE_BUFFER_EVENTS) {
+    count++;
+  }
+
+  pthread_mutex_unlock(&trace_lock);
+}
+
+/*
+ * Small numbers for the threads, in the order they are first seen.
+ */
+static int threadNumber(pthread_t *threads, int *thread_count,
+                        pthread_t thread)
+{
+  int result;
+
+  result = 0;
+
+  while (result < *thread_count && !pthread_equal(threads[result], thread)) {
+    result++;
+  }
+
+  if (result == *thread_count) {
+    if (*thread_count < TRACE_MAX_THREADS) {
+      threads[result] = thread;
+      (*thread_count)++;
+    } else {
+      result = TRACE_MAX_THREADS - 1;
+    }
+  }
+
+  return result;
+}
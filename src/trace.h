@@ -0,0 +1,69 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Tracing spans of time, for finding where the time goes.
+ *
+ * Code marks the start and end of a span with traceBegin and
+ * traceEnd, spans can be nested. Each is recorded with the time and
+ * the thread in a ring buffer of the last TRACE_BUFFER_EVENTS, and
+ * can be written out as a Chrome trace file, which chrome://tracing
+ * and Perfetto (ui.perfetto.dev) can show as a timeline.
+ *
+ * Tracing is off unless the environment variable named by TRACE_ENV
+ * is set to a file name when traceStart is called. When it's off
+ * traceBegin and traceEnd return straight away, so they can be left
+ * in everywhere. The trace is written to the file by traceFinish, or
+ * any time before by traceWrite.
+ *
+ * Names aren't copied, they must be string constants.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "bool.h"
+
+/*
+ * Environment variable with the file to write the trace to.
+ */
+#define TRACE_ENV "CALENDAR_TRACE"
+
+/*
+ * Number of begins and ends kept, older ones are overwritten.
+ */
+#define TRACE_BUFFER_EVENTS 65536
+
+/*
+ * Turn tracing on if TRACE_ENV is set. Call once, at the start,
+ * before any other threads are started.
+ */
+void traceStart();
+
+/*
+ * Returns TRUE if tracing is on.
+ */
+Boolean traceEnabled();
+
+/*
+ * Mark the start and the end of a span on the calling thread. Every
+ * begin needs an end with the same name.
+ */
+void traceBegin(const char *name);
+void traceEnd(const char *name);
+
+/*
+ * Write the trace so far to the TRACE_ENV file, replacing it. Does
+ * nothing if tracing is off.
+ *
+ * Returns FALSE if the file couldn't be written.
+ */
+Boolean traceWrite();
+
+/*
+ * Write the trace and free the buffer, tracing is off after this.
+ */
+void traceFinish();
+
+#endif
@@ -15,7 +15,12 @@
 #include "calendar_file.h"
 #include "date_time.h"
 #include "event.h"
+#include "event_fuzzy.h"
+#include "event_history.h"
 #include "event_list.h"
+#include "event_prefix.h"
+#include "latency.h"
+#include "trace.h"
 #include "ui_assignment.h"
 
 #define MAIN_WINDOW_TITLE "UCP 120 Assignment"
@@ -28,6 +33,10 @@
 #define ADD_BUTTON_LABEL "Add"
 #define EDIT_BUTTON_LABEL "Edit"
 #define DELETE_BUTTON_LABEL "Delete"
+#define UNDO_BUTTON_LABEL "Undo"
+#define REDO_BUTTON_LABEL "Redo"
+#define STATS_BUTTON_LABEL "Stats"
+#define TRACE_BUTTON_LABEL "Save Trace"
 #define QUIT_BUTTON_LABEL "Quit"
 
 /*
@@ -39,12 +48,43 @@
 #define EDIT_EVENT_TITLE "Edit Event"
 #define DELETE_EVENT_TITLE "Delete Event"
 #define FIND_EVENT_TITLE "Find Event"
+#define CHOOSE_EVENT_TITLE "Choose Event"
 
 /*
  * Label for field that prompts for the event name.
  * Shown whenever user it prompted to find an event.
  */
-#define EVENT_NAME_PROMPT "Event name (exact, case-sensitive)"
+#define EVENT_NAME_PROMPT \
+  "Start of the event name (close ones offered if nothing matches)"
+
+/*
+ * Number of close names offered when there's no exact match, how
+ * much of each name is shown, and room for the whole prompt.
+ */
+#define FIND_CHOICES 5
+#define CHOICE_NAME_LENGTH 60
+#define CHOICE_PROMPT_SIZE 1024
+#define MAX_CHOICE_STRING 3
+
+/*
+ * Most events listed while typing in the find dialog, and room for
+ * each one's line.
+ */
+#define SEARCH_ROWS 20
+#define SEARCH_ROW_SIZE 128
+
+/*
+ * What the find dialog needs while the user types.
+ *
+ * index - Index of the names being searched.
+ * matches - The events for the rows being shown.
+ * rows - The text of those rows.
+ */
+struct UiSearch {
+  const struct EventPrefixIndex *index;
+  struct Event *matches[SEARCH_ROWS];
+  char rows[SEARCH_ROWS][SEARCH_ROW_SIZE];
+};
 
 /*
  * Both the addEvent, and editEvent functions share the layout for the fields of an event.
@@ -100,12 +140,26 @@ static void uiSaveCalendar(void *in_data);
 static void uiAddEvent(void *in_data);
 static void uiEditEvent(void *in_data);
 static void uiDeleteEvent(void *in_data);
+static void uiUndo(void *in_data);
+static void uiRedo(void *in_data);
+static void uiShowStats(void *in_data);
+static void uiSaveTrace(void *in_data);
 
 /* Utility functions. */
-static struct Event *uiFindEvent(struct AssignmentState *const state);
+static struct Event *uiFindEvent(struct AssignmentState *const state,
+                                 enum LatencyAction action);
+static int uiSearchRows(const char *text, char **rows, int max_rows,
+                        int *pick, void *data);
+static struct Event *uiChooseEvent(struct AssignmentState *const state,
+                                   const char *const name,
+                                   enum LatencyAction action);
+static int uiEventSummary(char *buffer, const struct Event *event);
 static void uiShowError(struct AssignmentState *const state);
 static void uiSetCalendarText(struct AssignmentState *state);
 static void uiClearCalendarText(struct AssignmentState *state);
+static void uiForgetIndexes(struct AssignmentState *state);
+static void uiHistoryRecorded(struct AssignmentState *state,
+                              enum EventHistoryError recorded);
 
 /* Functions for the add/edit dialogs */
 static void createEventDialogFieldStrings(struct DialogEventFields *fields);
@@ -135,6 +189,17 @@ void uiSetup(struct AssignmentState *const state)
   addButton(state->main_window, ADD_BUTTON_LABEL, &uiAddEvent, (void *)state);
   addButton(state->main_window, EDIT_BUTTON_LABEL, &uiEditEvent, (void *)state);
   addButton(state->main_window, DELETE_BUTTON_LABEL, &uiDeleteEvent, (void *)state);
+  addButton(state->main_window, UNDO_BUTTON_LABEL, &uiUndo, (void *)state);
+  addButton(state->main_window, REDO_BUTTON_LABEL, &uiRedo, (void *)state);
+  addButton(state->main_window, STATS_BUTTON_LABEL, &uiShowStats,
+            (void *)state);
+
+  /* Only there if tracing was turned on, see trace.h. */
+  if (traceEnabled()) {
+    addButton(state->main_window, TRACE_BUTTON_LABEL, &uiSaveTrace,
+              (void *)state);
+  }
+
   addButton(state->main_window, QUIT_BUTTON_LABEL, NULL, NULL);
 
   uiShowError(state);
@@ -185,6 +250,8 @@ static void uiLoadCalendar(void *in_data)
   char **dialog_inputs;
   char *file_name;
 
+  traceBegin("uiLoadCalendar");
+
   /* Allocate the space we need for the filename prompt. */
   file_name = (char *)malloc(MAX_FILENAME_LENGTH + 1);
   assert(file_name != NULL);
@@ -208,7 +275,10 @@ static void uiLoadCalendar(void *in_data)
                         dialog_inputs)) {
     enum FileError file_error;
 
+    latencyStart(LATENCY_LOAD);
+
     /* Clear off the current calendar. */
+    uiForgetIndexes(state);
     eventListDestroy(state->event_list);
     state->event_list = eventListCreate();
 
@@ -225,11 +295,20 @@ static void uiLoadCalendar(void *in_data)
       state->event_list = eventListCreate();
       state->error = calendarErrorString(file_error);
       uiClearCalendarText(state);
-      uiShowError(state);
     }
+
+    /* Loading isn't something that can be undone. */
+    if (!eventHistoryReset(state->history, state->event_list)) {
+      state->error = "Not enough memory to keep an undo history.";
+    }
+
+    latencyStop(LATENCY_LOAD);
+    uiShowError(state);
   }
 
   free(file_name);
+
+  traceEnd("uiLoadCalendar");
 }
 
 static void uiSaveCalendar(void *in_data)
@@ -239,6 +318,8 @@ static void uiSaveCalendar(void *in_data)
   char **dialog_inputs;
   char *file_name;
 
+  traceBegin("uiSaveCalendar");
+
   file_name = (char *)calloc(1, MAX_FILENAME_LENGTH + 1);
   assert(file_name != NULL);
   dialog_inputs = &file_name;
@@ -252,6 +333,8 @@ static void uiSaveCalendar(void *in_data)
                         dialog_inputs)) {
     enum FileError file_error;
 
+    latencyStart(LATENCY_SAVE);
+
     if (state->event_list->head != NULL) {
       file_error = saveCalendar(state->event_list, file_name);
     } else {
@@ -259,12 +342,15 @@ static void uiSaveCalendar(void *in_data)
     }
 
     free(file_name);
+    latencyStop(LATENCY_SAVE);
 
     if (file_error != FILE_NO_ERROR) {
       state->error = calendarErrorString(file_error);
       uiShowError(state);
     }
   }
+
+  traceEnd("uiSaveCalendar");
 }
 
 static void uiAddEvent(void *in_data)
@@ -272,6 +358,9 @@ static void uiAddEvent(void *in_data)
   struct AssignmentState *const state = (struct AssignmentState *)in_data;
   EDIT_PROPERTIES(dialog_properties);
   struct DialogEventFields dialog_fields;
+
+  traceBegin("uiAddEvent");
+
   createEventDialogFieldStrings(&dialog_fields);
 
   if (dialog_fields.name != NULL &&
@@ -287,28 +376,39 @@ static void uiAddEvent(void *in_data)
                           (InputProperties *)&dialog_properties, dialog_inputs)) {
       /* Try creating the event, if we fail, let the user know. */
       enum EventError error_result;
+      enum EventHistoryError history_result;
       struct Event *new_event;
 
-      error_result = eventCreate(&new_event, dialog_fields.date,
-                                 dialog_fields.time,
-                                 atoi(dialog_fields.duration),
-                                 dialog_fields.name,
-                                 dialog_fields.location);
+      latencyStart(LATENCY_ADD);
+
+      error_result = eventListCreateEvent(state->event_list, &new_event,
+                                          dialog_fields.date,
+                                          dialog_fields.time,
+                                          atoi(dialog_fields.duration),
+                                          dialog_fields.name,
+                                          dialog_fields.location);
 
       if (error_result == EVENT_NO_ERROR) {
-        if (eventListInsertLast(state->event_list, new_event)) {
+        history_result = eventHistoryInsertLast(state->history,
+                                                state->event_list,
+                                                new_event);
+
+        if (history_result != HISTORY_LIST_ERROR) {
           /* No error, update calendar display. */
+          uiHistoryRecorded(state, history_result);
           uiSetCalendarText(state);
         } else {
           /* Error inserting into list */
           /* Free up the event. */
           state->error = "Error trying to add event to list.";
-          free(new_event);
+          eventDestroy(new_event);
         }
       } else {
         /* Error creating the event. */
         state->error = "Error creating event, invalid fields?";
       }
+
+      latencyStop(LATENCY_ADD);
     }
   }
 
@@ -316,6 +416,8 @@ static void uiAddEvent(void *in_data)
 
   /* Show any errors */
   uiShowError(state);
+
+  traceEnd("uiAddEvent");
 }
 
 /*
@@ -330,7 +432,9 @@ static void uiEditEvent(void *in_data)
   EDIT_PROPERTIES(dialog_properties);
   struct DialogEventFields dialog_fields;
 
-  event_to_edit = uiFindEvent(state);
+  traceBegin("uiEditEvent");
+
+  event_to_edit = uiFindEvent(state, LATENCY_EDIT);
 
   if (event_to_edit != NULL) {
     createEventDialogFieldStrings(&dialog_fields);
@@ -347,7 +451,7 @@ static void uiEditEvent(void *in_data)
       strncat(dialog_fields.name, event_to_edit->name, MAX_LENGTH_OF_NAME);
 
       if (event_to_edit->location != NULL ) {
-        strncat(dialog_fields.location, event_to_edit->location,
+        strncat(dialog_fields.location, eventLocation(event_to_edit),
                 MAX_LENGTH_OF_LOCATION);
       }
 
@@ -369,19 +473,40 @@ static void uiEditEvent(void *in_data)
                             (InputProperties *)&dialog_properties,
                             dialog_inputs)) {
         enum EventError error_result;
+        struct Event *edited_event;
+
+        latencyStart(LATENCY_EDIT);
+
+        /*
+         * Older versions in the history still have the event, so the
+         * edit is made to a copy which then replaces it.
+         */
+        error_result = eventCopy(&edited_event, event_to_edit);
 
-        error_result = eventEdit(event_to_edit, dialog_fields.date,
-                                 dialog_fields.time,
-                                 atoi(dialog_fields.duration),
-                                 dialog_fields.name,
-                                 dialog_fields.location);
+        if (error_result == EVENT_NO_ERROR) {
+          error_result = eventEdit(edited_event,
+                                   dialog_fields.date,
+                                   dialog_fields.time,
+                                   atoi(dialog_fields.duration),
+                                   dialog_fields.name,
+                                   dialog_fields.location);
+
+          if (error_result != EVENT_NO_ERROR) {
+            eventDestroy(edited_event);
+          }
+        }
 
         if (error_result == EVENT_NO_ERROR) {
+          uiHistoryRecorded(state, eventHistoryReplace(
+                              state->history, state->event_list,
+                              event_to_edit, edited_event));
           uiSetCalendarText(state);
         } else {
           /* Error creating the event. */
           state->error = "Error editing event, invalid fields?";
         }
+
+        latencyStop(LATENCY_EDIT);
       }
     }
 
@@ -390,6 +515,8 @@ static void uiEditEvent(void *in_data)
 
   /* Show any errors */
   uiShowError(state);
+
+  traceEnd("uiEditEvent");
 }
 
 /*
@@ -398,60 +525,301 @@ static void uiEditEvent(void *in_data)
 static void uiDeleteEvent(void *in_data) {
   struct AssignmentState *const state = (struct AssignmentState *)in_data;
   struct Event *event_to_delete;
+  enum EventHistoryError history_result;
+
+  traceBegin("uiDeleteEvent");
 
-  event_to_delete = uiFindEvent(state);
+  event_to_delete = uiFindEvent(state, LATENCY_DELETE);
 
   if (event_to_delete != NULL) {
-    if (!eventListDelete(state->event_list, event_to_delete)) {
+    history_result = eventHistoryDelete(state->history, state->event_list,
+                                        event_to_delete);
+
+    if (history_result == HISTORY_LIST_ERROR) {
       state->error = "Found event, but couldn't delete it.";
     } else {
       /* Delete worked, update the calendar display. */
+      uiHistoryRecorded(state, history_result);
       uiSetCalendarText(state);
     }
   } else {
     state->error = "Could not find event to delete";
   }
 
+  latencyStop(LATENCY_DELETE);
+
   /* Show any errors */
   uiShowError(state);
+
+  traceEnd("uiDeleteEvent");
 }
 
 /*
- * Prompts the user for an event name.
+ * Go back to the calendar as it was before the last change.
+ */
+static void uiUndo(void *in_data)
+{
+  struct AssignmentState *const state = (struct AssignmentState *)in_data;
+  enum EventHistoryError result;
+
+  traceBegin("uiUndo");
+
+  result = eventHistoryUndo(state->history, state->event_list);
+
+  if (result == HISTORY_NO_ERROR) {
+    uiSetCalendarText(state);
+  } else if (result == HISTORY_EMPTY) {
+    state->error = "Nothing to undo.";
+  } else {
+    state->error = "Not enough memory to undo that.";
+  }
+
+  uiShowError(state);
+
+  traceEnd("uiUndo");
+}
+
+/*
+ * Put back the last change that was undone.
+ */
+static void uiRedo(void *in_data)
+{
+  struct AssignmentState *const state = (struct AssignmentState *)in_data;
+  enum EventHistoryError result;
+
+  traceBegin("uiRedo");
+
+  result = eventHistoryRedo(state->history, state->event_list);
+
+  if (result == HISTORY_NO_ERROR) {
+    uiSetCalendarText(state);
+  } else if (result == HISTORY_EMPTY) {
+    state->error = "Nothing to redo.";
+  } else {
+    state->error = "Not enough memory to redo that.";
+  }
+
+  uiShowError(state);
+
+  traceEnd("uiRedo");
+}
+
+/*
+ * Show how long the user has waited for each action, see latency.h.
+ */
+static void uiShowStats(void *in_data)
+{
+  struct AssignmentState *const state = (struct AssignmentState *)in_data;
+  char *report;
+
+  report = latencyReport(eventListCount(state->event_list));
+
+  if (report != NULL) {
+    messageBox(state->main_window, report);
+    free(report);
+  } else {
+    state->error = "Not enough memory to show the stats.";
+    uiShowError(state);
+  }
+}
+
+/*
+ * Write out the trace so far, without waiting for the program to
+ * end.
+ */
+static void uiSaveTrace(void *in_data)
+{
+  struct AssignmentState *const state = (struct AssignmentState *)in_data;
+
+  if (!traceWrite()) {
+    state->error = "Couldn't write the trace file.";
+  }
+
+  uiShowError(state);
+}
+
+/*
+ * Prompts the user for an event name, listing the events starting
+ * with what's been typed so far as they type. The user picks one from
+ * the list. An event is only picked for them when what they typed is
+ * its whole name, and no other event has that name, otherwise they
+ * have to choose. The prefix index is only built when it's first
+ * needed, and keeps itself up to date after that.
+ *
+ * action - Timed from when the user confirms the name, callers that
+ *          show another dialog after this start it again.
  *
  * Returns a pointer to the event, NULL if no event was found.
  */
-static struct Event *uiFindEvent(struct AssignmentState *const state)
+static struct Event *uiFindEvent(struct AssignmentState *const state,
+                                 enum LatencyAction action)
 {
   InputProperties dialog_properties;
+  struct UiSearch *search;
   struct Event *result;
-  char **dialog_inputs;
   char *event_name_to_find;
+  int selected;
 
-  event_name_to_find = (char *)calloc(1, MAX_LENGTH_OF_NAME + 1);
-  assert(event_name_to_find != NULL);
-  dialog_inputs = &event_name_to_find;
+  result = NULL;
 
-  dialog_properties.label = EVENT_NAME_PROMPT;
-  dialog_properties.maxLength = MAX_LENGTH_OF_NAME;
-  dialog_properties.isMultiLine = FALSE;
+  if (!eventPrefixIsCurrent(state->prefix_index, state->event_list)) {
+    eventPrefixDestroy(state->prefix_index);
+    state->prefix_index = eventPrefixCreate(state->event_list);
+  }
 
-  if (TRUE == dialogBox(state->main_window, FIND_EVENT_TITLE, 1,
-                        &dialog_properties,
-                        dialog_inputs)) {
-    result = eventListFind(state->event_list, event_name_to_find);
-    if (result == NULL) {
-      state->error = "Could not find event.";
+  if (state->prefix_index != NULL) {
+    event_name_to_find = (char *)calloc(1, MAX_LENGTH_OF_NAME + 1);
+    search = (struct UiSearch *)malloc(sizeof(struct UiSearch));
+    assert(event_name_to_find != NULL && search != NULL);
+    search->index = state->prefix_index;
+
+    dialog_properties.label = EVENT_NAME_PROMPT;
+    dialog_properties.maxLength = MAX_LENGTH_OF_NAME;
+    dialog_properties.isMultiLine = FALSE;
+
+    if (TRUE == searchBox(state->main_window, FIND_EVENT_TITLE,
+                          &dialog_properties, event_name_to_find,
+                          uiSearchRows, search, SEARCH_ROWS, &selected)) {
+      latencyStart(action);
+
+      if (selected >= 0) {
+        result = search->matches[selected];
+      } else {
+        result = uiChooseEvent(state, event_name_to_find, action);
+      }
     }
+
+    free(search);
+    free(event_name_to_find);
   } else {
-    result = NULL;
+    state->error = "Not enough memory to search the events.";
   }
 
-  free(event_name_to_find);
+  return result;
+}
+
+/*
+ * Called by the find dialog every time the name changes, lists the
+ * first few events starting with it. An event whose name is exactly
+ * the text is picked, as long as it's the only one, a prefix of a
+ * longer name never is.
+ */
+static int uiSearchRows(const char *text, char **rows, int max_rows,
+                        int *pick, void *data)
+{
+  struct UiSearch *search;
+  int count, exact_count, i;
+
+  search = (struct UiSearch *)data;
+  count = eventPrefixFind(search->index, text, search->matches, max_rows);
+  exact_count = 0;
+
+  if (count > max_rows) {
+    count = max_rows;
+  }
+
+  for (i = 0; i < count; i++) {
+    uiEventSummary(search->rows[i], search->matches[i]);
+    rows[i] = search->rows[i];
+
+    if (strcmp(search->matches[i]->name, text) == 0) {
+      *pick = i;
+      exact_count++;
+    }
+  }
+
+  if (exact_count != 1) {
+    *pick = -1;
+  }
+
+  return count;
+}
+
+/*
+ * Offer the events with names closest to the one that wasn't found,
+ * and let the user pick one by number. The fuzzy index is only built
+ * when it's needed, and kept until the list changes.
+ *
+ * action - Timed again from when the user picks.
+ *
+ * Returns a pointer to the event, NULL if none was picked.
+ */
+static struct Event *uiChooseEvent(struct AssignmentState *const state,
+                                   const char *const name,
+                                   enum LatencyAction action)
+{
+  struct EventFuzzyMatch matches[FIND_CHOICES];
+  InputProperties dialog_properties;
+  struct Event *result;
+  char prompt[CHOICE_PROMPT_SIZE];
+  char choice[MAX_CHOICE_STRING + 1];
+  char *dialog_inputs;
+  int match_count, length, number, i;
+
+  result = NULL;
+  match_count = 0;
+
+  if (!eventFuzzyIsCurrent(state->fuzzy_index, state->event_list)) {
+    eventFuzzyDestroy(state->fuzzy_index);
+    state->fuzzy_index = eventFuzzyCreate(state->event_list);
+  }
+
+  if (state->fuzzy_index != NULL) {
+    match_count = eventFuzzyFind(state->fuzzy_index, name, -1, matches,
+                                 FIND_CHOICES);
+  }
+
+  if (match_count > 0) {
+    length = sprintf(prompt, "No exact match, did you mean:\n");
+
+    for (i = 0; i < match_count; i++) {
+      length += sprintf(prompt + length, "%d. ", i + 1);
+      length += uiEventSummary(prompt + length, matches[i].event);
+      length += sprintf(prompt + length, "\n");
+    }
+
+    sprintf(prompt + length, "Number of the event");
+
+    /* Nothing filled in, so Enter alone doesn't pick one. */
+    choice[0] = '\0';
+    dialog_inputs = choice;
+    dialog_properties.label = prompt;
+    dialog_properties.maxLength = MAX_CHOICE_STRING;
+    dialog_properties.isMultiLine = FALSE;
+
+    if (TRUE == dialogBox(state->main_window, CHOOSE_EVENT_TITLE, 1,
+                          &dialog_properties, &dialog_inputs)) {
+      latencyStart(action);
+      number = atoi(choice);
+
+      if (number >= 1 && number <= match_count) {
+        result = matches[number - 1].event;
+      } else {
+        state->error = "There isn't an event with that number.";
+      }
+    }
+  } else {
+    state->error = "Could not find event.";
+  }
 
   return result;
 }
 
+/*
+ * The start of the event's name and when it starts, on one line, for
+ * telling events apart when choosing one. buffer needs room for
+ * CHOICE_NAME_LENGTH plus the date and time.
+ *
+ * Returns the length written.
+ */
+static int uiEventSummary(char *buffer, const struct Event *event)
+{
+  return sprintf(buffer, "%.*s  %04d-%02d-%02d %02d:%02d",
+                 CHOICE_NAME_LENGTH, event->name, event->date.year,
+                 event->date.month, event->date.day, event->time.hour,
+                 event->time.minutes);
+}
+
 /*
  * Shows a message box to the user with the current error string in
  * the application state. Will then clear the error from the state.
@@ -470,6 +838,8 @@ static void uiSetCalendarText(struct AssignmentState *state)
 {
   char *calendar_text;
 
+  traceBegin("uiSetCalendarText");
+
   calendar_text = eventListString(state->event_list);
 
   if (calendar_text != NULL) {
@@ -478,6 +848,8 @@ static void uiSetCalendarText(struct AssignmentState *state)
   } else {
     setText(state->main_window, "");
   }
+
+  traceEnd("uiSetCalendarText");
 }
 
 static void uiClearCalendarText(struct AssignmentState *state)
@@ -485,6 +857,31 @@ static void uiClearCalendarText(struct AssignmentState *state)
   setText(state->main_window, "");
 }
 
+/*
+ * Called before the event list is replaced, so indexes built from
+ * the old one aren't used with the new one.
+ */
+static void uiForgetIndexes(struct AssignmentState *state)
+{
+  eventFuzzyDestroy(state->fuzzy_index);
+  state->fuzzy_index = NULL;
+  eventPrefixDestroy(state->prefix_index);
+  state->prefix_index = NULL;
+}
+
+/*
+ * Called with the result of a change made through the history. The
+ * change was made either way, but if the history couldn't keep up it
+ * has been cleared, so let the user know undo won't go back past it.
+ */
+static void uiHistoryRecorded(struct AssignmentState *state,
+                              enum EventHistoryError recorded)
+{
+  if (recorded == HISTORY_NOT_RECORDED) {
+    state->error = "Couldn't record change, undo history has been cleared.";
+  }
+}
+
 /*
  * Allocate the memory for the strings for the add/edit event dialog
  * box.
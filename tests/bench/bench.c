@@ -0,0 +1,456 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Benchmarks, run with make bench.
+ *
+ * A calendar is generated (see generate.h), then each operation is
+ * timed many times. Each sample is the time for one call, or for a
+ * batch of calls for the really quick ones, and the results are
+ * printed as operations per second and nanoseconds per operation,
+ * with percentiles over the samples.
+ *
+ * Usage: benchmarks [-n EVENTS] [-s SEED] [-r REPEATS] [-N NAMES]
+ *                   [-L LOCATIONS] [-p PERCENT] [-u] [-g FILE]
+ *
+ * -n - Number of events in the calendar.
+ * -s - Seed for the calendar and the operations picked.
+ * -N - Number of different names.
+ * -L - Number of different locations.
+ * -p - Percentage of events with a location, 0 to 100.
+ * -r - Number of samples for the whole calendar operations.
+ * -u - Names and locations are picked uniformly, not skewed.
+ * -g - Just write the calendar to FILE and stop.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "calendar_file.h"
+#include "date_time.h"
+#include "event_list.h"
+#include "generate.h"
+#include "monotonic.h"
+
+/*
+ * Where the calendars are written, relative to the tests directory.
+ */
+#define BENCH_CALENDAR "saved/bench.txt"
+#define BENCH_SAVED "saved/bench-saved.txt"
+
+/*
+ * Samples for the small operations, and the number of calls timed
+ * together for each date and time sample.
+ */
+#define BENCH_OPERATIONS 1000
+#define BENCH_BATCH 1000
+#define BENCH_DEFAULT_REPEATS 20
+
+/*
+ * Settings for a run.
+ */
+struct BenchConfig {
+  struct GenerateConfig calendar;
+  int repeats;
+  const char *generate_only;
+};
+
+/*
+ * Forward declarations.
+ */
+static Boolean parseArgs(int argc, char *argv[], struct BenchConfig *config);
+static int compareSamples(const void *first, const void *second);
+static double percentile(const long long *sorted, int count, int percent);
+static void report(const char *name, long long *samples, int count,
+                   int batch);
+static struct EventList *loadList(void);
+static void benchLoad(int repeats);
+static void benchSave(int repeats);
+static void benchString(int repeats);
+static void benchFind(const struct GenerateConfig *const calendar);
+static void benchDelete(const struct GenerateConfig *const calendar);
+static void benchDateTime(void);
+
+int main(int argc, char *argv[])
+{
+  struct BenchConfig config;
+  int result;
+
+  result = EXIT_SUCCESS;
+
+  if (!parseArgs(argc, argv, &config)) {
+    fprintf(stderr, "Usage: %s [-n EVENTS] [-s SEED] [-r REPEATS] "
+            "[-N NAMES] [-L LOCATIONS] [-p PERCENT] [-u] [-g FILE]\n",
+            argv[0]);
+    result = EXIT_FAILURE;
+  } else if (config.generate_only != NULL) {
+    if (!generateCalendar(&config.calendar, config.generate_only)) {
+      fprintf(stderr, "Couldn't write %s.\n", config.generate_only);
+      result = EXIT_FAILURE;
+    }
+  } else if (!generateCalendar(&config.calendar, BENCH_CALENDAR)) {
+    fprintf(stderr, "Couldn't write %s, run from the tests directory.\n",
+            BENCH_CALENDAR);
+    result = EXIT_FAILURE;
+  } else {
+    printf("%d events, seed %lu, %d names, %d locations on %d%% of "
+           "them, %s\n\n",
+           config.calendar.event_count, config.calendar.seed,
+           config.calendar.name_count, config.calendar.location_count,
+           config.calendar.location_percent,
+           config.calendar.spread == GENERATE_SKEWED ? "skewed" : "uniform");
+    printf("%-22s %12s %12s %10s %10s %10s %10s\n", "operation", "ops/sec",
+           "ns/op", "p50", "p90", "p99", "max");
+
+    benchLoad(config.repeats);
+    benchSave(config.repeats);
+    benchString(config.repeats);
+    benchFind(&config.calendar);
+    benchDelete(&config.calendar);
+    benchDateTime();
+  }
+
+  return result;
+}
+
+static Boolean parseArgs(int argc, char *argv[], struct BenchConfig *config)
+{
+  Boolean result;
+  int i;
+
+  generateDefaults(&config->calendar);
+  config->repeats = BENCH_DEFAULT_REPEATS;
+  config->generate_only = NULL;
+  result = TRUE;
+
+  for (i = 1; i < argc && result; i++) {
+    if (strcmp(argv[i], "-u") == 0) {
+      config->calendar.spread = GENERATE_UNIFORM;
+    } else if (i + 1 >= argc) {
+      result = FALSE;
+    } else if (strcmp(argv[i], "-n") == 0) {
+      config->calendar.event_count = atoi(argv[++i]);
+      result = (config->calendar.event_count > 0);
+    } else if (strcmp(argv[i], "-s") == 0) {
+      config->calendar.seed = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "-r") == 0) {
+      config->repeats = atoi(argv[++i]);
+      result = (config->repeats > 0);
+    } else if (strcmp(argv[i], "-N") == 0) {
+      config->calendar.name_count = atoi(argv[++i]);
+      result = (config->calendar.name_count > 0);
+    } else if (strcmp(argv[i], "-L") == 0) {
+      config->calendar.location_count = atoi(argv[++i]);
+      result = (config->calendar.location_count > 0);
+    } else if (strcmp(argv[i], "-p") == 0) {
+      config->calendar.location_percent = atoi(argv[++i]);
+      result = (config->calendar.location_percent >= 0 &&
+                config->calendar.location_percent <= 100);
+    } else if (strcmp(argv[i], "-g") == 0) {
+      config->generate_only = argv[++i];
+    } else {
+      result = FALSE;
+    }
+  }
+
+  return result;
+}
+
+static int compareSamples(const void *first, const void *second)
+{
+  long long first_sample, second_sample;
+
+  first_sample = *(const long long *) first;
+  second_sample = *(const long long *) second;
+
+  return (first_sample > second_sample) - (first_sample < second_sample);
+}
+
+/*
+ * Nearest rank percentile of sorted samples.
+ */
+static double percentile(const long long *sorted, int count, int percent)
+{
+  int rank;
+
+  rank = (count * percent + 99) / 100;
+
+  if (rank < 1) {
+    rank = 1;
+  }
+
+  return (double) sorted[rank - 1];
+}
+
+/*
+ * Print a line for the samples, batch is the number of calls timed in
+ * each one. The samples are sorted.
+ */
+static void report(const char *name, long long *samples, int count,
+                   int batch)
+{
+  long long total;
+  double ns_per_op;
+  int i;
+
+  qsort(samples, count, sizeof(long long), compareSamples);
+  total = 0;
+
+  for (i = 0; i < count; i++) {
+    total += samples[i];
+  }
+
+  ns_per_op = (double) total / ((double) count * batch);
+
+  printf("%-22s %12.0f %12.1f %10.1f %10.1f %10.1f %10.1f\n", name,
+         ns_per_op > 0 ? NANOSECONDS_IN_SECOND / ns_per_op : 0.0, ns_per_op,
+         percentile(samples, count, 50) / batch,
+         percentile(samples, count, 90) / batch,
+         percentile(samples, count, 99) / batch,
+         (double) samples[count - 1] / batch);
+}
+
+static struct EventList *loadList(void)
+{
+  struct EventList *list;
+
+  list = eventListCreate();
+
+  if (list == NULL || loadCalendar(list, BENCH_CALENDAR) != FILE_NO_ERROR) {
+    fprintf(stderr, "Couldn't load %s.\n", BENCH_CALENDAR);
+    exit(EXIT_FAILURE);
+  }
+
+  return list;
+}
+
+static void benchLoad(int repeats)
+{
+  struct EventList *list;
+  long long *samples;
+  long long start;
+  int i;
+
+  samples = (long long *) malloc(sizeof(long long) * repeats);
+
+  for (i = 0; i < repeats; i++) {
+    start = monotonicNow();
+    list = loadList();
+    samples[i] = monotonicNow() - start;
+    eventListDestroy(list);
+  }
+
+  report("loadCalendar", samples, repeats, 1);
+  free(samples);
+}
+
+static void benchSave(int repeats)
+{
+  struct EventList *list;
+  long long *samples;
+  long long start;
+  int i;
+
+  samples = (long long *) malloc(sizeof(long long) * repeats);
+  list = loadList();
+
+  for (i = 0; i < repeats; i++) {
+    start = monotonicNow();
+    saveCalendar(list, BENCH_SAVED);
+    samples[i] = monotonicNow() - start;
+  }
+
+  report("saveCalendar", samples, repeats, 1);
+  eventListDestroy(list);
+  free(samples);
+}
+
+static void benchString(int repeats)
+{
+  struct EventList *list;
+  long long *samples;
+  long long start;
+  char *calendar_text;
+  int i;
+
+  samples = (long long *) malloc(sizeof(long long) * repeats);
+  list = loadList();
+
+  for (i = 0; i < repeats; i++) {
+    start = monotonicNow();
+    calendar_text = eventListString(list);
+    samples[i] = monotonicNow() - start;
+    free(calendar_text);
+  }
+
+  report("eventListString", samples, repeats, 1);
+  eventListDestroy(list);
+  free(samples);
+}
+
+/*
+ * Names are picked the same way the calendar picked them, so common
+ * names are looked up more often.
+ */
+static void benchFind(const struct GenerateConfig *const calendar)
+{
+  struct GenerateRandom random;
+  struct EventList *list;
+  long long samples[BENCH_OPERATIONS];
+  long long start;
+  char name[GENERATE_STRING_SIZE];
+  int i;
+
+  generateSeed(&random, calendar->seed + 1);
+  list = loadList();
+
+  for (i = 0; i < BENCH_OPERATIONS; i++) {
+    generateName(generatePick(&random, calendar->name_count,
+                              calendar->spread), name);
+    start = monotonicNow();
+    eventListFind(list, name);
+    samples[i] = monotonicNow() - start;
+  }
+
+  report("eventListFind", samples, BENCH_OPERATIONS, 1);
+  eventListDestroy(list);
+}
+
+/*
+ * Delete events in a random order, shuffled the same way each run.
+ */
+static void benchDelete(const struct GenerateConfig *const calendar)
+{
+  struct GenerateRandom random;
+  struct EventList *list;
+  struct Event **events;
+  struct Event *swap;
+  long long samples[BENCH_OPERATIONS];
+  long long start;
+  int count, deletes, i, other;
+
+  generateSeed(&random, calendar->seed + 2);
+  list = loadList();
+  count = calendar->event_count;
+  events = (struct Event **) malloc(sizeof(struct Event *) * count);
+
+  eventListResetPosition(list);
+
+  for (i = 0; i < count; i++) {
+    events[i] = eventListNext(list);
+  }
+
+  for (i = count - 1; i > 0; i--) {
+    other = (int) (generateNext(&random) % (unsigned long) (i + 1));
+    swap = events[i];
+    events[i] = events[other];
+    events[other] = swap;
+  }
+
+  deletes = count < BENCH_OPERATIONS ? count : BENCH_OPERATIONS;
+
+  for (i = 0; i < deletes; i++) {
+    start = monotonicNow();
+    eventListDelete(list, events[i]);
+    samples[i] = monotonicNow() - start;
+  }
+
+  report("eventListDelete", samples, deletes, 1);
+  eventListDestroy(list);
+  free(events);
+}
+
+/*
+ * These are quick, so each sample is a batch of calls over a spread
+ * of dates and times.
+ */
+static void benchDateTime(void)
+{
+  struct GenerateRandom random;
+  struct Date start_date, dates[BENCH_BATCH];
+  struct Time times[BENCH_BATCH];
+  char stDates[BENCH_BATCH][MAX_DATE_STRING];
+  char stTimes[BENCH_BATCH][MAX_TIME_STRING];
+  char output[MAX_DURATION_STRING];
+  long long samples[BENCH_OPERATIONS];
+  long long start;
+  long start_days;
+  int i, j;
+
+  generateSeed(&random, 3);
+  dateParse("2013-01-01", &start_date);
+  start_days = dateToDays(&start_date);
+
+  for (i = 0; i < BENCH_BATCH; i++) {
+    dateFromDays(start_days + generatePick(&random, GENERATE_DAYS,
+                                           GENERATE_UNIFORM), &dates[i]);
+    times[i].hour = generatePick(&random, 24, GENERATE_UNIFORM);
+    times[i].minutes = generatePick(&random, MINUTES_IN_HOURS,
+                                    GENERATE_UNIFORM);
+    sprintf(stDates[i], FILE_DATE_FORMAT, dates[i].year, dates[i].month,
+            dates[i].day);
+    sprintf(stTimes[i], FILE_TIME_FORMAT, times[i].hour, times[i].minutes);
+  }
+
+  for (i = 0; i < BENCH_OPERATIONS; i++) {
+    start = monotonicNow();
+
+    for (j = 0; j < BENCH_BATCH; j++) {
+      dateParse(stDates[j], &dates[j]);
+    }
+
+    samples[i] = monotonicNow() - start;
+  }
+
+  report("dateParse", samples, BENCH_OPERATIONS, BENCH_BATCH);
+
+  for (i = 0; i < BENCH_OPERATIONS; i++) {
+    start = monotonicNow();
+
+    for (j = 0; j < BENCH_BATCH; j++) {
+      timeParse(stTimes[j], &times[j]);
+    }
+
+    samples[i] = monotonicNow() - start;
+  }
+
+  report("timeParse", samples, BENCH_OPERATIONS, BENCH_BATCH);
+
+  for (i = 0; i < BENCH_OPERATIONS; i++) {
+    start = monotonicNow();
+
+    for (j = 0; j < BENCH_BATCH; j++) {
+      dateString(output, &dates[j]);
+    }
+
+    samples[i] = monotonicNow() - start;
+  }
+
+  report("dateString", samples, BENCH_OPERATIONS, BENCH_BATCH);
+
+  for (i = 0; i < BENCH_OPERATIONS; i++) {
+    start = monotonicNow();
+
+    for (j = 0; j < BENCH_BATCH; j++) {
+      timeString(output, &times[j]);
+    }
+
+    samples[i] = monotonicNow() - start;
+  }
+
+  report("timeString", samples, BENCH_OPERATIONS, BENCH_BATCH);
+
+  for (i = 0; i < BENCH_OPERATIONS; i++) {
+    start = monotonicNow();
+
+    for (j = 0; j < BENCH_BATCH; j++) {
+      durationString(output, j * 7);
+    }
+
+    samples[i] = monotonicNow() - start;
+  }
+
+  report("durationString", samples, BENCH_OPERATIONS, BENCH_BATCH);
+}
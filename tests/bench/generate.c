@@ -0,0 +1,175 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Making synthetic calendars.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "date_time.h"
+#include "generate.h"
+
+/*
+ * Park and Miller's minimal standard generator, worked out with
+ * Schrage's method so it fits in 32 bits.
+ */
+#define RANDOM_MODULUS 2147483647L
+#define RANDOM_MULTIPLIER 16807L
+#define RANDOM_QUOTIENT 127773L
+#define RANDOM_REMAINDER 2836L
+
+/*
+ * Durations are a multiple of 15 minutes, up to 16 of them.
+ */
+#define DURATION_STEP 15
+#define DURATION_STEPS 16
+
+/*
+ * Words the names and locations are made from.
+ */
+static const char *const words[] = {
+  "Team", "Project", "Review", "Lunch", "Planning", "Dentist", "Gym",
+  "Budget", "Call", "Lecture", "Tutorial", "Interview", "Coffee",
+  "Standup", "Workshop", "Retrospective"
+};
+
+#define WORD_COUNT ((int) (sizeof(words) / sizeof(words[0])))
+
+void generateDefaults(struct GenerateConfig *config)
+{
+  config->event_count = 10000;
+  config->seed = 1;
+  config->name_count = 500;
+  config->location_count = 50;
+  config->location_percent = 70;
+  config->spread = GENERATE_SKEWED;
+}
+
+/*
+ * Same format as saveCalendar.
+ */
+Boolean generateCalendar(const struct GenerateConfig *const config,
+                         const char *const filename)
+{
+  struct GenerateRandom random;
+  struct Date start_date, date;
+  char name[GENERATE_STRING_SIZE], location[GENERATE_STRING_SIZE];
+  FILE *output;
+  long start_days;
+  int i, minute_of_day, duration;
+  Boolean result;
+
+  output = fopen(filename, "w");
+  result = (output != NULL);
+
+  if (result) {
+    generateSeed(&random, config->seed);
+    dateParse("2013-01-01", &start_date);
+    start_days = dateToDays(&start_date);
+
+    for (i = 0; i < config->event_count; i++) {
+      dateFromDays(start_days + generatePick(&random, GENERATE_DAYS,
+                                             GENERATE_UNIFORM), &date);
+      minute_of_day = generatePick(&random, MINUTES_IN_DAY / DURATION_STEP,
+                                   GENERATE_UNIFORM) * DURATION_STEP;
+      duration = (generatePick(&random, DURATION_STEPS, GENERATE_UNIFORM) +
+                  1) * DURATION_STEP;
+      generateName(generatePick(&random, config->name_count, config->spread),
+                   name);
+
+      fprintf(output, FILE_DATE_FORMAT " " FILE_TIME_FORMAT " %d %s\n",
+              date.year, date.month, date.day,
+              minute_of_day / MINUTES_IN_HOURS,
+              minute_of_day % MINUTES_IN_HOURS, duration, name);
+
+      if (generatePick(&random, 100, GENERATE_UNIFORM) <
+          config->location_percent) {
+        generateLocation(generatePick(&random, config->location_count,
+                                      config->spread), location);
+        fprintf(output, "%s\n", location);
+      }
+
+      fprintf(output, "\n");
+    }
+
+    result = (ferror(output) == 0);
+    fclose(output);
+  }
+
+  return result;
+}
+
+void generateSeed(struct GenerateRandom *random, unsigned long seed)
+{
+  random->state = seed % RANDOM_MODULUS;
+
+  if (random->state == 0) {
+    random->state = 1;
+  }
+}
+
+unsigned long generateNext(struct GenerateRandom *random)
+{
+  long state;
+
+  state = (long) random->state;
+  state = RANDOM_MULTIPLIER * (state % RANDOM_QUOTIENT) -
+          RANDOM_REMAINDER * (state / RANDOM_QUOTIENT);
+
+  if (state <= 0) {
+    state += RANDOM_MODULUS;
+  }
+
+  random->state = (unsigned long) state;
+
+  return random->state - 1;
+}
+
+/*
+ * Skewed picks are the smallest of three uniform ones.
+ */
+int generatePick(struct GenerateRandom *random, int count,
+                 enum GenerateSpread spread)
+{
+  int result, other, i;
+
+  result = (int) (generateNext(random) % (unsigned long) count);
+
+  if (spread == GENERATE_SKEWED) {
+    for (i = 0; i < 2; i++) {
+      other = (int) (generateNext(random) % (unsigned long) count);
+
+      if (other < result) {
+        result = other;
+      }
+    }
+  }
+
+  return result;
+}
+
+/*
+ * One to four words, then the number so every name is different.
+ */
+void generateName(int number, char *output)
+{
+  int word_count, i;
+
+  word_count = number % 4 + 1;
+  output[0] = '\0';
+
+  for (i = 0; i < word_count; i++) {
+    strcat(output, words[(number / (i + 1) + i * 5) % WORD_COUNT]);
+    strcat(output, " ");
+  }
+
+  sprintf(output + strlen(output), "%d", number);
+}
+
+void generateLocation(int number, char *output)
+{
+  sprintf(output, "%s Room %d", words[number % WORD_COUNT], number);
+}
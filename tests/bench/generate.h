@@ -0,0 +1,109 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Synthetic calendars for benchmarking.
+ *
+ * Calendars are made from a seed with our own random number
+ * generator, so the same settings give the same file on any machine.
+ * Events are spread over GENERATE_DAYS days from the start of 2013,
+ * start on a quarter hour, and last from 15 minutes to 4 hours.
+ */
+
+#ifndef GENERATE_H_
+#define GENERATE_H_
+
+#include <stddef.h>
+
+#include "bool.h"
+
+/*
+ * Number of days the events are spread over.
+ */
+#define GENERATE_DAYS 730
+
+/*
+ * Longest name or location made, including the terminator.
+ */
+#define GENERATE_STRING_SIZE 80
+
+/*
+ * How names and locations are picked.
+ *
+ * GENERATE_UNIFORM - All equally likely.
+ * GENERATE_SKEWED - The first few are much more likely, like a real
+ *                   calendar with a handful of regular events.
+ */
+enum GenerateSpread {
+  GENERATE_UNIFORM,
+  GENERATE_SKEWED
+};
+
+/*
+ * Settings for a calendar.
+ *
+ * event_count - Number of events.
+ * seed - Seed for the random numbers, anything but 0.
+ * name_count - Number of different names.
+ * location_count - Number of different locations.
+ * location_percent - Percentage of events that have a location.
+ * spread - How names and locations are picked.
+ */
+struct GenerateConfig {
+  int event_count;
+  unsigned long seed;
+  int name_count;
+  int location_count;
+  int location_percent;
+  enum GenerateSpread spread;
+};
+
+/*
+ * Random number generator state.
+ */
+struct GenerateRandom {
+  unsigned long state;
+};
+
+/*
+ * Fill in the default settings: 10000 events, seed 1, 500 names, 50
+ * locations, 70% with a location, skewed.
+ */
+void generateDefaults(struct GenerateConfig *config);
+
+/*
+ * Write a calendar file with the settings.
+ *
+ * Returns FALSE if the file couldn't be written.
+ */
+Boolean generateCalendar(const struct GenerateConfig *const config,
+                         const char *const filename);
+
+/*
+ * Start a random number generator, seed 0 is treated as 1.
+ */
+void generateSeed(struct GenerateRandom *random, unsigned long seed);
+
+/*
+ * Next random number, from 0 to GENERATE_RANDOM_MAX.
+ */
+#define GENERATE_RANDOM_MAX 2147483645UL
+unsigned long generateNext(struct GenerateRandom *random);
+
+/*
+ * Random number from 0 to count - 1, picked with the spread.
+ */
+int generatePick(struct GenerateRandom *random, int count,
+                 enum GenerateSpread spread);
+
+/*
+ * The name or location with the given number, each number always
+ * gives the same string. The lengths vary like real ones do.
+ *
+ * output - At least GENERATE_STRING_SIZE long.
+ */
+void generateName(int number, char *output);
+void generateLocation(int number, char *output);
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * The malloc wrappers, only used by the unit tests.
+ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include "alloc_counter.h"
+
+/*
+ * The size is kept in front of each block, in something big enough
+ * that the block after it is still aligned for anything.
+ */
+union AllocHeader {
+  size_t size;
+  long double real;
+  long long whole;
+  void *pointer;
+};
+
+/*
+ * The real functions, provided by the linker.
+ */
+void *__real_malloc(size_t size);
+void *__real_realloc(void *block, size_t size);
+void __real_free(void *block);
+
+/*
+ * Forward declarations, the wrappers are only called through the
+ * linker.
+ */
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+void *__wrap_realloc(void *block, size_t size);
+void __wrap_free(void *block);
+static void addBytes(long bytes, long new_allocations);
+static int allocationAllowed();
+
+/*
+ * Shared list tests allocate from more than one thread.
+ */
+static pthread_mutex_t counter_lock = PTHREAD_MUTEX_INITIALIZER;
+static long total_bytes;
+static long baseline_bytes;
+static long peak_bytes;
+static long allocations;
+static long frees;
+static long fail_after = -1;
+
+void allocCounterReset()
+{
+  pthread_mutex_lock(&counter_lock);
+  baseline_bytes = total_bytes;
+  peak_bytes = total_bytes;
+  allocations = 0;
+  frees = 0;
+  pthread_mutex_unlock(&counter_lock);
+}
+
+void allocCounterGet(struct AllocCounts *counts)
+{
+  pthread_mutex_lock(&counter_lock);
+  counts->allocations = allocations;
+  counts->frees = frees;
+  counts->bytes = total_bytes - baseline_bytes;
+  counts->peak_bytes = peak_bytes - baseline_bytes;
+  pthread_mutex_unlock(&counter_lock);
+}
+
+void allocCounterFailAfter(long allocations)
+{
+  pthread_mutex_lock(&counter_lock);
+  fail_after = allocations;
+  pthread_mutex_unlock(&counter_lock);
+}
+
+void *__wrap_malloc(size_t size)
+{
+  union AllocHeader *header;
+  void *result;
+
+  result = NULL;
+  header = NULL;
+
+  if (allocationAllowed()) {
+    header = (union AllocHeader *)
+             __real_malloc(sizeof(union AllocHeader) + size);
+  }
+
+  if (header != NULL) {
+    header->size = size;
+    addBytes((long) size, 1);
+    result = header + 1;
+  }
+
+  return result;
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+  void *result;
+
+  result = NULL;
+
+  /* Same overflow check calloc does. */
+  if (size == 0 || count <= (size_t) -1 / size) {
+    result = __wrap_malloc(count * size);
+
+    if (result != NULL) {
+      memset(result, 0, count * size);
+    }
+  }
+
+  return result;
+}
+
+void *__wrap_realloc(void *block, size_t size)
+{
+  union AllocHeader *header;
+  size_t old_size;
+  void *result;
+
+  result = NULL;
+
+  if (block == NULL) {
+    result = __wrap_malloc(size);
+  } else {
+    header = (union AllocHeader *) block - 1;
+    old_size = header->size;
+
+    if (allocationAllowed()) {
+      header = (union AllocHeader *)
+               __real_realloc(header, sizeof(union AllocHeader) + size);
+    } else {
+      header = NULL;
+    }
+
+    /* A failed realloc leaves the old block alone. */
+    if (header != NULL) {
+      header->size = size;
+      addBytes((long) size - (long) old_size, 1);
+      result = header + 1;
+    }
+  }
+
+  return result;
+}
+
+void __wrap_free(void *block)
+{
+  union AllocHeader *header;
+
+  if (block != NULL) {
+    header = (union AllocHeader *) block - 1;
+
+    pthread_mutex_lock(&counter_lock);
+    total_bytes -= (long) header->size;
+    frees++;
+    pthread_mutex_unlock(&counter_lock);
+
+    __real_free(header);
+  }
+}
+
+static void addBytes(long bytes, long new_allocations)
+{
+  pthread_mutex_lock(&counter_lock);
+  total_bytes += bytes;
+  allocations += new_allocations;
+
+  if (total_bytes > peak_bytes) {
+    peak_bytes = total_bytes;
+  }
+
+  pthread_mutex_unlock(&counter_lock);
+}
+
+/*
+ * Counts down to the allocation that should fail, see
+ * allocCounterFailAfter.
+ */
+static int allocationAllowed()
+{
+  int result;
+
+  pthread_mutex_lock(&counter_lock);
+  result = (fail_after != 0);
+
+  if (fail_after > 0) {
+    fail_after--;
+  }
+
+  pthread_mutex_unlock(&counter_lock);
+
+  return result;
+}
@@ -0,0 +1,57 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Counting the memory the code under test allocates.
+ *
+ * The unit tests are linked with -Wl,--wrap for malloc, calloc,
+ * realloc and free (see UTLIBS in the Makefile), so every call to
+ * them from our own code goes through the wrappers in
+ * alloc_counter.c first. Calls from inside the C library and CUnit
+ * aren't wrapped, and don't get counted.
+ *
+ * Each block has its size stored just before it, so frees can take
+ * it back off the total. That means anything allocated by the C
+ * library must never be freed by our code, which it isn't.
+ */
+
+#ifndef ALLOC_COUNTER_H_
+#define ALLOC_COUNTER_H_
+
+#include <stddef.h>
+
+/*
+ * Counts since the last allocCounterReset.
+ *
+ * allocations - Number of successful malloc, calloc and realloc calls.
+ * frees - Number of free calls with a block.
+ * bytes - Bytes allocated now, less what was allocated at the reset.
+ *         Negative if more was freed than allocated.
+ * peak_bytes - Most bytes was ever at, same as bytes at the reset.
+ */
+struct AllocCounts {
+  long allocations;
+  long frees;
+  long bytes;
+  long peak_bytes;
+};
+
+/*
+ * Start counting from now.
+ */
+void allocCounterReset();
+
+/*
+ * Get the counts so far.
+ */
+void allocCounterGet(struct AllocCounts *counts);
+
+/*
+ * Let the next allocations calls to malloc, calloc and realloc work,
+ * then fail every one after that, for testing running out of memory.
+ * Negative turns failing back off, which is how it starts.
+ */
+void allocCounterFailAfter(long allocations);
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "alloc_test.h"
+#include "calendar_file.h"
+#include "event_list.h"
+#include "test_calendar.h"
+
+#define ALLOC_TEST_FILE "saved/alloc.txt"
+#define ALLOC_TEST_EVENTS 1000
+
+/*
+ * The budgets.
+ *
+ * ALLOC_LOAD_PER_EVENT - Blocks allocated for each event loaded. It
+ *                        is the name and location read from the file
+ *                        and the formatted string, the events and
+ *                        nodes come from slabs.
+ * ALLOC_STRING_SLACK - Bytes eventListString can use on top of the
+ *                      string it returns.
+ */
+#define ALLOC_LOAD_PER_EVENT 4
+#define ALLOC_STRING_SLACK 1024
+
+/*
+ * Longer than EVENT_INLINE_NAME_SIZE, so it has to be allocated.
+ */
+#define ALLOC_LONG_NAME "A name much too long to keep inside the event itself"
+
+/*
+ * Write the test calendar, with every tenth name too long to keep in
+ * the event.
+ */
+static void writeCalendar(void)
+{
+  FILE *calendar;
+  struct TestCalendarEvent fields;
+  int i;
+
+  calendar = fopen(ALLOC_TEST_FILE, "w");
+  CU_ASSERT_PTR_NOT_NULL_FATAL(calendar);
+
+  for (i = 0; i < ALLOC_TEST_EVENTS; i++) {
+    testCalendarEvent(i, &fields);
+    fprintf(calendar, "%s %s %d %s\n", fields.date, fields.time,
+            fields.duration, i % 10 == 0 ? ALLOC_LONG_NAME : fields.name);
+
+    if (fields.location[0] != '\0') {
+      fprintf(calendar, "%s\n", fields.location);
+    }
+
+    fprintf(calendar, "\n");
+  }
+
+  fclose(calendar);
+}
+
+static struct EventList *loadTestList(void)
+{
+  struct EventList *list;
+
+  writeCalendar();
+  list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(list);
+  CU_ASSERT_EQUAL_FATAL(loadCalendar(list, ALLOC_TEST_FILE), FILE_NO_ERROR);
+
+  return list;
+}
+
+void testAllocLoadBudget() {
+  struct EventList *test_list;
+  struct AllocCounts counts;
+
+  writeCalendar();
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+
+  allocCounterReset();
+  CU_ASSERT_EQUAL(loadCalendar(test_list, ALLOC_TEST_FILE), FILE_NO_ERROR);
+  allocCounterGet(&counts);
+
+  CU_ASSERT_TRUE(counts.allocations > 0);
+  CU_ASSERT_TRUE(counts.allocations <=
+                 (long) ALLOC_LOAD_PER_EVENT * ALLOC_TEST_EVENTS);
+
+  eventListDestroy(test_list);
+}
+
+void testAllocIterateBudget() {
+  struct EventList *test_list;
+  struct AllocCounts counts;
+  struct Event *event;
+  int count;
+
+  test_list = loadTestList();
+
+  allocCounterReset();
+  count = 0;
+  eventListResetPosition(test_list);
+
+  while ((event = eventListNext(test_list)) != NULL) {
+    count++;
+  }
+
+  allocCounterGet(&counts);
+
+  CU_ASSERT_EQUAL(count, ALLOC_TEST_EVENTS);
+  CU_ASSERT_EQUAL(counts.allocations, 0);
+  CU_ASSERT_EQUAL(counts.frees, 0);
+
+  eventListDestroy(test_list);
+}
+
+void testAllocStringBudget() {
+  struct EventList *test_list;
+  struct AllocCounts counts;
+  char *calendar_text;
+  long length;
+
+  test_list = loadTestList();
+
+  allocCounterReset();
+  calendar_text = eventListString(test_list);
+  allocCounterGet(&counts);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(calendar_text);
+
+  length = (long) strlen(calendar_text) + 1;
+  CU_ASSERT_TRUE(counts.peak_bytes >= length);
+  CU_ASSERT_TRUE(counts.peak_bytes <= length + ALLOC_STRING_SLACK);
+
+  free(calendar_text);
+  eventListDestroy(test_list);
+}
+
+void testAllocDestroyFreesAll() {
+  struct EventList *test_list;
+  struct AllocCounts counts;
+
+  writeCalendar();
+
+  allocCounterReset();
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+  CU_ASSERT_EQUAL(loadCalendar(test_list, ALLOC_TEST_FILE), FILE_NO_ERROR);
+  eventListDestroy(test_list);
+  allocCounterGet(&counts);
+
+  CU_ASSERT_TRUE(counts.peak_bytes > 0);
+  CU_ASSERT_EQUAL(counts.bytes, 0);
+  CU_ASSERT_EQUAL(counts.frees, counts.allocations);
+}
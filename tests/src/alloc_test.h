@@ -0,0 +1,27 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Allocation budgets for the hot paths, a test failing here means a
+ * change made something allocate more than it used to.
+ */
+
+#ifndef ALLOC_TEST_H_
+#define ALLOC_TEST_H_
+
+#include "alloc_counter.h"
+
+/* Loading allocates a bounded number of blocks per event. */
+void testAllocLoadBudget();
+
+/* Going through the list allocates nothing. */
+void testAllocIterateBudget();
+
+/* The calendar text needs little more than its own size. */
+void testAllocStringBudget();
+
+/* Destroying a loaded list gives back everything it allocated. */
+void testAllocDestroyFreesAll();
+
+#endif
@@ -1 +0,0 @@
-../../src/bool.h
\ No newline at end of file
@@ -1 +0,0 @@
-../../src/calendar_file.c
\ No newline at end of file
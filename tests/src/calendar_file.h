@@ -1 +0,0 @@
-../../src/calendar_file.h
\ No newline at end of file
@@ -4,6 +4,8 @@
  * Author: Mike Aldred
  */
 
+#include <stdio.h>
+
 #include <CUnit/CUnit.h>
 
 #include "calendar_file_test.h"
@@ -73,3 +75,88 @@ void testCalendarSaveOverDir() {
 
   CU_ASSERT_PTR_NOT_NULL(test_list->head);
 }
+
+void testCalendarIds() {
+  const char *const bad_ids[] = {"none", "0", "-1", "+1",
+                                 "18446744073709551615",
+                                 "99999999999999999999",
+                                 "123456789012345678901"};
+  struct EventList *test_list, *loaded_list;
+  struct EventListNode *node, *loaded_node;
+  struct Event *event;
+  enum FileError error_result;
+  FILE *bad_file;
+  int i;
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+
+  /* Files from before ids load, and their events are given new ones. */
+  error_result = loadCalendar(test_list, "data/test.txt");
+  CU_ASSERT_EQUAL(FILE_NO_ERROR, error_result);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list->head);
+  CU_ASSERT_NOT_EQUAL(test_list->head->event->id, EVENT_NO_ID);
+
+  /* So the ids saved aren't just the ones a load would give out. */
+  CU_ASSERT_TRUE(eventListDelete(test_list, test_list->head->event));
+
+  error_result = saveCalendar(test_list, "saved/ids.txt");
+  CU_ASSERT_EQUAL(FILE_NO_ERROR, error_result);
+
+  loaded_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(loaded_list);
+
+  error_result = loadCalendar(loaded_list, "saved/ids.txt");
+  CU_ASSERT_EQUAL(FILE_NO_ERROR, error_result);
+  CU_ASSERT_EQUAL(eventListCount(loaded_list), eventListCount(test_list));
+
+  for (node = test_list->head, loaded_node = loaded_list->head;
+       node != NULL && loaded_node != NULL;
+       node = node->next, loaded_node = loaded_node->next) {
+    CU_ASSERT_EQUAL(loaded_node->event->id, node->event->id);
+    CU_ASSERT_STRING_EQUAL(loaded_node->event->name, node->event->name);
+  }
+
+  eventListDestroy(loaded_list);
+  eventListDestroy(test_list);
+
+  /* An id line without a valid id is an invalid file. */
+  for (i = 0; i < (int) (sizeof(bad_ids) / sizeof(bad_ids[0])); i++) {
+    bad_file = fopen("saved/bad-id.txt", "wb");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(bad_file);
+    fprintf(bad_file, "#id %s\n2013-11-08 10:00 75 Veg out\nHome\n",
+            bad_ids[i]);
+    fclose(bad_file);
+
+    test_list = eventListCreate();
+    CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+
+    error_result = loadCalendar(test_list, "saved/bad-id.txt");
+    CU_ASSERT_EQUAL(FILE_INVALID_FORMAT, error_result);
+
+    eventListDestroy(test_list);
+  }
+
+  /* The highest id loads, but then there are none left to give out. */
+  bad_file = fopen("saved/last-id.txt", "wb");
+  CU_ASSERT_PTR_NOT_NULL_FATAL(bad_file);
+  fprintf(bad_file, "#id %llu\n2013-11-08 10:00 75 Veg out\nHome\n",
+          EVENT_LAST_ID);
+  fclose(bad_file);
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+
+  error_result = loadCalendar(test_list, "saved/last-id.txt");
+  CU_ASSERT_EQUAL(FILE_NO_ERROR, error_result);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list->head);
+  CU_ASSERT_EQUAL(test_list->head->event->id, EVENT_LAST_ID);
+
+  eventCreate(&event, "2013-11-09", "10:00", 75, "Veg out again", NULL);
+  CU_ASSERT_FALSE(eventListInsertLast(test_list, event));
+  CU_ASSERT_EQUAL(event->id, EVENT_NO_ID);
+  CU_ASSERT_EQUAL(eventListCount(test_list), 1);
+  eventDestroy(event);
+
+  eventListDestroy(test_list);
+}
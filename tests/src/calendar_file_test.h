@@ -17,4 +17,6 @@ void testCalendarSaveFile();
 
 void testCalendarSaveOverDir();
 
+void testCalendarIds();
+
 #endif
@@ -1,6 +1,16 @@
+#include <stdio.h>
+
 #include <CUnit/CUnit.h>
 
 #include "date_test.h"
+#include "date_time_batch.h"
+
+/*
+ * Strings for checking the batch parsers against the single ones.
+ * A mix of valid, invalid, fixed width and not fixed width.
+ */
+#define BATCH_DATE_COUNT 13
+#define BATCH_TIME_COUNT 11
 
 void testDateParseValidDate() {
   enum DateTimeError result;
@@ -160,3 +170,279 @@ void testDurationStringOutput() {
   durationString(result, 25920);
   CU_ASSERT_STRING_EQUAL("(432 hours)", result);
 }
+
+void testTimestampKnownValues() {
+  struct Date date;
+  struct Time time;
+  Timestamp midnight;
+
+  dateParse("0001-01-01", &date);
+  timeParse("00:00", &time);
+  CU_ASSERT_EQUAL(0, timestampFromDateTime(&date, &time));
+
+  timeParse("01:30", &time);
+  CU_ASSERT_EQUAL(90, timestampFromDateTime(&date, &time));
+
+  dateParse("0001-01-02", &date);
+  timeParse("00:00", &time);
+  CU_ASSERT_EQUAL(1440, timestampFromDateTime(&date, &time));
+
+  /* 24:00 is the same as the start of the next day. */
+  dateParse("2000-02-29", &date);
+  timeParse("24:00", &time);
+  midnight = timestampFromDateTime(&date, &time);
+  dateParse("2000-03-01", &date);
+  timeParse("00:00", &time);
+  CU_ASSERT_EQUAL(midnight, timestampFromDateTime(&date, &time));
+
+  timestampToDateTime(midnight, &date, &time);
+  CU_ASSERT_EQUAL(2000, date.year);
+  CU_ASSERT_EQUAL(3, date.month);
+  CU_ASSERT_EQUAL(1, date.day);
+  CU_ASSERT_EQUAL(0, time.hour);
+  CU_ASSERT_EQUAL(0, time.minutes);
+}
+
+/*
+ * Go through every day for a few centuries, including the 1900 and
+ * 2000 leap year rules. Each should unpack to the same date, and be
+ * exactly one day after the one before.
+ */
+void testTimestampRoundTrip() {
+  struct Date date, unpacked_date;
+  struct Time time, unpacked_time;
+  Timestamp previous, current;
+  char date_string[MAX_DATE_STRING];
+  Boolean all_match;
+  int year, month, day;
+
+  time.hour = 13;
+  time.minutes = 7;
+  all_match = TRUE;
+  previous = -1;
+
+  for (year = 1799; year <= 2101; year++) {
+    for (month = 1; month <= 12; month++) {
+      for (day = 1; day <= 31; day++) {
+        sprintf(date_string, "%04d-%02d-%02d", year, month, day);
+
+        if (dateParse(date_string, &date) == DATETIME_NO_ERROR) {
+          current = timestampFromDateTime(&date, &time);
+          timestampToDateTime(current, &unpacked_date, &unpacked_time);
+
+          if (unpacked_date.year != year || unpacked_date.month != month ||
+              unpacked_date.day != day || unpacked_time.hour != 13 ||
+              unpacked_time.minutes != 7) {
+            all_match = FALSE;
+          }
+
+          if (previous != -1 && current - previous != 1440) {
+            all_match = FALSE;
+          }
+
+          previous = current;
+        }
+      }
+    }
+  }
+
+  CU_ASSERT_TRUE(all_match);
+}
+
+void testDateAddDays() {
+  struct Date date;
+
+  dateParse("2013-12-31", &date);
+  CU_ASSERT_EQUAL(DATETIME_NO_ERROR, dateAddDays(&date, 1));
+  CU_ASSERT_EQUAL(2014, date.year);
+  CU_ASSERT_EQUAL(1, date.month);
+  CU_ASSERT_EQUAL(1, date.day);
+
+  dateParse("2016-03-01", &date);
+  CU_ASSERT_EQUAL(DATETIME_NO_ERROR, dateAddDays(&date, -1));
+  CU_ASSERT_EQUAL(2, date.month);
+  CU_ASSERT_EQUAL(29, date.day);
+
+  /* Can't go before the first date. */
+  dateParse("0001-01-02", &date);
+  CU_ASSERT_EQUAL(DATETIME_YEAR_INVALID, dateAddDays(&date, -2));
+  CU_ASSERT_EQUAL(1, date.year);
+  CU_ASSERT_EQUAL(2, date.day);
+}
+
+void testDateDifference() {
+  struct Date from, to;
+
+  dateParse("2013-11-08", &from);
+  dateParse("2014-06-30", &to);
+  CU_ASSERT_EQUAL(234, dateDifference(&from, &to));
+  CU_ASSERT_EQUAL(-234, dateDifference(&to, &from));
+
+  dateParse("2000-01-01", &from);
+  dateParse("2001-01-01", &to);
+  CU_ASSERT_EQUAL(366, dateDifference(&from, &to));
+
+  dateParse("1900-01-01", &from);
+  dateParse("1901-01-01", &to);
+  CU_ASSERT_EQUAL(365, dateDifference(&from, &to));
+}
+
+void testDateWeekday() {
+  struct Date date;
+
+  dateParse("2013-11-08", &date);
+  CU_ASSERT_EQUAL(WEEKDAY_FRIDAY, dateWeekday(&date));
+
+  dateParse("2000-01-01", &date);
+  CU_ASSERT_EQUAL(WEEKDAY_SATURDAY, dateWeekday(&date));
+
+  dateParse("0001-01-01", &date);
+  CU_ASSERT_EQUAL(WEEKDAY_MONDAY, dateWeekday(&date));
+
+  dateParse("2014-06-29", &date);
+  CU_ASSERT_EQUAL(WEEKDAY_SUNDAY, dateWeekday(&date));
+}
+
+void testDateIsoWeek() {
+  struct Date date;
+  int week_year, week;
+
+  dateParse("2013-11-08", &date);
+  dateIsoWeek(&date, &week_year, &week);
+  CU_ASSERT_EQUAL(2013, week_year);
+  CU_ASSERT_EQUAL(45, week);
+
+  /* Start of the next year's week 1. */
+  dateParse("2008-12-29", &date);
+  dateIsoWeek(&date, &week_year, &week);
+  CU_ASSERT_EQUAL(2009, week_year);
+  CU_ASSERT_EQUAL(1, week);
+
+  /* End of the last year's week 53. */
+  dateParse("2010-01-03", &date);
+  dateIsoWeek(&date, &week_year, &week);
+  CU_ASSERT_EQUAL(2009, week_year);
+  CU_ASSERT_EQUAL(53, week);
+
+  dateParse("2005-01-01", &date);
+  dateIsoWeek(&date, &week_year, &week);
+  CU_ASSERT_EQUAL(2004, week_year);
+  CU_ASSERT_EQUAL(53, week);
+
+  dateParse("0001-01-01", &date);
+  dateIsoWeek(&date, &week_year, &week);
+  CU_ASSERT_EQUAL(1, week_year);
+  CU_ASSERT_EQUAL(1, week);
+}
+
+void testDateTimeAddMinutes() {
+  struct Date date;
+  struct Time time;
+
+  /* Armageddon from the test calendar, 18 days long. */
+  dateParse("2014-06-30", &date);
+  timeParse("23:59", &time);
+  dateTimeAddMinutes(&date, &time, 25920);
+  CU_ASSERT_EQUAL(2014, date.year);
+  CU_ASSERT_EQUAL(7, date.month);
+  CU_ASSERT_EQUAL(18, date.day);
+  CU_ASSERT_EQUAL(23, time.hour);
+  CU_ASSERT_EQUAL(59, time.minutes);
+
+  /* Over midnight, and the end of the year. */
+  dateParse("2013-12-31", &date);
+  timeParse("23:30", &time);
+  dateTimeAddMinutes(&date, &time, 45);
+  CU_ASSERT_EQUAL(2014, date.year);
+  CU_ASSERT_EQUAL(1, date.month);
+  CU_ASSERT_EQUAL(1, date.day);
+  CU_ASSERT_EQUAL(0, time.hour);
+  CU_ASSERT_EQUAL(15, time.minutes);
+}
+
+void testDateParseBatch() {
+  const char *const st_dates[BATCH_DATE_COUNT] = {
+    "2010-05-24", "2016-02-29", "1900-02-29", "2010-12-32", "2010-13-01",
+    "0000-01-01", "0-13-32", "2010-04032", "2010/05/24", "2010-5-24",
+    "20100-05-24", "abcdefghij", "2010"
+  };
+  struct Date batch_dates[BATCH_DATE_COUNT], single_date;
+  enum DateTimeError batch_errors[BATCH_DATE_COUNT], single_error;
+  Boolean all_match;
+  int i;
+
+  /* So dates with errors have to be zeroed, not just left alone. */
+  for (i = 0; i < BATCH_DATE_COUNT; i++) {
+    batch_dates[i].year = 1;
+    batch_dates[i].month = 1;
+    batch_dates[i].day = 1;
+  }
+
+  dateParseBatch(st_dates, batch_dates, batch_errors, BATCH_DATE_COUNT);
+
+  CU_ASSERT_EQUAL(DATETIME_NO_ERROR, batch_errors[0]);
+  CU_ASSERT_EQUAL(2010, batch_dates[0].year);
+  CU_ASSERT_EQUAL(5, batch_dates[0].month);
+  CU_ASSERT_EQUAL(24, batch_dates[0].day);
+  CU_ASSERT_EQUAL(DATETIME_DAY_INVALID, batch_errors[2]);
+
+  all_match = TRUE;
+
+  for (i = 0; i < BATCH_DATE_COUNT; i++) {
+    single_error = dateParse(st_dates[i], &single_date);
+
+    if (single_error != batch_errors[i]) {
+      all_match = FALSE;
+    } else if (single_error == DATETIME_NO_ERROR) {
+      all_match = all_match && single_date.year == batch_dates[i].year &&
+                  single_date.month == batch_dates[i].month &&
+                  single_date.day == batch_dates[i].day;
+    } else {
+      all_match = all_match && batch_dates[i].year == 0 &&
+                  batch_dates[i].month == 0 && batch_dates[i].day == 0;
+    }
+  }
+
+  CU_ASSERT_TRUE(all_match);
+}
+
+void testTimeParseBatch() {
+  const char *const st_times[BATCH_TIME_COUNT] = {
+    "18:05", "00:00", "24:00", "24:01", "25:00", "12:60", "1:05",
+    "Adfdds", "18-05", "18:055", "1"
+  };
+  struct Time batch_times[BATCH_TIME_COUNT], single_time;
+  enum DateTimeError batch_errors[BATCH_TIME_COUNT], single_error;
+  Boolean all_match;
+  int i;
+
+  for (i = 0; i < BATCH_TIME_COUNT; i++) {
+    batch_times[i].hour = 1;
+    batch_times[i].minutes = 1;
+  }
+
+  timeParseBatch(st_times, batch_times, batch_errors, BATCH_TIME_COUNT);
+
+  CU_ASSERT_EQUAL(DATETIME_NO_ERROR, batch_errors[0]);
+  CU_ASSERT_EQUAL(18, batch_times[0].hour);
+  CU_ASSERT_EQUAL(5, batch_times[0].minutes);
+  CU_ASSERT_EQUAL(DATETIME_MINUTES_INVALID, batch_errors[3]);
+
+  all_match = TRUE;
+
+  for (i = 0; i < BATCH_TIME_COUNT; i++) {
+    single_error = timeParse(st_times[i], &single_time);
+
+    if (single_error != batch_errors[i]) {
+      all_match = FALSE;
+    } else if (single_error == DATETIME_NO_ERROR) {
+      all_match = all_match && single_time.hour == batch_times[i].hour &&
+                  single_time.minutes == batch_times[i].minutes;
+    } else {
+      all_match = all_match && batch_times[i].hour == 0 &&
+                  batch_times[i].minutes == 0;
+    }
+  }
+
+  CU_ASSERT_TRUE(all_match);
+}
@@ -1,6 +1,7 @@
 #ifndef DATE_TEST_H_
 #define DATE_TEST_H_
 
+#include "bool.h"
 #include "date_time.h"
 
 void testDateParseValidDate();
@@ -27,4 +28,22 @@ void testTimeStringOutput();
 
 void testDurationStringOutput();
 
+void testTimestampKnownValues();
+
+void testTimestampRoundTrip();
+
+void testDateAddDays();
+
+void testDateDifference();
+
+void testDateWeekday();
+
+void testDateIsoWeek();
+
+void testDateTimeAddMinutes();
+
+void testDateParseBatch();
+
+void testTimeParseBatch();
+
 #endif
@@ -1 +0,0 @@
-../../src/date_time.c
\ No newline at end of file
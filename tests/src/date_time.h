@@ -1 +0,0 @@
-../../src/date_time.h
\ No newline at end of file
@@ -1 +0,0 @@
-../../src/event.c
\ No newline at end of file
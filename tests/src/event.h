@@ -1 +0,0 @@
-../../src/event.h
\ No newline at end of file
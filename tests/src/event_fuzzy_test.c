@@ -0,0 +1,193 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "event_fuzzy_test.h"
+
+#define FUZZY_TEST_EVENTS 500
+#define FUZZY_TEST_MATCHES 8
+#define FUZZY_TEST_LONG 100
+
+static const char *syllables[] = {
+  "ka", "lo", "mer", "tin", "sa", "ve", "dro", "pi", "nu", "gal"
+};
+
+/*
+ * Made up names of two to four syllables, from a simple generator so
+ * every run is the same.
+ */
+static void fuzzyTestName(int number, char *name)
+{
+  unsigned long state;
+  int syllable_count, i;
+
+  state = (unsigned long) number * 7919 + 17;
+  syllable_count = 2 + number % 3;
+  name[0] = '\0';
+
+  for (i = 0; i < syllable_count; i++) {
+    state = (state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    strcat(name, syllables[(state >> 8) % 10]);
+  }
+}
+
+static struct EventList *fuzzyTestList(void)
+{
+  struct EventList *list;
+  struct Event *event;
+  char name[20];
+  int i;
+
+  list = eventListCreate();
+
+  for (i = 0; i < FUZZY_TEST_EVENTS; i++) {
+    fuzzyTestName(i, name);
+    eventCreate(&event, "2013-05-01", "10:00", 30, name, NULL);
+    eventListInsertLast(list, event);
+  }
+
+  return list;
+}
+
+void testEventFuzzyDistance() {
+  char first[FUZZY_TEST_LONG + 1], second[FUZZY_TEST_LONG + 1];
+
+  CU_ASSERT_EQUAL(eventFuzzyDistance("kitten", "sitting"), 3);
+  CU_ASSERT_EQUAL(eventFuzzyDistance("sitting", "kitten"), 3);
+  CU_ASSERT_EQUAL(eventFuzzyDistance("Team Meeting", "team meeting"), 0);
+  CU_ASSERT_EQUAL(eventFuzzyDistance("", "abc"), 3);
+  CU_ASSERT_EQUAL(eventFuzzyDistance("abc", ""), 3);
+  CU_ASSERT_EQUAL(eventFuzzyDistance("lunch", "lnuch"), 2);
+  CU_ASSERT_EQUAL(eventFuzzyDistance("dentist", "dentists"), 1);
+
+  /* Longer than a word, so it's done with the table. */
+  memset(first, 'a', FUZZY_TEST_LONG);
+  first[FUZZY_TEST_LONG] = '\0';
+  strcpy(second, first);
+  second[10] = 'b';
+  second[FUZZY_TEST_LONG - 3] = '\0';
+  CU_ASSERT_EQUAL(eventFuzzyDistance(first, second), 4);
+  CU_ASSERT_EQUAL(eventFuzzyDistance(second, first), 4);
+}
+
+void testEventFuzzyFind() {
+  struct EventList *list;
+  struct EventFuzzyIndex *index;
+  struct EventFuzzyMatch matches[FUZZY_TEST_MATCHES];
+  struct Event *event;
+  int count, i;
+
+  list = eventListCreate();
+  eventCreate(&event, "2013-05-01", "10:00", 30, "Dentist", NULL);
+  eventListInsertLast(list, event);
+  eventCreate(&event, "2013-05-02", "10:00", 30, "Team meeting", NULL);
+  eventListInsertLast(list, event);
+  eventCreate(&event, "2013-05-03", "10:00", 30, "Dentists dinner", NULL);
+  eventListInsertLast(list, event);
+  eventCreate(&event, "2013-05-04", "10:00", 30, "Team meetings", NULL);
+  eventListInsertLast(list, event);
+
+  index = eventFuzzyCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+  CU_ASSERT_EQUAL(index->count, 4);
+
+  count = eventFuzzyFind(index, "TEAM meting", -1, matches,
+                         FUZZY_TEST_MATCHES);
+  CU_ASSERT_EQUAL_FATAL(count, 2);
+  CU_ASSERT_STRING_EQUAL(matches[0].event->name, "Team meeting");
+  CU_ASSERT_EQUAL(matches[0].distance, 1);
+  CU_ASSERT_STRING_EQUAL(matches[1].event->name, "Team meetings");
+  CU_ASSERT_EQUAL(matches[1].distance, 2);
+
+  /* A swap is two edits, more than the default for a short name. */
+  CU_ASSERT_EQUAL(eventFuzzyFind(index, "taem meeting", 1, matches,
+                                 FUZZY_TEST_MATCHES), 0);
+
+  count = eventFuzzyFind(index, "dentst", -1, matches, FUZZY_TEST_MATCHES);
+  CU_ASSERT_EQUAL_FATAL(count, 1);
+  CU_ASSERT_STRING_EQUAL(matches[0].event->name, "Dentist");
+
+  /* Only as many as asked for. */
+  count = eventFuzzyFind(index, "x", 20, matches, 3);
+  CU_ASSERT_EQUAL(count, 3);
+
+  for (i = 1; i < count; i++) {
+    CU_ASSERT_TRUE(matches[i - 1].distance <= matches[i].distance);
+  }
+
+  CU_ASSERT_EQUAL(eventFuzzyFind(index, "holiday", -1, matches,
+                                 FUZZY_TEST_MATCHES), 0);
+
+  eventFuzzyDestroy(index);
+  eventListDestroy(list);
+}
+
+void testEventFuzzyFilter() {
+  struct EventList *list;
+  struct EventFuzzyIndex *index;
+  struct EventFuzzyMatch matches[FUZZY_TEST_EVENTS];
+  char query[20];
+  int count, expected, query_number, distance, i;
+
+  list = fuzzyTestList();
+  index = eventFuzzyCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  for (query_number = 0; query_number < 50; query_number++) {
+    /* A name from the list with one letter changed. */
+    fuzzyTestName(query_number * 9, query);
+    query[query_number % strlen(query)] = 'z';
+
+    for (distance = 1; distance <= 3; distance++) {
+      expected = 0;
+
+      for (i = 0; i < index->count; i++) {
+        if (eventFuzzyDistance(query, index->events[i]->name) <= distance) {
+          expected++;
+        }
+      }
+
+      count = eventFuzzyFind(index, query, distance, matches,
+                             FUZZY_TEST_EVENTS);
+      CU_ASSERT_EQUAL(count, expected);
+      CU_ASSERT_TRUE(count >= 1);
+
+      for (i = 0; i < count; i++) {
+        CU_ASSERT_EQUAL(matches[i].distance,
+                        eventFuzzyDistance(query, matches[i].event->name));
+      }
+    }
+  }
+
+  eventFuzzyDestroy(index);
+  eventListDestroy(list);
+}
+
+void testEventFuzzyCurrent() {
+  struct EventList *list, *other_list;
+  struct EventFuzzyIndex *index;
+  struct Event *event;
+
+  list = fuzzyTestList();
+  other_list = eventListCreate();
+  index = eventFuzzyCreate(list);
+
+  CU_ASSERT_FALSE(eventFuzzyIsCurrent(NULL, list));
+  CU_ASSERT_TRUE(eventFuzzyIsCurrent(index, list));
+  CU_ASSERT_FALSE(eventFuzzyIsCurrent(index, other_list));
+
+  eventCreate(&event, "2013-05-01", "10:00", 30, "New", NULL);
+  eventListInsertLast(list, event);
+  CU_ASSERT_FALSE(eventFuzzyIsCurrent(index, list));
+
+  eventFuzzyDestroy(index);
+  eventListDestroy(list);
+  eventListDestroy(other_list);
+}
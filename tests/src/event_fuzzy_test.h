@@ -0,0 +1,26 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for fuzzy finding by name
+ */
+
+#ifndef EVENT_FUZZY_TEST_H_
+#define EVENT_FUZZY_TEST_H_
+
+#include "event_fuzzy.h"
+
+/* Known distances, both algorithms, ignoring case. */
+void testEventFuzzyDistance();
+
+/* Typos find the right events, closest first. */
+void testEventFuzzyFind();
+
+/* The trigram filter never loses a match a full scan finds. */
+void testEventFuzzyFilter();
+
+/* Changing the list makes the index out of date. */
+void testEventFuzzyCurrent();
+
+#endif
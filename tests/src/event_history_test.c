@@ -0,0 +1,346 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "alloc_counter.h"
+#include "event_history_test.h"
+
+#define HISTORY_TEST_EVENTS 100
+
+/*
+ * Check the names of the events in the current version, in order,
+ * and that the list has the very same events.
+ */
+static Boolean historyNamesAre(const struct EventHistory *history,
+                               const struct EventList *list,
+                               const char *const names[], int count)
+{
+  const struct EventListNode *node;
+  Boolean result;
+  int i;
+
+  result = (eventHistoryCount(history) == count);
+  node = list->head;
+
+  for (i = 0; i < count && result; i++) {
+    result = (node != NULL && node->event == eventHistoryGet(history, i) &&
+              strcmp(node->event->name, names[i]) == 0);
+    node = node->next;
+  }
+
+  return result && node == NULL;
+}
+
+void testEventHistoryCreate() {
+  struct EventList *test_list;
+  struct EventHistory *history;
+  struct Event *test_event_one, *test_event_two;
+  const char *const names[] = {"Event 1", "Event 2"};
+
+  test_list = eventListCreate();
+  eventCreate(&test_event_one, "2010-05-24", "06:15", 10, "Event 1", "Home");
+  eventCreate(&test_event_two, "2011-05-24", "06:15", 10, "Event 2", NULL);
+  eventListInsertLast(test_list, test_event_one);
+  eventListInsertLast(test_list, test_event_two);
+
+  history = eventHistoryCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(history);
+  CU_ASSERT_TRUE(history->recording);
+  CU_ASSERT_TRUE(historyNamesAre(history, test_list, names, 2));
+  CU_ASSERT_EQUAL(eventHistoryUndo(history, test_list), HISTORY_EMPTY);
+  CU_ASSERT_EQUAL(eventHistoryRedo(history, test_list), HISTORY_EMPTY);
+
+  /* History has the list's events, not copies. */
+  CU_ASSERT_PTR_EQUAL(test_event_one, eventHistoryGet(history, 0));
+
+  eventHistoryDestroy(history);
+  eventListDestroy(test_list);
+}
+
+void testEventHistoryUndoRedo() {
+  struct EventList *test_list;
+  struct EventHistory *history;
+  struct Event *test_event, *deleted_event;
+  const char *const added[] = {"Event 1", "Event 2", "Event 3"};
+  const char *const deleted[] = {"Event 1", "Event 3"};
+  const char *const replaced[] = {"Event 1", "Edited"};
+
+  test_list = eventListCreate();
+  history = eventHistoryCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(history);
+
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Event 1", NULL);
+  CU_ASSERT_EQUAL(eventHistoryInsertLast(history, test_list, test_event),
+                  HISTORY_NO_ERROR);
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Event 2", NULL);
+  CU_ASSERT_EQUAL(eventHistoryInsertLast(history, test_list, test_event),
+                  HISTORY_NO_ERROR);
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Event 3", NULL);
+  CU_ASSERT_EQUAL(eventHistoryInsertLast(history, test_list, test_event),
+                  HISTORY_NO_ERROR);
+  CU_ASSERT_TRUE(historyNamesAre(history, test_list, added, 3));
+
+  deleted_event = test_list->head->next->event;
+  CU_ASSERT_EQUAL(eventHistoryDelete(history, test_list, deleted_event),
+                  HISTORY_NO_ERROR);
+  CU_ASSERT_EQUAL(eventHistoryDelete(history, test_list, deleted_event),
+                  HISTORY_LIST_ERROR);
+  CU_ASSERT_TRUE(historyNamesAre(history, test_list, deleted, 2));
+
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Edited", NULL);
+  CU_ASSERT_EQUAL(eventHistoryReplace(history, test_list,
+                                      test_list->tail->event, test_event),
+                  HISTORY_NO_ERROR);
+  CU_ASSERT_TRUE(historyNamesAre(history, test_list, replaced, 2));
+
+  CU_ASSERT_EQUAL(eventHistoryUndo(history, test_list), HISTORY_NO_ERROR);
+  CU_ASSERT_TRUE(historyNamesAre(history, test_list, deleted, 2));
+  CU_ASSERT_EQUAL(eventHistoryUndo(history, test_list), HISTORY_NO_ERROR);
+  CU_ASSERT_TRUE(historyNamesAre(history, test_list, added, 3));
+
+  /* The deleted event itself is put back, it keeps its id. */
+  CU_ASSERT_PTR_EQUAL(test_list->head->next->event, deleted_event);
+  CU_ASSERT_PTR_EQUAL(eventListFindId(test_list, deleted_event->id),
+                      deleted_event);
+
+  CU_ASSERT_EQUAL(eventHistoryRedo(history, test_list), HISTORY_NO_ERROR);
+  CU_ASSERT_EQUAL(eventHistoryRedo(history, test_list), HISTORY_NO_ERROR);
+  CU_ASSERT_TRUE(historyNamesAre(history, test_list, replaced, 2));
+  CU_ASSERT_EQUAL(eventHistoryRedo(history, test_list), HISTORY_EMPTY);
+
+  /* Undo all the way, then the adds go. */
+  while (eventHistoryUndo(history, test_list) == HISTORY_NO_ERROR) {
+  }
+
+  CU_ASSERT_EQUAL(eventHistoryCount(history), 0);
+  CU_ASSERT_PTR_NULL(test_list->head);
+
+  eventHistoryDestroy(history);
+  eventListDestroy(test_list);
+}
+
+void testEventHistoryVersionsShared() {
+  struct EventList *test_list;
+  struct EventHistory *history;
+  struct Event *test_event, *first_event;
+  struct EventListNode *node;
+  char name[MAX_LENGTH_OF_NAME];
+  Boolean in_order;
+  int i;
+
+  test_list = eventListCreate();
+  history = eventHistoryCreate(test_list);
+
+  for (i = 0; i < HISTORY_TEST_EVENTS; i++) {
+    sprintf(name, "Event %d", i);
+    eventCreate(&test_event, "2010-05-24", "06:15", i, name, NULL);
+    eventHistoryInsertLast(history, test_list, test_event);
+  }
+
+  first_event = test_list->head->event;
+
+  /* Delete all the even ones. */
+  node = test_list->head;
+
+  while (node != NULL) {
+    test_event = node->event;
+    node = node->next;
+
+    if (test_event->duration % 2 == 0) {
+      CU_ASSERT_EQUAL(eventHistoryDelete(history, test_list, test_event),
+                      HISTORY_NO_ERROR);
+    }
+  }
+
+  CU_ASSERT_EQUAL(HISTORY_TEST_EVENTS / 2, eventHistoryCount(history));
+  CU_ASSERT_EQUAL(HISTORY_TEST_EVENTS / 2, eventListCount(test_list));
+
+  in_order = TRUE;
+  for (i = 0; i < eventHistoryCount(history); i++) {
+    in_order = in_order && (eventHistoryGet(history, i)->duration == i * 2 + 1);
+  }
+  CU_ASSERT_TRUE(in_order);
+
+  /* Back to when all were added, every one should be there still. */
+  for (i = 0; i < HISTORY_TEST_EVENTS / 2; i++) {
+    eventHistoryUndo(history, test_list);
+  }
+
+  CU_ASSERT_EQUAL(HISTORY_TEST_EVENTS, eventHistoryCount(history));
+  CU_ASSERT_PTR_EQUAL(test_list->head->event, first_event);
+
+  in_order = TRUE;
+  for (node = test_list->head, i = 0; node != NULL;
+       node = node->next, i++) {
+    in_order = in_order && (node->event->duration == i) &&
+               (eventHistoryGet(history, i) == node->event);
+  }
+  CU_ASSERT_TRUE(in_order);
+  CU_ASSERT_EQUAL(i, HISTORY_TEST_EVENTS);
+
+  eventHistoryDestroy(history);
+  eventListDestroy(test_list);
+}
+
+void testEventHistoryChangeClearsRedo() {
+  struct EventList *test_list;
+  struct EventHistory *history;
+  struct Event *test_event;
+
+  test_list = eventListCreate();
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Event 1", NULL);
+  eventListInsertLast(test_list, test_event);
+
+  history = eventHistoryCreate(test_list);
+
+  CU_ASSERT_EQUAL(eventHistoryDelete(history, test_list, test_event),
+                  HISTORY_NO_ERROR);
+  CU_ASSERT_EQUAL(eventHistoryUndo(history, test_list), HISTORY_NO_ERROR);
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Event 2", NULL);
+  CU_ASSERT_EQUAL(eventHistoryInsertLast(history, test_list, test_event),
+                  HISTORY_NO_ERROR);
+  CU_ASSERT_EQUAL(eventHistoryRedo(history, test_list), HISTORY_EMPTY);
+  CU_ASSERT_EQUAL(2, eventHistoryCount(history));
+  CU_ASSERT_EQUAL(2, eventListCount(test_list));
+
+  eventHistoryDestroy(history);
+  eventListDestroy(test_list);
+}
+
+void testEventHistoryOwnership() {
+  struct EventList *test_list;
+  struct EventHistory *history;
+  struct Event *test_event;
+  struct AllocCounts counts;
+  int i;
+
+  allocCounterReset();
+  test_list = eventListCreate();
+  history = eventHistoryCreate(test_list);
+
+  /* Deleted, replaced and undone events are all freed in the end. */
+  for (i = 0; i < 10; i++) {
+    eventCreate(&test_event, "2010-05-24", "06:15", 10, "Event", NULL);
+    eventHistoryInsertLast(history, test_list, test_event);
+  }
+
+  eventCopy(&test_event, test_list->head->event);
+  eventHistoryReplace(history, test_list, test_list->head->event, test_event);
+  eventHistoryDelete(history, test_list, test_list->head->next->event);
+  eventHistoryDelete(history, test_list, test_list->tail->event);
+  eventHistoryUndo(history, test_list);
+  eventHistoryUndo(history, test_list);
+  eventHistoryUndo(history, test_list);
+  eventHistoryUndo(history, test_list);
+
+  eventHistoryDestroy(history);
+  eventListDestroy(test_list);
+
+  allocCounterGet(&counts);
+  CU_ASSERT_EQUAL(counts.bytes, 0);
+  CU_ASSERT_EQUAL(counts.allocations, counts.frees);
+}
+
+/*
+ * A new list with Event 0, Event 1 and Event 2, and its history.
+ */
+static struct EventHistory *historyOfThree(struct EventList **list)
+{
+  struct EventHistory *history;
+  struct Event *test_event;
+  char name[MAX_LENGTH_OF_NAME];
+  int i;
+
+  *list = eventListCreate();
+  history = eventHistoryCreate(*list);
+
+  for (i = 0; i < 3; i++) {
+    sprintf(name, "Event %d", i);
+    eventCreate(&test_event, "2010-05-24", "06:15", 10, name, NULL);
+    eventHistoryInsertLast(history, *list, test_event);
+  }
+
+  return history;
+}
+
+void testEventHistoryOutOfMemory() {
+  struct EventList *test_list;
+  struct EventHistory *history;
+  const char *const names[] = {"Event 0", "Event 1", "Event 2"};
+  const char *const deleted[] = {"Event 0", "Event 2"};
+  enum EventHistoryError result;
+  int i;
+
+  /*
+   * Fail each allocation of the delete in turn. The event still goes,
+   * and nothing is left to undo.
+   */
+  result = HISTORY_NOT_RECORDED;
+
+  for (i = 0; result == HISTORY_NOT_RECORDED; i++) {
+    history = historyOfThree(&test_list);
+
+    allocCounterFailAfter(i);
+    result = eventHistoryDelete(history, test_list,
+                                test_list->head->next->event);
+    allocCounterFailAfter(-1);
+    CU_ASSERT_EQUAL(eventListCount(test_list), 2);
+
+    if (result == HISTORY_NOT_RECORDED) {
+      CU_ASSERT_EQUAL(eventHistoryUndo(history, test_list), HISTORY_EMPTY);
+    } else {
+      CU_ASSERT_EQUAL(result, HISTORY_NO_ERROR);
+      CU_ASSERT_TRUE(historyNamesAre(history, test_list, deleted, 2));
+      CU_ASSERT_EQUAL(eventHistoryUndo(history, test_list),
+                      HISTORY_NO_ERROR);
+      CU_ASSERT_TRUE(historyNamesAre(history, test_list, names, 3));
+    }
+
+    eventHistoryDestroy(history);
+    eventListDestroy(test_list);
+  }
+
+  CU_ASSERT_TRUE(i > 1);
+
+  /* Without the memory for a first version, changes still happen. */
+  history = historyOfThree(&test_list);
+
+  allocCounterFailAfter(0);
+  CU_ASSERT_FALSE(eventHistoryReset(history, test_list));
+  allocCounterFailAfter(-1);
+  CU_ASSERT_FALSE(history->recording);
+  CU_ASSERT_EQUAL(eventHistoryDelete(history, test_list,
+                                     test_list->head->next->event),
+                  HISTORY_NOT_RECORDED);
+  CU_ASSERT_TRUE(history->recording);
+  CU_ASSERT_TRUE(historyNamesAre(history, test_list, deleted, 2));
+
+  eventHistoryDestroy(history);
+  eventListDestroy(test_list);
+
+  /* Without a history at all, changes still happen too. */
+  history = historyOfThree(&test_list);
+  eventHistoryDestroy(history);
+
+  allocCounterFailAfter(0);
+  history = eventHistoryCreate(test_list);
+  allocCounterFailAfter(-1);
+  CU_ASSERT_PTR_NULL_FATAL(history);
+  CU_ASSERT_FALSE(eventHistoryReset(history, test_list));
+  CU_ASSERT_EQUAL(eventHistoryDelete(history, test_list,
+                                     test_list->head->next->event),
+                  HISTORY_NOT_RECORDED);
+  CU_ASSERT_EQUAL(eventListCount(test_list), 2);
+  CU_ASSERT_EQUAL(eventHistoryUndo(history, test_list), HISTORY_EMPTY);
+  CU_ASSERT_EQUAL(eventHistoryRedo(history, test_list), HISTORY_EMPTY);
+  CU_ASSERT_EQUAL(eventHistoryCount(history), 0);
+
+  eventListDestroy(test_list);
+}
@@ -0,0 +1,32 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the EventHistory
+ */
+
+#ifndef EVENT_HISTORY_TEST_H_
+#define EVENT_HISTORY_TEST_H_
+
+#include "event_history.h"
+
+/* History starts with the events of the list, nothing to undo. */
+void testEventHistoryCreate();
+
+/* Undo and redo go back and forth between versions. */
+void testEventHistoryUndoRedo();
+
+/* Old versions aren't changed by later changes. */
+void testEventHistoryVersionsShared();
+
+/* A new change throws away anything that was undone. */
+void testEventHistoryChangeClearsRedo();
+
+/* Events dropped from every version are freed, the list's are kept. */
+void testEventHistoryOwnership();
+
+/* Running out of memory never leaves the history and list apart. */
+void testEventHistoryOutOfMemory();
+
+#endif
@@ -1 +0,0 @@
-../../src/event_list.c
\ No newline at end of file
@@ -1 +0,0 @@
-../../src/event_list.h
\ No newline at end of file
@@ -4,6 +4,8 @@
  * Author: Mike Aldred
  */
 
+#include <string.h>
+
 #include <CUnit/CUnit.h>
 
 #include "event_list_test.h"
@@ -18,6 +20,7 @@ void testEventListCreateList() {
   CU_ASSERT_PTR_NULL(test_list->head);
   CU_ASSERT_PTR_NULL(test_list->tail);
   CU_ASSERT_PTR_NULL(test_list->current);
+  CU_ASSERT_EQUAL(eventListCount(test_list), 0);
 
   eventListDestroy(test_list);
 }
@@ -59,6 +62,7 @@ void testEventListInsertMultiple() {
   CU_ASSERT_TRUE(eventListInsertLast(test_list, test_event_one));
   CU_ASSERT_TRUE(eventListInsertLast(test_list, test_event_two));
   CU_ASSERT_TRUE(eventListInsertLast(test_list, test_event_three));
+  CU_ASSERT_EQUAL(eventListCount(test_list), 3);
 
   eventListResetPosition(test_list);
   compare_event = eventListNext(test_list);
@@ -171,3 +175,393 @@ void testEventListDelete() {
   CU_ASSERT_PTR_NULL(test_list->tail);
 
 }
+
+void testEventListRemove() {
+  struct EventList *test_list;
+  struct Event *test_event_one, *test_event_two;
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL(test_list);
+
+  eventCreate(&test_event_one, "2010-05-24", "06:15", 10, "Event 1", NULL);
+  eventCreate(&test_event_two, "2011-05-24", "06:15", 10, "Event 2", NULL);
+
+  CU_ASSERT_TRUE(eventListInsertLast(test_list, test_event_one));
+  CU_ASSERT_TRUE(eventListInsertLast(test_list, test_event_two));
+
+  CU_ASSERT_TRUE(eventListRemove(test_list, test_event_two));
+  CU_ASSERT_FALSE(eventListRemove(test_list, test_event_two));
+  CU_ASSERT_PTR_NULL(eventListFind(test_list, "Event 2"));
+  CU_ASSERT_PTR_EQUAL(test_list->head, test_list->tail);
+
+  /* Still ours, and still valid. */
+  CU_ASSERT_STRING_EQUAL("Event 2", test_event_two->name);
+  eventDestroy(test_event_two);
+
+  eventListDestroy(test_list);
+}
+
+void testEventListReplace() {
+  struct EventList *test_list;
+  struct Event *test_event_one, *test_event_two, *test_event_three;
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL(test_list);
+
+  eventCreate(&test_event_one, "2010-05-24", "06:15", 10, "Event 1", NULL);
+  eventCreate(&test_event_two, "2011-05-24", "06:15", 10, "Event 2", NULL);
+  eventCreate(&test_event_three, "2012-05-24", "06:15", 10, "Event 3", NULL);
+
+  CU_ASSERT_TRUE(eventListInsertLast(test_list, test_event_one));
+  CU_ASSERT_TRUE(eventListInsertLast(test_list, test_event_two));
+
+  CU_ASSERT_TRUE(eventListReplace(test_list, test_event_one,
+                                  test_event_three));
+
+  eventListResetPosition(test_list);
+  CU_ASSERT_PTR_EQUAL(test_event_three, eventListNext(test_list));
+  CU_ASSERT_PTR_EQUAL(test_event_two, eventListNext(test_list));
+
+  eventDestroy(test_event_one);
+  eventListDestroy(test_list);
+}
+
+void testEventListSharedLocations() {
+  struct EventList *test_list;
+  struct Event *test_event_one, *test_event_two, *test_event_three;
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+
+  eventCreate(&test_event_one, "2010-05-24", "06:15", 10, "Event 1", "Home");
+  eventCreate(&test_event_two, "2011-05-24", "06:15", 10, "Event 2", "Home");
+  eventCreate(&test_event_three, "2012-05-24", "06:15", 10, "Event 3",
+              "The Labs");
+
+  /* Not in a list yet, so not shared. */
+  CU_ASSERT_PTR_NOT_EQUAL(test_event_one->location, test_event_two->location);
+  CU_ASSERT_TRUE(eventSameLocation(test_event_one, test_event_two));
+
+  eventListInsertLast(test_list, test_event_one);
+  eventListInsertLast(test_list, test_event_two);
+  eventListInsertLast(test_list, test_event_three);
+
+  CU_ASSERT_PTR_EQUAL(test_event_one->location, test_event_two->location);
+  CU_ASSERT_EQUAL(test_event_one->location->ref_count, 2);
+  CU_ASSERT_EQUAL(test_list->locations->count, 2);
+  CU_ASSERT_TRUE(eventSameLocation(test_event_one, test_event_two));
+  CU_ASSERT_FALSE(eventSameLocation(test_event_one, test_event_three));
+
+  eventListEdit(test_list, test_event_three, "2012-05-24", "06:15", 10,
+                "Event 3", "Home");
+  CU_ASSERT_PTR_EQUAL(test_event_one->location, test_event_three->location);
+  CU_ASSERT_EQUAL(test_list->locations->count, 1);
+  CU_ASSERT_STRING_EQUAL(eventLocation(test_event_three), "Home");
+
+  /* Removed events keep their location, even after the list is gone. */
+  eventListRemove(test_list, test_event_two);
+  eventListDestroy(test_list);
+  CU_ASSERT_STRING_EQUAL(eventLocation(test_event_two), "Home");
+  CU_ASSERT_PTR_NULL(test_event_two->location->table);
+  eventDestroy(test_event_two);
+}
+
+void testEventListRenameLocation() {
+  struct EventList *test_list;
+  struct Event *test_event_one, *test_event_two, *test_event_three;
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+
+  eventCreate(&test_event_one, "2010-05-24", "06:15", 10, "Event 1", "Home");
+  eventCreate(&test_event_two, "2011-05-24", "06:15", 10, "Event 2", "Home");
+  eventCreate(&test_event_three, "2012-05-24", "06:15", 10, "Event 3",
+              "The Labs");
+  eventListInsertLast(test_list, test_event_one);
+  eventListInsertLast(test_list, test_event_two);
+  eventListInsertLast(test_list, test_event_three);
+
+  CU_ASSERT_FALSE(eventListRenameLocation(test_list, "Work", "Office"));
+
+  CU_ASSERT_TRUE(eventListRenameLocation(test_list, "Home", "House"));
+  CU_ASSERT_STRING_EQUAL(eventLocation(test_event_one), "House");
+  CU_ASSERT_STRING_EQUAL(eventLocation(test_event_two), "House");
+  CU_ASSERT_PTR_NOT_NULL(strstr(test_event_one->formatted_string,
+                                "@ House"));
+  CU_ASSERT_PTR_NULL(locationFind(test_list->locations, "Home"));
+  CU_ASSERT_PTR_EQUAL(locationFind(test_list->locations, "House"),
+                      test_event_one->location);
+
+  /* Merge into a location that's already used. */
+  CU_ASSERT_TRUE(eventListRenameLocation(test_list, "The Labs", "House"));
+  CU_ASSERT_PTR_EQUAL(test_event_three->location, test_event_one->location);
+  CU_ASSERT_EQUAL(test_event_one->location->ref_count, 3);
+  CU_ASSERT_EQUAL(test_list->locations->count, 1);
+  CU_ASSERT_PTR_NOT_NULL(strstr(test_event_three->formatted_string,
+                                "@ House"));
+
+  eventListDestroy(test_list);
+}
+
+/*
+ * Counts of each change heard, and the last event for each.
+ */
+struct WatchTestCounts {
+  int added, changed, removed;
+  struct Event *last_added, *last_changed, *last_removed;
+};
+
+static void watchTestAdded(void *data, struct Event *event) {
+  ((struct WatchTestCounts *) data)->added++;
+  ((struct WatchTestCounts *) data)->last_added = event;
+}
+
+static void watchTestChanged(void *data, struct Event *event) {
+  ((struct WatchTestCounts *) data)->changed++;
+  ((struct WatchTestCounts *) data)->last_changed = event;
+}
+
+static void watchTestRemoved(void *data, struct Event *event) {
+  ((struct WatchTestCounts *) data)->removed++;
+  ((struct WatchTestCounts *) data)->last_removed = event;
+}
+
+void testEventListWatch() {
+  struct EventList *test_list;
+  struct Event *test_event_one, *test_event_two, *test_event_three;
+  struct WatchTestCounts counts, other_counts;
+  struct EventListWatcher watcher, other_watcher;
+
+  memset(&counts, 0, sizeof(counts));
+  memset(&other_counts, 0, sizeof(other_counts));
+  watcher.added = watchTestAdded;
+  watcher.changed = watchTestChanged;
+  watcher.removed = watchTestRemoved;
+  watcher.data = &counts;
+  other_watcher = watcher;
+  other_watcher.data = &other_counts;
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+  eventListWatch(test_list, &watcher);
+  eventListWatch(test_list, &other_watcher);
+
+  eventCreate(&test_event_one, "2010-05-24", "06:15", 10, "Event 1", "Home");
+  eventCreate(&test_event_two, "2011-05-24", "06:15", 10, "Event 2", "Home");
+  eventCreate(&test_event_three, "2012-05-24", "06:15", 10, "Event 3", NULL);
+  eventListInsertLast(test_list, test_event_one);
+  eventListInsertLast(test_list, test_event_two);
+  CU_ASSERT_EQUAL(counts.added, 2);
+  CU_ASSERT_PTR_EQUAL(counts.last_added, test_event_two);
+
+  CU_ASSERT_EQUAL(eventListEdit(test_list, test_event_one, "2010-05-25",
+                                "07:00", 20, "Event 1b", "Home"),
+                  EVENT_NO_ERROR);
+  CU_ASSERT_EQUAL(counts.changed, 1);
+  CU_ASSERT_PTR_EQUAL(counts.last_changed, test_event_one);
+
+  /* A failed edit changes nothing. */
+  eventListEdit(test_list, test_event_one, "2010-13-25", "07:00", 20,
+                "Event 1b", "Home");
+  CU_ASSERT_EQUAL(counts.changed, 1);
+
+  CU_ASSERT_TRUE(eventListRenameLocation(test_list, "Home", "House"));
+  CU_ASSERT_EQUAL(counts.changed, 3);
+
+  CU_ASSERT_TRUE(eventListReplace(test_list, test_event_two,
+                                  test_event_three));
+  CU_ASSERT_EQUAL(counts.removed, 1);
+  CU_ASSERT_PTR_EQUAL(counts.last_removed, test_event_two);
+  CU_ASSERT_EQUAL(counts.added, 3);
+  CU_ASSERT_PTR_EQUAL(counts.last_added, test_event_three);
+  eventDestroy(test_event_two);
+
+  eventListUnwatch(test_list, &watcher);
+  CU_ASSERT_TRUE(eventListDelete(test_list, test_event_one));
+  CU_ASSERT_EQUAL(counts.removed, 1);
+  CU_ASSERT_EQUAL(other_counts.removed, 2);
+  CU_ASSERT_EQUAL(other_counts.added, 3);
+  CU_ASSERT_EQUAL(other_counts.changed, 3);
+
+  eventListUnwatch(test_list, &other_watcher);
+  CU_ASSERT_PTR_NULL(test_list->watchers);
+
+  eventListDestroy(test_list);
+}
+
+void testEventListIds() {
+  struct EventList *test_list;
+  struct Event *test_event_one, *test_event_two, *test_event_three;
+  struct EventListNode *node;
+  EventId id_one, id_two;
+  int i;
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+
+  eventCreate(&test_event_one, "2010-05-24", "06:15", 10, "Event 1", "Home");
+  eventCreate(&test_event_two, "2011-05-24", "06:15", 10, "Event 2", NULL);
+  eventCreate(&test_event_three, "2012-05-24", "06:15", 10, "Event 3", NULL);
+  CU_ASSERT_EQUAL(test_event_one->id, EVENT_NO_ID);
+
+  eventListInsertLast(test_list, test_event_one);
+  eventListInsertLast(test_list, test_event_two);
+  id_one = test_event_one->id;
+  id_two = test_event_two->id;
+  CU_ASSERT_NOT_EQUAL(id_one, EVENT_NO_ID);
+  CU_ASSERT_NOT_EQUAL(id_one, id_two);
+  CU_ASSERT_PTR_EQUAL(eventListFindId(test_list, id_one), test_event_one);
+  CU_ASSERT_PTR_EQUAL(eventListFindId(test_list, id_two), test_event_two);
+  CU_ASSERT_PTR_NULL(eventListFindId(test_list, EVENT_NO_ID));
+
+  CU_ASSERT_EQUAL(eventListEditId(test_list, id_one, "2010-05-25", "07:00",
+                                  20, "Event 1b", "House"),
+                  EVENT_NO_ERROR);
+  CU_ASSERT_STRING_EQUAL(test_event_one->name, "Event 1b");
+  CU_ASSERT_EQUAL(test_event_one->id, id_one);
+  CU_ASSERT_EQUAL(eventListEditId(test_list, id_two + 100, "2010-05-25",
+                                  "07:00", 20, "Event 1b", "House"),
+                  EVENT_NOT_FOUND);
+
+  /* The replacement is the same event to anyone holding the id. */
+  CU_ASSERT_TRUE(eventListReplace(test_list, test_event_two,
+                                  test_event_three));
+  CU_ASSERT_EQUAL(test_event_three->id, id_two);
+  CU_ASSERT_PTR_EQUAL(eventListFindId(test_list, id_two), test_event_three);
+
+  /* Ids taken by another event are given up, and deleted ones aren't reused. */
+  test_event_two->id = id_one;
+  CU_ASSERT_TRUE(eventListDeleteId(test_list, id_two));
+  CU_ASSERT_FALSE(eventListDeleteId(test_list, id_two));
+  CU_ASSERT_PTR_NULL(eventListFindId(test_list, id_two));
+  eventListInsertLast(test_list, test_event_two);
+  CU_ASSERT_NOT_EQUAL(test_event_two->id, id_one);
+  CU_ASSERT_NOT_EQUAL(test_event_two->id, id_two);
+  CU_ASSERT_PTR_EQUAL(eventListFindId(test_list, id_one), test_event_one);
+
+  /* Enough to make the map grow, and every one still found. */
+  for (i = 0; i < 200; i++) {
+    eventCreate(&test_event_three, "2012-05-24", "06:15", 10, "Event", NULL);
+    eventListInsertLast(test_list, test_event_three);
+  }
+
+  for (node = test_list->head; node != NULL; node = node->next) {
+    CU_ASSERT_PTR_EQUAL(eventListFindId(test_list, node->event->id),
+                        node->event);
+  }
+
+  CU_ASSERT_EQUAL(test_list->ids.count, eventListCount(test_list));
+
+  eventListDestroy(test_list);
+}
+
+void testEventListDeleteHandle() {
+  struct EventList *test_list, *other_list;
+  struct Event *events[5], *other_event;
+  struct EventListNode *node;
+  int i;
+
+  test_list = eventListCreate();
+  other_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(other_list);
+
+  for (i = 0; i < 5; i++) {
+    eventCreate(&events[i], "2010-05-24", "06:15", 10, "Event", NULL);
+    CU_ASSERT_TRUE(eventListInsertLast(test_list, events[i]));
+  }
+
+  /* Same id as one in test_list, but not in it. */
+  eventCreate(&other_event, "2010-05-24", "06:15", 10, "Other", NULL);
+  CU_ASSERT_TRUE(eventListInsertLast(other_list, other_event));
+  CU_ASSERT_EQUAL(other_event->id, events[0]->id);
+  CU_ASSERT_FALSE(eventListDelete(test_list, other_event));
+  CU_ASSERT_FALSE(eventListDelete(test_list, NULL));
+
+  /* Middle, head and tail, and the iterator moves past a deleted node. */
+  eventListResetPosition(test_list);
+  CU_ASSERT_PTR_EQUAL(eventListNext(test_list), events[0]);
+  CU_ASSERT_TRUE(eventListDelete(test_list, events[2]));
+  CU_ASSERT_TRUE(eventListDelete(test_list, events[1]));
+  CU_ASSERT_PTR_EQUAL(eventListNext(test_list), events[3]);
+  CU_ASSERT_TRUE(eventListDelete(test_list, events[0]));
+  CU_ASSERT_TRUE(eventListDelete(test_list, events[4]));
+
+  CU_ASSERT_PTR_EQUAL(test_list->head, test_list->tail);
+  CU_ASSERT_PTR_EQUAL(test_list->head->event, events[3]);
+  CU_ASSERT_PTR_NULL(test_list->head->previous);
+  CU_ASSERT_PTR_NULL(test_list->head->next);
+
+  /* Links stay right both ways after replacing and adding again. */
+  eventCreate(&events[0], "2010-05-24", "06:15", 10, "Event", NULL);
+  eventCreate(&events[1], "2010-05-24", "06:15", 10, "Event", NULL);
+  CU_ASSERT_TRUE(eventListInsertLast(test_list, events[0]));
+  CU_ASSERT_TRUE(eventListReplace(test_list, events[3], events[1]));
+  CU_ASSERT_FALSE(eventListDelete(test_list, events[3]));
+  eventDestroy(events[3]);
+
+  node = test_list->tail;
+  CU_ASSERT_PTR_EQUAL(node->event, events[0]);
+  CU_ASSERT_PTR_EQUAL(node->previous->event, events[1]);
+  CU_ASSERT_PTR_EQUAL(node->previous->next, node);
+
+  CU_ASSERT_TRUE(eventListDelete(test_list, events[1]));
+  CU_ASSERT_TRUE(eventListDelete(test_list, events[0]));
+  CU_ASSERT_PTR_NULL(test_list->head);
+  CU_ASSERT_PTR_NULL(test_list->tail);
+
+  eventListDestroy(other_list);
+  eventListDestroy(test_list);
+}
+
+void testEventListInsertBefore() {
+  struct EventList *test_list, *other_list;
+  struct Event *events[4], *other_event;
+  struct EventListNode *node;
+  EventId removed_id;
+  int i;
+
+  test_list = eventListCreate();
+  other_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(other_list);
+
+  for (i = 0; i < 4; i++) {
+    eventCreate(&events[i], "2010-05-24", "06:15", i, "Event", NULL);
+    CU_ASSERT_TRUE(eventListInsertBefore(test_list, events[i], NULL));
+  }
+
+  /* Removed events go back where they were, with the ids they had. */
+  removed_id = events[1]->id;
+  CU_ASSERT_TRUE(eventListRemove(test_list, events[0]));
+  CU_ASSERT_TRUE(eventListRemove(test_list, events[1]));
+  CU_ASSERT_TRUE(eventListRemove(test_list, events[3]));
+  CU_ASSERT_FALSE(eventListInsertBefore(test_list, events[3], events[2]));
+  CU_ASSERT_TRUE(eventListInsertBefore(test_list, events[3], NULL));
+  CU_ASSERT_TRUE(eventListInsertBefore(test_list, events[1], events[2]));
+  CU_ASSERT_TRUE(eventListInsertBefore(test_list, events[0], events[1]));
+  CU_ASSERT_EQUAL(events[1]->id, removed_id);
+  CU_ASSERT_PTR_EQUAL(eventListFindId(test_list, removed_id), events[1]);
+
+  for (node = test_list->head, i = 0; node != NULL; node = node->next, i++) {
+    CU_ASSERT_PTR_EQUAL(node->event, events[i]);
+    CU_ASSERT_TRUE(node->previous == NULL ||
+                   node->previous->next == node);
+  }
+  CU_ASSERT_EQUAL(i, 4);
+  CU_ASSERT_PTR_EQUAL(test_list->tail->event, events[3]);
+
+  /* Only in id order, and only ahead of events in this list. */
+  eventCreate(&other_event, "2010-05-24", "06:15", 10, "Other", NULL);
+  CU_ASSERT_FALSE(eventListInsertBefore(test_list, other_event, events[1]));
+  CU_ASSERT_FALSE(eventListInsertBefore(other_list, other_event, events[0]));
+  CU_ASSERT_PTR_NULL(other_list->head);
+
+  /* An id below the tail's is out of order at the end too. */
+  other_event->id = removed_id;
+  CU_ASSERT_TRUE(eventListInsertLast(test_list, other_event));
+  CU_ASSERT_TRUE(other_event->id > events[3]->id);
+
+  eventListDestroy(other_list);
+  eventListDestroy(test_list);
+}
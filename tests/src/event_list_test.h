@@ -32,4 +32,28 @@ void testEventListFindEmptyList();
 /* Test the delete operation */
 void testEventListDelete();
 
+/* Remove should unlink, but not destroy. */
+void testEventListRemove();
+
+/* Replace keeps the position of the original. */
+void testEventListReplace();
+
+/* Events at the same location share it, even after edits and removes. */
+void testEventListSharedLocations();
+
+/* Renaming a location, and merging it into one already used. */
+void testEventListRenameLocation();
+
+/* Watchers hear about every change, until they're taken off. */
+void testEventListWatch();
+
+/* Events keep their ids, and can be found, edited and deleted by them. */
+void testEventListIds();
+
+/* Deleting by the event alone, with the links kept right both ways. */
+void testEventListDeleteHandle();
+
+/* Putting events back where they were, keeping the list in id order. */
+void testEventListInsertBefore();
+
 #endif
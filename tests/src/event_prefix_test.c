@@ -0,0 +1,204 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "event_prefix_test.h"
+
+#define PREFIX_TEST_MATCHES 4
+#define PREFIX_TEST_EVENTS 200
+
+static struct EventList *prefixTestList(struct Event **events)
+{
+  struct EventList *list;
+
+  list = eventListCreate();
+  eventCreate(&events[0], "2013-05-02", "09:00", 30, "Team meeting", NULL);
+  eventCreate(&events[1], "2013-05-01", "12:00", 60, "lunch", NULL);
+  eventCreate(&events[2], "2013-05-01", "09:00", 30, "team meeting", NULL);
+  eventCreate(&events[3], "2013-05-03", "15:00", 90, "Teams call", NULL);
+  eventCreate(&events[4], "2013-05-03", "16:00", 10, "Tea", NULL);
+  eventListInsertLast(list, events[0]);
+  eventListInsertLast(list, events[1]);
+  eventListInsertLast(list, events[2]);
+  eventListInsertLast(list, events[3]);
+  eventListInsertLast(list, events[4]);
+
+  return list;
+}
+
+void testEventPrefixFind() {
+  struct EventList *list, *other_list;
+  struct EventPrefixIndex *index;
+  struct Event *events[5];
+  struct Event *matches[PREFIX_TEST_MATCHES];
+
+  list = prefixTestList(events);
+  index = eventPrefixCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  /* Same names are in time order. */
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "TEAM", matches,
+                                  PREFIX_TEST_MATCHES), 3);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[2]);
+  CU_ASSERT_PTR_EQUAL(matches[1], events[0]);
+  CU_ASSERT_PTR_EQUAL(matches[2], events[3]);
+
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "tea", matches,
+                                  PREFIX_TEST_MATCHES), 4);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[4]);
+
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "team meeting", matches,
+                                  PREFIX_TEST_MATCHES), 2);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "lunch", matches, 1), 1);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[1]);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "lunches", matches, 1), 0);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "a", matches, 1), 0);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "z", matches, 1), 0);
+
+  /* Everything starts with nothing, only max_matches are filled in. */
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "", matches, 2), 5);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[1]);
+  CU_ASSERT_PTR_EQUAL(matches[1], events[4]);
+
+  other_list = eventListCreate();
+  CU_ASSERT_TRUE(eventPrefixIsCurrent(index, list));
+  CU_ASSERT_FALSE(eventPrefixIsCurrent(index, other_list));
+  CU_ASSERT_FALSE(eventPrefixIsCurrent(NULL, list));
+
+  eventPrefixDestroy(index);
+  CU_ASSERT_PTR_NULL(list->watchers);
+  eventListDestroy(other_list);
+  eventListDestroy(list);
+}
+
+void testEventPrefixUpdates() {
+  struct EventList *list;
+  struct EventPrefixIndex *index;
+  struct Event *events[5];
+  struct Event *matches[PREFIX_TEST_MATCHES];
+  struct Event *added[PREFIX_TEST_EVENTS];
+  char name[32];
+  int i;
+
+  list = prefixTestList(events);
+  index = eventPrefixCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  CU_ASSERT_EQUAL(eventListEdit(list, events[2], "2013-05-01", "09:00", 30,
+                                "Standup", NULL), EVENT_NO_ERROR);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "team m", matches,
+                                  PREFIX_TEST_MATCHES), 1);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[0]);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "st", matches,
+                                  PREFIX_TEST_MATCHES), 1);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[2]);
+
+  /* Enough to make it grow, with duplicate names. */
+  for (i = 0; i < PREFIX_TEST_EVENTS; i++) {
+    sprintf(name, "Review %d", i % 10);
+    eventCreate(&added[i], "2013-06-01", "10:00", 30, name, NULL);
+    eventListInsertLast(list, added[i]);
+  }
+
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "review", matches, 1),
+                  PREFIX_TEST_EVENTS);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "review 3", matches,
+                                  PREFIX_TEST_MATCHES),
+                  PREFIX_TEST_EVENTS / 10);
+  CU_ASSERT_PTR_EQUAL(matches[0], added[3]);
+  CU_ASSERT_PTR_EQUAL(matches[1], added[13]);
+
+  for (i = 0; i < PREFIX_TEST_EVENTS; i += 2) {
+    CU_ASSERT_TRUE(eventListDelete(list, added[i]));
+  }
+
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "review 3", matches,
+                                  PREFIX_TEST_MATCHES),
+                  PREFIX_TEST_EVENTS / 10);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "review 4", matches, 1), 0);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "", matches, 1),
+                  5 + PREFIX_TEST_EVENTS / 2);
+  CU_ASSERT_EQUAL(index->count, eventListCount(list));
+  CU_ASSERT_TRUE(eventPrefixIsCurrent(index, list));
+
+  eventPrefixDestroy(index);
+  eventListDestroy(list);
+}
+
+void testEventPrefixChanges() {
+  struct EventList *list;
+  struct EventPrefixIndex *index;
+  struct Event *events[PREFIX_TEST_EVENTS];
+  struct Event *matches[PREFIX_TEST_MATCHES];
+  char date[11], name[32];
+  int i;
+
+  list = eventListCreate();
+
+  for (i = 0; i < PREFIX_TEST_EVENTS; i++) {
+    sprintf(date, "2013-%02d-%02d", i / 28 % 12 + 1, i % 28 + 1);
+    sprintf(name, "Event %d", i % 10);
+    eventCreate(&events[i], date, "10:00", 30, name, "Room");
+    eventListInsertLast(list, events[i]);
+  }
+
+  index = eventPrefixCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  /* Nothing the index sorts by changes, so nothing moves. */
+  CU_ASSERT_TRUE(eventListRenameLocation(list, "Room", "Hall"));
+  CU_ASSERT_TRUE(eventPrefixIsCurrent(index, list));
+  CU_ASSERT_EQUAL(index->count, PREFIX_TEST_EVENTS);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "event 3", matches,
+                                  PREFIX_TEST_MATCHES),
+                  PREFIX_TEST_EVENTS / 10);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[3]);
+  CU_ASSERT_PTR_EQUAL(matches[1], events[13]);
+
+  /* Still between its neighbours, just the copy of the name changes. */
+  CU_ASSERT_EQUAL(eventListEdit(list, events[3], "2013-01-04", "10:00", 30,
+                                "EVENT 3", "Hall"), EVENT_NO_ERROR);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "EVENT 3", matches,
+                                  PREFIX_TEST_MATCHES),
+                  PREFIX_TEST_EVENTS / 10);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[3]);
+  CU_ASSERT_STRING_EQUAL(index->entries[PREFIX_TEST_EVENTS / 10 * 3].name,
+                         "EVENT 3");
+
+  /* A later start moves it past the others with the same name. */
+  CU_ASSERT_EQUAL(eventListEdit(list, events[3], "2014-01-01", "10:00", 30,
+                                "Event 3", "Hall"), EVENT_NO_ERROR);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "event 3", matches,
+                                  PREFIX_TEST_MATCHES),
+                  PREFIX_TEST_EVENTS / 10);
+  CU_ASSERT_PTR_EQUAL(matches[0], events[13]);
+  CU_ASSERT_PTR_EQUAL(
+    index->entries[PREFIX_TEST_EVENTS / 10 * 4 - 1].event, events[3]);
+
+  /* And a new name takes it to another group. */
+  CU_ASSERT_EQUAL(eventListEdit(list, events[3], "2014-01-01", "10:00", 30,
+                                "Event 7", "Hall"), EVENT_NO_ERROR);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "event 3", matches, 1),
+                  PREFIX_TEST_EVENTS / 10 - 1);
+  CU_ASSERT_EQUAL(eventPrefixFind(index, "event 7", matches, 1),
+                  PREFIX_TEST_EVENTS / 10 + 1);
+
+  for (i = 1; i < index->count; i++) {
+    CU_ASSERT_TRUE(index->entries[i - 1].timestamp <=
+                   index->entries[i].timestamp ||
+                   strcmp(index->entries[i - 1].name,
+                          index->entries[i].name) < 0);
+  }
+
+  CU_ASSERT_TRUE(eventPrefixIsCurrent(index, list));
+
+  eventPrefixDestroy(index);
+  eventListDestroy(list);
+}
@@ -0,0 +1,26 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for finding events by the start of their name
+ */
+
+#ifndef EVENT_PREFIX_TEST_H_
+#define EVENT_PREFIX_TEST_H_
+
+#include "event_prefix.h"
+
+/* Prefixes find their events in name order, ignoring case. */
+void testEventPrefixFind();
+
+/* Inserts, edits and deletes keep the order, duplicates included. */
+void testEventPrefixUpdates();
+
+/*
+ * Changes that leave the name and start alone don't move the event,
+ * ones that do keep the order.
+ */
+void testEventPrefixChanges();
+
+#endif
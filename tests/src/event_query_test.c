@@ -0,0 +1,297 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "event_query_test.h"
+#include "test_calendar.h"
+
+#define QUERY_TEST_EVENTS 200
+
+/*
+ * Count the results of the query, checking each one matches.
+ */
+static int queryCount(const struct EventQuery *const query,
+                      struct EventList *list,
+                      const struct EventIndex *index,
+                      enum EventQueryPlan *plan)
+{
+  struct EventQueryIterator iterator;
+  struct Event *event;
+  int count;
+
+  count = 0;
+  eventQueryBegin(&iterator, query, list, index);
+  *plan = iterator.plan;
+
+  while ((event = eventQueryNext(&iterator)) != NULL) {
+    CU_ASSERT_TRUE(eventQueryMatches(query, event));
+    count++;
+  }
+
+  return count;
+}
+
+/*
+ * Count the matches the slow way.
+ */
+static int listCount(const struct EventQuery *const query,
+                     struct EventList *list)
+{
+  struct EventListNode *node;
+  int count;
+
+  count = 0;
+
+  for (node = list->head; node != NULL; node = node->next) {
+    if (eventQueryMatches(query, node->event)) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+void testEventIndexCreate() {
+  struct EventList *test_list;
+  struct EventIndex *index;
+  int i, first, count;
+
+  test_list = testCalendarList(QUERY_TEST_EVENTS);
+  index = eventIndexCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+  CU_ASSERT_EQUAL(index->count, QUERY_TEST_EVENTS);
+  CU_ASSERT_EQUAL(index->max_duration, 120);
+
+  for (i = 1; i < index->count; i++) {
+    CU_ASSERT_TRUE(index->by_start[i - 1]->timestamp <=
+                   index->by_start[i]->timestamp);
+    CU_ASSERT_TRUE(strcmp(index->by_name[i - 1]->name,
+                          index->by_name[i]->name) <= 0);
+  }
+
+  for (i = 0; i < index->count; i++) {
+    CU_ASSERT_EQUAL(index->starts[i], index->by_start[i]->timestamp);
+    CU_ASSERT_EQUAL(index->durations[i], index->by_start[i]->duration);
+    CU_ASSERT_EQUAL(index->start_minutes[i],
+                    index->by_start[i]->time.hour * 60 +
+                    index->by_start[i]->time.minutes);
+  }
+
+  for (i = 1; i < index->location_count; i++) {
+    CU_ASSERT_TRUE(strcmp(eventLocation(index->by_location[i - 1]),
+                          eventLocation(index->by_location[i])) <= 0);
+  }
+
+  count = eventIndexNameRange(index, "Event 3", FALSE, &first);
+  CU_ASSERT_EQUAL(count, QUERY_TEST_EVENTS / 10);
+
+  for (i = first; i < first + count; i++) {
+    CU_ASSERT_STRING_EQUAL(index->by_name[i]->name, "Event 3");
+  }
+
+  count = eventIndexNameRange(index, "Event", TRUE, &first);
+  CU_ASSERT_EQUAL(first, 0);
+  CU_ASSERT_EQUAL(count, QUERY_TEST_EVENTS);
+
+  count = eventIndexNameRange(index, "Missing", FALSE, &first);
+  CU_ASSERT_EQUAL(count, 0);
+
+  count = eventIndexLocationRange(index, "Room", TRUE, &first);
+  CU_ASSERT_EQUAL(count, index->location_count);
+
+  CU_ASSERT_EQUAL(eventIndexSeekStart(index, 0), 0);
+  CU_ASSERT_EQUAL(eventIndexSeekStart(
+                    index, index->by_start[index->count - 1]->timestamp + 1),
+                  index->count);
+
+  eventIndexDestroy(index);
+  eventListDestroy(test_list);
+}
+
+void testEventIndexCurrent() {
+  struct EventList *test_list;
+  struct EventIndex *index;
+  struct Event *test_event;
+
+  test_list = eventListCreate();
+  index = eventIndexCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+  CU_ASSERT_EQUAL(index->count, 0);
+  CU_ASSERT_TRUE(eventIndexIsCurrent(index, test_list));
+  CU_ASSERT_FALSE(eventIndexIsCurrent(NULL, test_list));
+
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Event 1", NULL);
+  eventListInsertLast(test_list, test_event);
+  CU_ASSERT_FALSE(eventIndexIsCurrent(index, test_list));
+  eventIndexDestroy(index);
+
+  index = eventIndexCreate(test_list);
+  CU_ASSERT_TRUE(eventIndexIsCurrent(index, test_list));
+  eventListEdit(test_list, test_event, "2010-05-25", "06:15", 10, "Event 1",
+                NULL);
+  CU_ASSERT_FALSE(eventIndexIsCurrent(index, test_list));
+  eventIndexDestroy(index);
+
+  index = eventIndexCreate(test_list);
+  eventListDelete(test_list, test_event);
+  CU_ASSERT_FALSE(eventIndexIsCurrent(index, test_list));
+  eventIndexDestroy(index);
+
+  eventListDestroy(test_list);
+}
+
+void testEventQueryScan() {
+  struct EventList *test_list;
+  struct EventQuery query;
+  enum EventQueryPlan plan;
+  int count;
+
+  test_list = testCalendarList(QUERY_TEST_EVENTS);
+
+  eventQueryInit(&query);
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, NULL, &plan),
+                  QUERY_TEST_EVENTS);
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_SCAN);
+
+  query.filters = QUERY_NAME_EQUALS;
+  query.name = "Event 3";
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, NULL, &plan),
+                  QUERY_TEST_EVENTS / 10);
+
+  query.filters = QUERY_NAME_CONTAINS;
+  query.name = "nt 1";
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, NULL, &plan),
+                  QUERY_TEST_EVENTS / 10);
+
+  query.filters = QUERY_LOCATION;
+  query.location = "Room 2";
+  count = queryCount(&query, test_list, NULL, &plan);
+  CU_ASSERT_TRUE(count > 0);
+  CU_ASSERT_EQUAL(count, listCount(&query, test_list));
+
+  query.filters = QUERY_LOCATION_PREFIX;
+  query.location = "Room";
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, NULL, &plan),
+                  QUERY_TEST_EVENTS - (QUERY_TEST_EVENTS + 2) / 3);
+
+  query.filters = QUERY_DURATION;
+  query.min_duration = 30;
+  query.max_duration = 60;
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, NULL, &plan),
+                  QUERY_TEST_EVENTS * 2 / 5);
+
+  query.filters = QUERY_TIME_OF_DAY;
+  query.time_from = 9 * 60;
+  query.time_to = 17 * 60;
+  count = queryCount(&query, test_list, NULL, &plan);
+  CU_ASSERT_TRUE(count > 0);
+  CU_ASSERT_EQUAL(count, listCount(&query, test_list));
+
+  query.filters = QUERY_START_RANGE;
+  query.start_from = testCalendarTime("2013-03-01", "00:00");
+  query.start_before = testCalendarTime("2013-07-01", "00:00");
+  count = queryCount(&query, test_list, NULL, &plan);
+  CU_ASSERT_TRUE(count > 0);
+  CU_ASSERT_EQUAL(count, listCount(&query, test_list));
+
+  query.filters = QUERY_START_RANGE | QUERY_TIME_OF_DAY | QUERY_DURATION |
+                  QUERY_LOCATION_PREFIX | QUERY_NAME_CONTAINS;
+  query.name = "Event";
+  count = queryCount(&query, test_list, NULL, &plan);
+  CU_ASSERT_TRUE(count > 0);
+  CU_ASSERT_EQUAL(count, listCount(&query, test_list));
+
+  eventListDestroy(test_list);
+}
+
+void testEventQueryPlan() {
+  struct EventList *test_list;
+  struct EventIndex *index;
+  struct EventQuery query;
+  struct Event *test_event;
+  enum EventQueryPlan plan;
+
+  test_list = testCalendarList(QUERY_TEST_EVENTS);
+  index = eventIndexCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  /* Nothing to narrow with, so it's a scan. */
+  eventQueryInit(&query);
+  query.filters = QUERY_NAME_CONTAINS;
+  query.name = "nt 1";
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, index, &plan),
+                  listCount(&query, test_list));
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_SCAN);
+
+  /* Time filters go through the start order to use the columns. */
+  query.filters = QUERY_DURATION;
+  query.min_duration = 0;
+  query.max_duration = 30;
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, index, &plan),
+                  listCount(&query, test_list));
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_START_INDEX);
+
+  query.filters = QUERY_TIME_OF_DAY | QUERY_DURATION;
+  query.time_from = 9 * 60;
+  query.time_to = 17 * 60;
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, index, &plan),
+                  listCount(&query, test_list));
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_START_INDEX);
+
+  /* The name range is smaller than the whole date range. */
+  query.filters = QUERY_NAME_EQUALS | QUERY_START_RANGE;
+  query.name = "Event 3";
+  query.start_from = 0;
+  query.start_before = testCalendarTime("2014-01-01", "00:00");
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, index, &plan),
+                  listCount(&query, test_list));
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_NAME_INDEX);
+
+  /* A single day is smaller than a name. */
+  query.start_from = testCalendarTime("2013-01-01", "00:00");
+  query.start_before = testCalendarTime("2013-01-02", "00:00");
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, index, &plan),
+                  listCount(&query, test_list));
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_START_INDEX);
+
+  query.filters = QUERY_LOCATION | QUERY_NAME_CONTAINS;
+  query.location = "Room 4";
+  query.name = "2";
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, index, &plan),
+                  listCount(&query, test_list));
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_LOCATION_INDEX);
+
+  eventIndexDestroy(index);
+
+  /* 24:00 is minute 1440 of its own day, with or without the index. */
+  eventCreate(&test_event, "2013-01-01", "24:00", 10, "Midnight", NULL);
+  eventListInsertLast(test_list, test_event);
+  index = eventIndexCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+  query.filters = QUERY_TIME_OF_DAY | QUERY_DURATION;
+  query.time_from = 24 * 60;
+  query.time_to = 24 * 60 + 1;
+  query.min_duration = 10;
+  query.max_duration = 10;
+  CU_ASSERT_EQUAL(listCount(&query, test_list), 1);
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, index, &plan), 1);
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_START_INDEX);
+
+  /* An out of date index isn't used. */
+  eventCreate(&test_event, "2013-01-01", "06:15", 10, "Event 3", "Room 4");
+  eventListInsertLast(test_list, test_event);
+  query.filters = QUERY_NAME_EQUALS;
+  query.name = "Event 3";
+  CU_ASSERT_EQUAL(queryCount(&query, test_list, index, &plan),
+                  QUERY_TEST_EVENTS / 10 + 1);
+  CU_ASSERT_EQUAL(plan, QUERY_PLAN_SCAN);
+
+  eventIndexDestroy(index);
+  eventListDestroy(test_list);
+}
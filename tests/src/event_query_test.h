@@ -0,0 +1,30 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the EventIndex and EventQuery
+ */
+
+#ifndef EVENT_QUERY_TEST_H_
+#define EVENT_QUERY_TEST_H_
+
+#include "event_index.h"
+#include "event_query.h"
+
+/* Index arrays are sorted, columns match and ranges are found. */
+void testEventIndexCreate();
+
+/* Changing the list makes the index out of date. */
+void testEventIndexCurrent();
+
+/* Every filter on its own, and together, without an index. */
+void testEventQueryScan();
+
+/*
+ * The plan uses the smallest index range, or the start order for time
+ * filters, results are the same.
+ */
+void testEventQueryPlan();
+
+#endif
@@ -0,0 +1,167 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "event_schedule_test.h"
+#include "test_calendar.h"
+
+#define SCHEDULE_TEST_EVENTS 300
+
+static void addEvent(struct EventList *list, const char *const stDate,
+                     const char *const stTime, int duration)
+{
+  struct Event *event;
+
+  eventCreate(&event, stDate, stTime, duration, "Event", NULL);
+  eventListInsertLast(list, event);
+}
+
+static Boolean intervalIs(const struct ScheduleIntervals *intervals, int i,
+                          const char *const start_date,
+                          const char *const start_time,
+                          const char *const end_date,
+                          const char *const end_time)
+{
+  return (i < intervals->count &&
+          intervals->intervals[i].start ==
+          testCalendarTime(start_date, start_time) &&
+          intervals->intervals[i].end ==
+          testCalendarTime(end_date, end_time));
+}
+
+/*
+ * A day with a meeting running past midnight from the day before.
+ */
+static struct EventList *scheduleTestList(void)
+{
+  struct EventList *list;
+
+  list = eventListCreate();
+  addEvent(list, "2013-05-02", "10:00", 60);
+  addEvent(list, "2013-05-01", "23:00", 120);
+  addEvent(list, "2013-05-02", "09:00", 30);
+  addEvent(list, "2013-05-02", "09:30", 15);
+  addEvent(list, "2013-05-02", "10:30", 60);
+  addEvent(list, "2013-05-02", "15:00", 0);
+  addEvent(list, "2013-05-02", "16:00", 120);
+
+  return list;
+}
+
+void testScheduleBusy() {
+  struct EventList *test_list;
+  struct ScheduleIntervals busy;
+
+  test_list = scheduleTestList();
+  scheduleIntervalsInit(&busy);
+
+  CU_ASSERT_TRUE(scheduleBusy(test_list, NULL,
+                              testCalendarTime("2013-05-02", "00:00"),
+                              testCalendarTime("2013-05-02", "17:00"), &busy));
+  CU_ASSERT_EQUAL(busy.count, 4);
+  CU_ASSERT_TRUE(intervalIs(&busy, 0, "2013-05-02", "00:00",
+                            "2013-05-02", "01:00"));
+  CU_ASSERT_TRUE(intervalIs(&busy, 1, "2013-05-02", "09:00",
+                            "2013-05-02", "09:45"));
+  CU_ASSERT_TRUE(intervalIs(&busy, 2, "2013-05-02", "10:00",
+                            "2013-05-02", "11:30"));
+  CU_ASSERT_TRUE(intervalIs(&busy, 3, "2013-05-02", "16:00",
+                            "2013-05-02", "17:00"));
+
+  /* Nothing in the window. */
+  CU_ASSERT_TRUE(scheduleBusy(test_list, NULL,
+                              testCalendarTime("2013-06-01", "00:00"),
+                              testCalendarTime("2013-06-02", "00:00"), &busy));
+  CU_ASSERT_EQUAL(busy.count, 0);
+
+  scheduleIntervalsFree(&busy);
+  eventListDestroy(test_list);
+}
+
+void testScheduleFreeSlots() {
+  struct EventList *test_list;
+  struct ScheduleIntervals free_slots;
+
+  test_list = scheduleTestList();
+  scheduleIntervalsInit(&free_slots);
+
+  CU_ASSERT_TRUE(scheduleFreeSlots(test_list, NULL,
+                                   testCalendarTime("2013-05-02", "08:00"),
+                                   testCalendarTime("2013-05-02", "18:30"), 30,
+                                   10, &free_slots));
+  CU_ASSERT_EQUAL(free_slots.count, 3);
+  CU_ASSERT_TRUE(intervalIs(&free_slots, 0, "2013-05-02", "08:00",
+                            "2013-05-02", "09:00"));
+  CU_ASSERT_TRUE(intervalIs(&free_slots, 1, "2013-05-02", "11:30",
+                            "2013-05-02", "16:00"));
+  CU_ASSERT_TRUE(intervalIs(&free_slots, 2, "2013-05-02", "18:00",
+                            "2013-05-02", "18:30"));
+
+  /* The 15 minute gap at 09:45 is only free for short things. */
+  CU_ASSERT_TRUE(scheduleFreeSlots(test_list, NULL,
+                                   testCalendarTime("2013-05-02", "08:00"),
+                                   testCalendarTime("2013-05-02", "18:30"), 15,
+                                   2, &free_slots));
+  CU_ASSERT_EQUAL(free_slots.count, 2);
+  CU_ASSERT_TRUE(intervalIs(&free_slots, 1, "2013-05-02", "09:45",
+                            "2013-05-02", "10:00"));
+
+  /* Too long for any gap. */
+  CU_ASSERT_TRUE(scheduleFreeSlots(test_list, NULL,
+                                   testCalendarTime("2013-05-02", "08:00"),
+                                   testCalendarTime("2013-05-02", "18:30"), 300,
+                                   10, &free_slots));
+  CU_ASSERT_EQUAL(free_slots.count, 0);
+
+  scheduleIntervalsFree(&free_slots);
+  eventListDestroy(test_list);
+}
+
+void testScheduleIndexed() {
+  struct EventList *test_list;
+  struct EventIndex *index;
+  struct ScheduleIntervals scanned, indexed;
+  char stDate[11], stTime[6];
+  Timestamp window_start, window_end;
+  int i;
+
+  test_list = eventListCreate();
+
+  for (i = 0; i < SCHEDULE_TEST_EVENTS; i++) {
+    sprintf(stDate, "2013-05-%02d", i * 7 % 28 + 1);
+    sprintf(stTime, "%02d:%02d", i * 5 % 24, i * 13 % 60);
+    addEvent(test_list, stDate, stTime, i * 37 % 240);
+  }
+
+  index = eventIndexCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+  scheduleIntervalsInit(&scanned);
+  scheduleIntervalsInit(&indexed);
+
+  for (i = 0; i < 28; i++) {
+    window_start = testCalendarTime("2013-05-01", "06:00") + i * 24 * 60;
+    window_end = window_start + (i + 1) * 180;
+
+    CU_ASSERT_TRUE(scheduleBusy(test_list, NULL, window_start, window_end,
+                                &scanned));
+    CU_ASSERT_TRUE(scheduleBusy(test_list, index, window_start, window_end,
+                                &indexed));
+    CU_ASSERT_EQUAL(scanned.count, indexed.count);
+    CU_ASSERT_TRUE(scanned.count == indexed.count &&
+                   memcmp(scanned.intervals, indexed.intervals,
+                          sizeof(struct ScheduleInterval) *
+                          scanned.count) == 0);
+  }
+
+  scheduleIntervalsFree(&scanned);
+  scheduleIntervalsFree(&indexed);
+  eventIndexDestroy(index);
+  eventListDestroy(test_list);
+}
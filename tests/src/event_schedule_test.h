@@ -0,0 +1,23 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the free/busy calculations
+ */
+
+#ifndef EVENT_SCHEDULE_TEST_H_
+#define EVENT_SCHEDULE_TEST_H_
+
+#include "event_schedule.h"
+
+/* Overlapping and touching events are merged, and cut to the window. */
+void testScheduleBusy();
+
+/* Free slots are the gaps long enough, up to the number asked for. */
+void testScheduleFreeSlots();
+
+/* Same results with and without an index. */
+void testScheduleIndexed();
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "event_stats_test.h"
+
+#define STATS_TEST_LOCATIONS 100
+
+static long dayMinutes(const struct EventStats *stats,
+                       const char *const stDate)
+{
+  struct Date date;
+
+  dateParse(stDate, &date);
+
+  return eventStatsDayMinutes(stats, &date);
+}
+
+static long weekMinutes(const struct EventStats *stats,
+                        const char *const stDate)
+{
+  struct Date date;
+
+  dateParse(stDate, &date);
+
+  return eventStatsWeekMinutes(stats, &date);
+}
+
+void testEventStatsEmpty() {
+  struct EventList *test_list;
+  struct EventStats *stats;
+
+  test_list = eventListCreate();
+  stats = eventStatsCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(stats);
+
+  CU_ASSERT_EQUAL(stats->total_minutes, 0);
+  CU_ASSERT_EQUAL(stats->location_count, 0);
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2013-11-08"), 0);
+  CU_ASSERT_EQUAL(weekMinutes(stats, "2013-11-08"), 0);
+  CU_ASSERT_EQUAL(eventStatsMonthMinutes(stats, 2013, 11), 0);
+  CU_ASSERT_EQUAL(eventStatsLocationMinutes(stats, "Home"), 0);
+
+  eventStatsDestroy(stats);
+  eventListDestroy(test_list);
+}
+
+void testEventStatsPeriods() {
+  struct EventList *test_list;
+  struct EventStats *stats;
+  struct Event *test_event;
+
+  test_list = eventListCreate();
+
+  /* Added out of order so the ranges have to grow both ways. */
+  eventCreate(&test_event, "2013-11-08", "10:00", 75, "Veg out", "Home");
+  eventListInsertLast(test_list, test_event);
+  eventCreate(&test_event, "2013-11-08", "11:15", 45, "Work", "The Labs");
+  eventListInsertLast(test_list, test_event);
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Early", NULL);
+  eventListInsertLast(test_list, test_event);
+  /* Sunday night into Monday, and October into November. */
+  eventCreate(&test_event, "2013-10-27", "23:00", 90, "Late", "Home");
+  eventListInsertLast(test_list, test_event);
+  eventCreate(&test_event, "2014-06-30", "23:59", 25920, "Armageddon",
+              "Earth");
+  eventListInsertLast(test_list, test_event);
+  eventCreate(&test_event, "2013-11-09", "00:00", 0, "Nothing", "Home");
+  eventListInsertLast(test_list, test_event);
+
+  stats = eventStatsCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(stats);
+
+  CU_ASSERT_EQUAL(stats->total_minutes, 75 + 45 + 10 + 90 + 25920);
+
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2013-11-08"), 120);
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2013-11-09"), 0);
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2010-05-24"), 10);
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2013-10-27"), 60);
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2013-10-28"), 30);
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2014-06-30"), 1);
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2014-07-05"), 1440);
+  CU_ASSERT_EQUAL(dayMinutes(stats, "2014-07-18"), 1439);
+
+  /* 2013-10-27 is a Sunday, the rest of Late is in the next week. */
+  CU_ASSERT_EQUAL(weekMinutes(stats, "2013-10-21"), 60);
+  CU_ASSERT_EQUAL(weekMinutes(stats, "2013-10-31"), 30);
+  CU_ASSERT_EQUAL(weekMinutes(stats, "2013-11-10"), 120);
+  CU_ASSERT_EQUAL(weekMinutes(stats, "2014-07-09"), 7 * 1440);
+
+  CU_ASSERT_EQUAL(eventStatsMonthMinutes(stats, 2013, 10), 90);
+  CU_ASSERT_EQUAL(eventStatsMonthMinutes(stats, 2013, 11), 120);
+  CU_ASSERT_EQUAL(eventStatsMonthMinutes(stats, 2014, 6), 1);
+  CU_ASSERT_EQUAL(eventStatsMonthMinutes(stats, 2014, 7), 25919);
+  CU_ASSERT_EQUAL(eventStatsMonthMinutes(stats, 2012, 7), 0);
+
+  CU_ASSERT_EQUAL(eventStatsLocationMinutes(stats, "Home"), 165);
+  CU_ASSERT_EQUAL(eventStatsLocationMinutes(stats, "The Labs"), 45);
+  CU_ASSERT_EQUAL(eventStatsLocationMinutes(stats, "Earth"), 25920);
+  CU_ASSERT_EQUAL(stats->location_count, 3);
+
+  eventStatsDestroy(stats);
+  eventListDestroy(test_list);
+}
+
+void testEventStatsLocations() {
+  struct EventList *test_list;
+  struct EventStats *stats;
+  struct Event *test_event;
+  char location[20];
+  int i;
+
+  test_list = eventListCreate();
+
+  for (i = 0; i < STATS_TEST_LOCATIONS * 3; i++) {
+    sprintf(location, "Room %d", i % STATS_TEST_LOCATIONS);
+    eventCreate(&test_event, "2013-11-08", "10:00", i % 3 + 1, "Event",
+                location);
+    eventListInsertLast(test_list, test_event);
+  }
+
+  stats = eventStatsCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(stats);
+  CU_ASSERT_EQUAL(stats->location_count, STATS_TEST_LOCATIONS);
+
+  for (i = 0; i < STATS_TEST_LOCATIONS; i++) {
+    sprintf(location, "Room %d", i);
+    CU_ASSERT_EQUAL(eventStatsLocationMinutes(stats, location), 6);
+  }
+
+  CU_ASSERT_EQUAL(eventStatsLocationMinutes(stats, "Room"), 0);
+
+  eventStatsDestroy(stats);
+  eventListDestroy(test_list);
+}
@@ -0,0 +1,23 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the calendar totals
+ */
+
+#ifndef EVENT_STATS_TEST_H_
+#define EVENT_STATS_TEST_H_
+
+#include "event_stats.h"
+
+/* Totals of an empty list are all 0. */
+void testEventStatsEmpty();
+
+/* Day, week and month totals, events over midnight are split. */
+void testEventStatsPeriods();
+
+/* Location totals, with enough locations to grow the hash table. */
+void testEventStatsLocations();
+
+#endif
@@ -47,7 +47,7 @@ void testCreateEvent() {
   CU_ASSERT_EQUAL(test_event->date.day, 10);
 
   CU_ASSERT_EQUAL(0, strcmp(test_event->name, VALID_NAME));
-  CU_ASSERT_EQUAL(0, strcmp(test_event->location, VALID_LOCATION));
+  CU_ASSERT_EQUAL(0, strcmp(eventLocation(test_event), VALID_LOCATION));
 
   /*
    * Test Event destroy as well.
@@ -134,7 +134,109 @@ void testCreateEventNoLocation() {
   cleanUpEvent(&test_event);
 }
 
+void testCopyEvent() {
+  enum EventError error_result;
+  struct Event *test_event, *copy_event;
+
+  eventCreate(&test_event, VALID_DATE, VALID_TIME, VALID_DURATION,
+              VALID_NAME, VALID_LOCATION);
+
+  error_result = eventCopy(&copy_event, test_event);
+
+  CU_ASSERT_EQUAL(error_result, EVENT_NO_ERROR);
+  CU_ASSERT_PTR_NOT_NULL(copy_event);
+
+  /* Same values, different strings. */
+  CU_ASSERT_STRING_EQUAL(test_event->name, copy_event->name);
+  CU_ASSERT_PTR_NOT_EQUAL(test_event->name, copy_event->name);
+  CU_ASSERT_STRING_EQUAL(eventLocation(test_event), eventLocation(copy_event));
+  CU_ASSERT_STRING_EQUAL(test_event->formatted_string,
+                         copy_event->formatted_string);
+  CU_ASSERT_EQUAL(test_event->formatted_string_length,
+                  copy_event->formatted_string_length);
+  CU_ASSERT_EQUAL(test_event->duration, copy_event->duration);
+
+  cleanUpEvent(&test_event);
+  cleanUpEvent(&copy_event);
+}
+
+void testEventTimestamp() {
+  struct Event *early_event, *late_event;
+
+  eventCreate(&early_event, "2010-10-10", "18:05", VALID_DURATION,
+              VALID_NAME, NULL);
+  eventCreate(&late_event, "2010-10-10", "18:06", VALID_DURATION,
+              VALID_NAME, NULL);
+
+  CU_ASSERT_EQUAL(1, late_event->timestamp - early_event->timestamp);
+  CU_ASSERT_TRUE(eventCompareStart(early_event, late_event) < 0);
+  CU_ASSERT_TRUE(eventCompareStart(late_event, early_event) > 0);
+
+  /* Editing has to keep the timestamp in step. */
+  eventEdit(late_event, "2009-10-10", "18:06", VALID_DURATION,
+            VALID_NAME, NULL);
+  CU_ASSERT_TRUE(eventCompareStart(late_event, early_event) < 0);
+
+  eventEdit(late_event, "2010-10-10", "18:05", VALID_DURATION,
+            VALID_NAME, NULL);
+  CU_ASSERT_EQUAL(0, eventCompareStart(late_event, early_event));
+
+  cleanUpEvent(&early_event);
+  cleanUpEvent(&late_event);
+}
+
+void testEventsOverlap() {
+  struct Event *first_event, *second_event;
+
+  eventCreate(&first_event, "2010-10-10", "23:00", 90, VALID_NAME, NULL);
+  eventCreate(&second_event, "2010-10-11", "00:15", 10, VALID_NAME, NULL);
+
+  CU_ASSERT_EQUAL(first_event->timestamp + 90,
+                  eventEndTimestamp(first_event));
+  CU_ASSERT_TRUE(eventsOverlap(first_event, second_event));
+  CU_ASSERT_TRUE(eventsOverlap(second_event, first_event));
+
+  /* Starting right when the other finishes is fine. */
+  eventEdit(second_event, "2010-10-11", "00:30", 10, VALID_NAME, NULL);
+  CU_ASSERT_FALSE(eventsOverlap(first_event, second_event));
+
+  cleanUpEvent(&first_event);
+  cleanUpEvent(&second_event);
+}
+
 static void cleanUpEvent(struct Event **event) {
   eventDestroy(*event);
   *event = NULL;
 }
+
+void testEventInlineName() {
+  struct Event *test_event, *copy_event;
+  char long_name[EVENT_INLINE_NAME_SIZE * 2];
+
+  memset(long_name, 'a', sizeof(long_name) - 1);
+  long_name[sizeof(long_name) - 1] = '\0';
+
+  eventCreate(&test_event, VALID_DATE, VALID_TIME, VALID_DURATION,
+              VALID_NAME, VALID_LOCATION);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_event);
+  CU_ASSERT_PTR_EQUAL(test_event->name, test_event->name_inline);
+  CU_ASSERT_STRING_EQUAL(test_event->name, VALID_NAME);
+
+  /* The copy has its own inline name. */
+  eventCopy(&copy_event, test_event);
+  CU_ASSERT_PTR_EQUAL(copy_event->name, copy_event->name_inline);
+  CU_ASSERT_STRING_EQUAL(copy_event->name, VALID_NAME);
+  eventDestroy(copy_event);
+
+  eventEdit(test_event, VALID_DATE, VALID_TIME, VALID_DURATION, long_name,
+            VALID_LOCATION);
+  CU_ASSERT_PTR_NOT_EQUAL(test_event->name, test_event->name_inline);
+  CU_ASSERT_STRING_EQUAL(test_event->name, long_name);
+
+  eventEdit(test_event, VALID_DATE, VALID_TIME, VALID_DURATION, VALID_NAME,
+            VALID_LOCATION);
+  CU_ASSERT_PTR_EQUAL(test_event->name, test_event->name_inline);
+  CU_ASSERT_STRING_EQUAL(test_event->name, VALID_NAME);
+
+  eventDestroy(test_event);
+}
@@ -15,4 +15,12 @@ void testCreateEventInvalidName();
 
 void testCreateEventNoLocation();
 
+void testCopyEvent();
+
+void testEventTimestamp();
+
+void testEventsOverlap();
+
+void testEventInlineName();
+
 #endif
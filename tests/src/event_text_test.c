@@ -0,0 +1,239 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "event_text_test.h"
+
+#define TEXT_TEST_EVENTS 300
+#define TEXT_TEST_KEPT 30
+
+/*
+ * Run the query, check how many events it found and that the first
+ * one is the one expected (if any are expected).
+ */
+static void textTestExpect(struct EventTextIndex *index, const char *query,
+                           int expected_count, struct Event *expected_first)
+{
+  struct Event **found;
+  int count;
+
+  count = eventTextSearch(index, query, &found);
+  CU_ASSERT_EQUAL(count, expected_count);
+
+  if (count > 0) {
+    CU_ASSERT_PTR_EQUAL(found[0], expected_first);
+  }
+
+  if (count >= 0) {
+    free(found);
+  }
+}
+
+static struct EventList *textTestList(struct Event **events)
+{
+  struct EventList *list;
+
+  list = eventListCreate();
+  eventCreate(&events[0], "2013-05-01", "09:00", 30, "Team Meeting",
+              "Lab 2");
+  eventCreate(&events[1], "2013-05-01", "12:00", 60, "Lunch with team",
+              "Cafe");
+  eventCreate(&events[2], "2013-05-02", "10:00", 45, "Lab report review",
+              "Room 1.04");
+  eventCreate(&events[3], "2013-05-03", "15:00", 90, "Meetup: C/C++",
+              NULL);
+  eventListInsertLast(list, events[0]);
+  eventListInsertLast(list, events[1]);
+  eventListInsertLast(list, events[2]);
+  eventListInsertLast(list, events[3]);
+
+  return list;
+}
+
+void testEventTextSearch() {
+  struct EventList *list;
+  struct EventTextIndex *index;
+  struct Event *events[4];
+
+  list = textTestList(events);
+  index = eventTextCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  textTestExpect(index, "team", 2, events[0]);
+  textTestExpect(index, "TEAM meeting", 1, events[0]);
+  textTestExpect(index, "team review", 0, NULL);
+  textTestExpect(index, "review OR lunch", 2, events[1]);
+  textTestExpect(index, "team lunch OR review", 1, events[1]);
+  textTestExpect(index, "meet*", 2, events[0]);
+  textTestExpect(index, "m*", 2, events[0]);
+  textTestExpect(index, "lab", 2, events[0]);
+  textTestExpect(index, "name:lab", 1, events[2]);
+  textTestExpect(index, "location:lab", 1, events[0]);
+  textTestExpect(index, "location:2", 1, events[0]);
+  textTestExpect(index, "1.04", 1, events[2]);
+  textTestExpect(index, "c++", 1, events[3]);
+  textTestExpect(index, "  cafe  ", 1, events[1]);
+  textTestExpect(index, "cafe OR", 1, events[1]);
+  textTestExpect(index, "meeting -", 1, events[0]);
+  textTestExpect(index, "", 0, NULL);
+  textTestExpect(index, "dentist", 0, NULL);
+  textTestExpect(index, "dentist OR team", 2, events[0]);
+
+  eventTextDestroy(index);
+  CU_ASSERT_PTR_NULL(list->watchers);
+  eventListDestroy(list);
+}
+
+void testEventTextUpdates() {
+  struct EventList *list;
+  struct EventTextIndex *index;
+  struct Event *events[4];
+  struct Event *added, *replacement;
+
+  list = textTestList(events);
+  index = eventTextCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  eventCreate(&added, "2013-05-04", "11:00", 30, "Dentist", "Main St");
+  eventListInsertLast(list, added);
+  textTestExpect(index, "dentist", 1, added);
+  textTestExpect(index, "main", 1, added);
+
+  /* Edited events lose their old words, and move to the end. */
+  CU_ASSERT_EQUAL(eventListEdit(list, events[0], "2013-05-01", "09:00", 30,
+                                "Standup", "Lab 2"), EVENT_NO_ERROR);
+  textTestExpect(index, "meeting", 0, NULL);
+  textTestExpect(index, "standup", 1, events[0]);
+  textTestExpect(index, "lab", 2, events[2]);
+
+  CU_ASSERT_TRUE(eventListRenameLocation(list, "Cafe", "Canteen"));
+  textTestExpect(index, "cafe", 0, NULL);
+  textTestExpect(index, "canteen", 1, events[1]);
+
+  eventCreate(&replacement, "2013-05-02", "10:00", 45, "Lab report due",
+              NULL);
+  CU_ASSERT_TRUE(eventListReplace(list, events[2], replacement));
+  eventDestroy(events[2]);
+  textTestExpect(index, "review", 0, NULL);
+  textTestExpect(index, "due", 1, replacement);
+
+  CU_ASSERT_TRUE(eventListDelete(list, added));
+  textTestExpect(index, "dentist", 0, NULL);
+  textTestExpect(index, "dentist OR standup", 1, events[0]);
+
+  CU_ASSERT_FALSE(index->memory_error);
+  eventTextDestroy(index);
+  eventListDestroy(list);
+}
+
+void testEventTextCompact() {
+  struct EventList *list;
+  struct EventTextIndex *index;
+  struct Event *events[TEXT_TEST_EVENTS];
+  struct Event **found;
+  char name[32];
+  int terms_before, count, i;
+
+  list = eventListCreate();
+  index = eventTextCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  /* Built up as the events are added, not all at once. */
+  for (i = 0; i < TEXT_TEST_EVENTS; i++) {
+    sprintf(name, "Event %d group%d", i, i % 3);
+    eventCreate(&events[i], "2013-05-01", "10:00", 30, name, NULL);
+    eventListInsertLast(list, events[i]);
+  }
+
+  textTestExpect(index, "group1", TEXT_TEST_EVENTS / 3, events[1]);
+  textTestExpect(index, "299", 1, events[299]);
+  terms_before = index->term_count;
+
+  for (i = TEXT_TEST_KEPT; i < TEXT_TEST_EVENTS; i++) {
+    eventListDelete(list, events[i]);
+  }
+
+  CU_ASSERT(index->id_count < TEXT_TEST_EVENTS);
+  CU_ASSERT(index->term_count < terms_before);
+  CU_ASSERT_EQUAL(index->live_count, TEXT_TEST_KEPT);
+
+  count = eventTextSearch(index, "group1 OR group2", &found);
+  CU_ASSERT_EQUAL_FATAL(count, TEXT_TEST_KEPT * 2 / 3);
+
+  for (i = 0; i < count; i++) {
+    CU_ASSERT_PTR_EQUAL(found[i], events[i + i / 2 + 1]);
+  }
+
+  free(found);
+  textTestExpect(index, "299", 0, NULL);
+  textTestExpect(index, "event 7", 1, events[7]);
+  textTestExpect(index, "even*", TEXT_TEST_KEPT, events[0]);
+
+  eventTextDestroy(index);
+  eventListDestroy(list);
+}
+
+void testEventTextPrefixTerms() {
+  struct EventList *list;
+  struct EventTextIndex *index;
+  struct Event *events[TEXT_TEST_EVENTS];
+  char name[32];
+  Boolean in_order;
+  int i;
+
+  list = eventListCreate();
+  index = eventTextCreate(list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  /* Enough words for the sorted terms to grow. */
+  for (i = 0; i < TEXT_TEST_EVENTS; i++) {
+    sprintf(name, "alp%d word%d", i, i);
+    eventCreate(&events[i], "2013-05-01", "10:00", 30, name,
+                i % 2 == 0 ? "alpine" : NULL);
+    eventListInsertLast(list, events[i]);
+  }
+
+  textTestExpect(index, "alp*", TEXT_TEST_EVENTS, events[0]);
+  textTestExpect(index, "name:alp1*", 111, events[1]);
+  textTestExpect(index, "location:alp*", TEXT_TEST_EVENTS / 2, events[0]);
+  textTestExpect(index, "alp1", 1, events[1]);
+  textTestExpect(index, "alp", 0, NULL);
+  textTestExpect(index, "word29*", 11, events[29]);
+  textTestExpect(index, "zzz*", 0, NULL);
+
+  /* Still sorted, and prefixes still found, once terms are dropped. */
+  for (i = TEXT_TEST_KEPT; i < TEXT_TEST_EVENTS; i++) {
+    eventListDelete(list, events[i]);
+  }
+
+  in_order = TRUE;
+
+  for (i = 1; i < index->term_count; i++) {
+    in_order = in_order &&
+               strcmp(index->sorted[i - 1]->text, index->sorted[i]->text) <= 0;
+  }
+
+  CU_ASSERT_TRUE(in_order);
+  textTestExpect(index, "alp2*", 11, events[2]);
+  textTestExpect(index, "alpine", TEXT_TEST_KEPT / 2, events[0]);
+
+  /* New terms wait on the end until the next search sorts them in. */
+  eventCreate(&events[TEXT_TEST_KEPT], "2013-05-01", "10:00", 30, "aardvark",
+              NULL);
+  eventListInsertLast(list, events[TEXT_TEST_KEPT]);
+  CU_ASSERT_TRUE(index->sorted_dirty);
+  textTestExpect(index, "aard*", 1, events[TEXT_TEST_KEPT]);
+  CU_ASSERT_FALSE(index->sorted_dirty);
+  CU_ASSERT_STRING_EQUAL(index->sorted[0]->text, "aardvark");
+
+  eventTextDestroy(index);
+  eventListDestroy(list);
+}
@@ -0,0 +1,26 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for searching by words in names and locations
+ */
+
+#ifndef EVENT_TEXT_TEST_H_
+#define EVENT_TEXT_TEST_H_
+
+#include "event_text.h"
+
+/* AND, OR, prefixes and fields, ignoring case and punctuation. */
+void testEventTextSearch();
+
+/* Inserts, edits, deletes and renames are picked up as they happen. */
+void testEventTextUpdates();
+
+/* Deleting most events compacts the postings without losing any. */
+void testEventTextCompact();
+
+/* Prefixes binary search the sorted terms, before and after compacting. */
+void testEventTextPrefixTerms();
+
+#endif
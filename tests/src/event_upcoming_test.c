@@ -0,0 +1,95 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "event_upcoming_test.h"
+#include "test_calendar.h"
+
+#define UPCOMING_TEST_EVENTS 500
+#define UPCOMING_TEST_COUNT 20
+
+void testEventUpcomingScan() {
+  struct EventList *test_list;
+  struct Event *test_event;
+  struct Event *upcoming[4];
+  const char *const names[] = {"Second", "Third", "Fourth"};
+  int found, i;
+
+  test_list = eventListCreate();
+  eventCreate(&test_event, "2013-11-09", "10:00", 10, "Fourth", NULL);
+  eventListInsertLast(test_list, test_event);
+  eventCreate(&test_event, "2013-11-07", "10:00", 10, "Past", NULL);
+  eventListInsertLast(test_list, test_event);
+  eventCreate(&test_event, "2013-11-08", "10:00", 10, "Second", NULL);
+  eventListInsertLast(test_list, test_event);
+  eventCreate(&test_event, "2013-11-08", "10:00", 10, "Third", NULL);
+  eventListInsertLast(test_list, test_event);
+
+  found = eventUpcoming(test_list, NULL,
+                        testCalendarTime("2013-11-08", "10:00"), 4,
+                        upcoming);
+  CU_ASSERT_EQUAL(found, 3);
+
+  for (i = 0; i < found && i < 3; i++) {
+    CU_ASSERT_STRING_EQUAL(upcoming[i]->name, names[i]);
+  }
+
+  found = eventUpcoming(test_list, NULL,
+                        testCalendarTime("2013-11-08", "10:00"), 1,
+                        upcoming);
+  CU_ASSERT_EQUAL(found, 1);
+  CU_ASSERT_STRING_EQUAL(upcoming[0]->name, "Second");
+
+  found = eventUpcoming(test_list, NULL,
+                        testCalendarTime("2014-01-01", "00:00"), 4,
+                        upcoming);
+  CU_ASSERT_EQUAL(found, 0);
+
+  eventListDestroy(test_list);
+}
+
+void testEventUpcomingIndexed() {
+  struct EventList *test_list;
+  struct EventIndex *index;
+  struct Event *test_event;
+  struct Event *scanned[UPCOMING_TEST_COUNT], *indexed[UPCOMING_TEST_COUNT];
+  char stDate[11], stTime[6];
+  Timestamp from;
+  int i, scanned_found, indexed_found;
+
+  test_list = eventListCreate();
+
+  for (i = 0; i < UPCOMING_TEST_EVENTS; i++) {
+    sprintf(stDate, "2013-%02d-%02d", i * 5 % 12 + 1, i * 11 % 28 + 1);
+    sprintf(stTime, "%02d:%02d", i * 7 % 24, i % 2 * 30);
+    eventCreate(&test_event, stDate, stTime, 10, "Event", NULL);
+    eventListInsertLast(test_list, test_event);
+  }
+
+  index = eventIndexCreate(test_list);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(index);
+
+  for (i = 0; i < 12; i++) {
+    sprintf(stDate, "2013-%02d-15", i + 1);
+    from = testCalendarTime(stDate, "12:00");
+
+    scanned_found = eventUpcoming(test_list, NULL, from, UPCOMING_TEST_COUNT,
+                                  scanned);
+    indexed_found = eventUpcoming(test_list, index, from,
+                                  UPCOMING_TEST_COUNT, indexed);
+    CU_ASSERT_EQUAL(scanned_found, indexed_found);
+    CU_ASSERT_TRUE(scanned_found == indexed_found &&
+                   memcmp(scanned, indexed,
+                          sizeof(struct Event *) * scanned_found) == 0);
+  }
+
+  eventIndexDestroy(index);
+  eventListDestroy(test_list);
+}
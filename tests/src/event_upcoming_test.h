@@ -0,0 +1,20 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the upcoming events
+ */
+
+#ifndef EVENT_UPCOMING_TEST_H_
+#define EVENT_UPCOMING_TEST_H_
+
+#include "event_upcoming.h"
+
+/* Next events in order, ties in list order, past events left out. */
+void testEventUpcomingScan();
+
+/* Same results with and without an index. */
+void testEventUpcomingIndexed();
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "alloc_counter.h"
+#include "calendar_file.h"
+#include "event_list.h"
+#include "instrument_test.h"
+
+#define JSON_BUFFER_SIZE 1024
+
+void testInstrumentCounters() {
+  void *block;
+
+  instrumentReset();
+
+  instrumentCount(INSTRUMENT_FIND_PROBES, 3);
+  instrumentCount(INSTRUMENT_FIND_PROBES, 4);
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_FIND_PROBES), 7);
+
+  instrumentStart(INSTRUMENT_FIND);
+  instrumentStop(INSTRUMENT_FIND);
+  instrumentStart(INSTRUMENT_FIND);
+  instrumentStop(INSTRUMENT_FIND);
+  CU_ASSERT_EQUAL(instrumentTiming(INSTRUMENT_FIND)->calls, 2);
+  CU_ASSERT_TRUE(instrumentTiming(INSTRUMENT_FIND)->total >= 0);
+  CU_ASSERT_TRUE(instrumentTiming(INSTRUMENT_FIND)->longest <=
+                 instrumentTiming(INSTRUMENT_FIND)->total);
+
+  instrumentReset();
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_FIND_PROBES), 0);
+  CU_ASSERT_EQUAL(instrumentTiming(INSTRUMENT_FIND)->calls, 0);
+
+  /* Allocations are only counted when they work. */
+  block = instrumentMalloc(16);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(block);
+  block = instrumentRealloc(block, 32);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(block);
+  free(block);
+  block = instrumentCalloc(4, 8);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(block);
+  free(block);
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_MALLOCS), 3);
+
+  allocCounterFailAfter(0);
+  CU_ASSERT_PTR_NULL(instrumentMalloc(16));
+  CU_ASSERT_PTR_NULL(instrumentCalloc(4, 8));
+  allocCounterFailAfter(-1);
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_MALLOCS), 3);
+}
+
+void testInstrumentOperations() {
+  struct EventList *test_list;
+  char *calendar_text;
+
+  instrumentReset();
+
+  test_list = eventListCreate();
+  CU_ASSERT_EQUAL(loadCalendar(test_list, "data/test.txt"), FILE_NO_ERROR);
+  calendar_text = eventListString(test_list);
+  CU_ASSERT_PTR_NOT_NULL(eventListFind(test_list, "Veg out"));
+  CU_ASSERT_EQUAL(saveCalendar(test_list, "saved/instrument.txt"),
+                  FILE_NO_ERROR);
+
+#ifdef INSTRUMENT
+  CU_ASSERT_EQUAL(instrumentTiming(INSTRUMENT_LOAD)->calls, 1);
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_LOAD_RECORDS), 4);
+  CU_ASSERT_EQUAL(instrumentTiming(INSTRUMENT_PARSE)->calls, 4);
+  CU_ASSERT_TRUE(instrumentValue(INSTRUMENT_LOAD_BYTES) > 0);
+  CU_ASSERT_TRUE(instrumentValue(INSTRUMENT_LOAD_MALLOCS) > 0);
+  CU_ASSERT_TRUE(instrumentValue(INSTRUMENT_LOAD_MALLOCS) <=
+                 instrumentValue(INSTRUMENT_MALLOCS));
+
+  CU_ASSERT_EQUAL(instrumentTiming(INSTRUMENT_RENDER)->calls, 1);
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_RENDER_BYTES),
+                  (long long) strlen(calendar_text) + 1);
+
+  CU_ASSERT_EQUAL(instrumentTiming(INSTRUMENT_FIND)->calls, 1);
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_FIND_PROBES), 1);
+
+  /* Same calendar back out, plus an id line for each of the events. */
+  CU_ASSERT_EQUAL(instrumentTiming(INSTRUMENT_SAVE)->calls, 1);
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_SAVE_BYTES),
+                  instrumentValue(INSTRUMENT_LOAD_BYTES) +
+                  4 * (long long) strlen("#id 1\n"));
+  CU_ASSERT_EQUAL(instrumentValue(INSTRUMENT_SAVE_SYSCALLS), 3);
+#endif
+
+  free(calendar_text);
+  eventListDestroy(test_list);
+}
+
+void testInstrumentJson() {
+  FILE *output;
+  char json[JSON_BUFFER_SIZE];
+  size_t length;
+
+  instrumentReset();
+  instrumentCount(INSTRUMENT_LOAD_RECORDS, 12);
+
+  output = tmpfile();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(output);
+  CU_ASSERT_TRUE(instrumentDumpJson(output));
+
+  rewind(output);
+  length = fread(json, 1, JSON_BUFFER_SIZE - 1, output);
+  json[length] = '\0';
+  fclose(output);
+
+  CU_ASSERT_EQUAL(json[0], '{');
+  CU_ASSERT_PTR_NOT_NULL(strstr(json, "\"load\": {"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(json, "\"records\": 12"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(json, "\"render\": {"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(json, "\"find\": {"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(json, "\"save\": {"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(json, "\"mallocs\": 0\n}"));
+}
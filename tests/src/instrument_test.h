@@ -0,0 +1,26 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the instrumentation
+ */
+
+#ifndef INSTRUMENT_TEST_H_
+#define INSTRUMENT_TEST_H_
+
+#include "instrument.h"
+
+/*
+ * Counters add up, timers count calls, reset clears them, and only
+ * allocations that work are counted.
+ */
+void testInstrumentCounters();
+
+/* Load, render, find and save count what they did. */
+void testInstrumentOperations();
+
+/* The JSON has every group in it. */
+void testInstrumentJson();
+
+#endif
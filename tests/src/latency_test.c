@@ -0,0 +1,89 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "latency_test.h"
+
+void testLatencyBuckets() {
+  struct LatencyHistogram histogram;
+  long long value, percentile;
+
+  for (value = 0; value < LATENCY_SUB_BUCKETS * 2; value++) {
+    latencyHistogramReset(&histogram);
+    latencyHistogramRecord(&histogram, value);
+    latencyHistogramRecord(&histogram, value + 1000000);
+    CU_ASSERT_EQUAL(latencyHistogramPercentile(&histogram, 50.0), value);
+  }
+
+  /* The top of the bucket, but never more than a sub bucket over. */
+  for (value = 100; value < 10000000000LL; value = value * 3 + 7) {
+    latencyHistogramReset(&histogram);
+    latencyHistogramRecord(&histogram, value);
+    latencyHistogramRecord(&histogram, value * 4);
+    percentile = latencyHistogramPercentile(&histogram, 50.0);
+    CU_ASSERT_TRUE(percentile >= value);
+    CU_ASSERT_TRUE(percentile <= value + value / LATENCY_SUB_BUCKETS);
+  }
+
+  latencyHistogramReset(&histogram);
+  latencyHistogramRecord(&histogram, -5);
+  latencyHistogramRecord(&histogram, 1LL << (LATENCY_MAX_POWER + 2));
+  CU_ASSERT_EQUAL(latencyHistogramPercentile(&histogram, 50.0), 0);
+  CU_ASSERT_EQUAL(histogram.max, 1LL << (LATENCY_MAX_POWER + 2));
+}
+
+void testLatencyPercentiles() {
+  struct LatencyHistogram histogram;
+  long long value;
+
+  latencyHistogramReset(&histogram);
+  CU_ASSERT_EQUAL(latencyHistogramPercentile(&histogram, 99.0), 0);
+
+  for (value = 1; value <= 1000; value++) {
+    latencyHistogramRecord(&histogram, value);
+  }
+
+  CU_ASSERT_EQUAL(histogram.total, 1000);
+  CU_ASSERT_EQUAL(histogram.max, 1000);
+
+  CU_ASSERT_TRUE(latencyHistogramPercentile(&histogram, 50.0) >= 500);
+  CU_ASSERT_TRUE(latencyHistogramPercentile(&histogram, 50.0) <= 532);
+  CU_ASSERT_TRUE(latencyHistogramPercentile(&histogram, 90.0) >= 900);
+  CU_ASSERT_TRUE(latencyHistogramPercentile(&histogram, 90.0) <= 957);
+  CU_ASSERT_TRUE(latencyHistogramPercentile(&histogram, 99.0) >= 990);
+  CU_ASSERT_EQUAL(latencyHistogramPercentile(&histogram, 100.0), 1000);
+  CU_ASSERT_EQUAL(latencyHistogramPercentile(&histogram, 0.0), 1);
+}
+
+void testLatencyActions() {
+  char *report;
+
+  latencyReset();
+
+  latencyStop(LATENCY_SAVE);
+  CU_ASSERT_EQUAL(latencyHistogram(LATENCY_SAVE)->total, 0);
+
+  latencyStart(LATENCY_SAVE);
+  latencyStop(LATENCY_SAVE);
+  latencyStop(LATENCY_SAVE);
+  CU_ASSERT_EQUAL(latencyHistogram(LATENCY_SAVE)->total, 1);
+  CU_ASSERT_EQUAL(latencyHistogram(LATENCY_LOAD)->total, 0);
+
+  report = latencyReport(42);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(report);
+  CU_ASSERT_PTR_NOT_NULL(strstr(report, "Calendar: 42 events\n"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(report, "\nLoad          0 "));
+  CU_ASSERT_PTR_NOT_NULL(strstr(report, "\nSave          1 "));
+  CU_ASSERT_PTR_NOT_NULL(strstr(report, "\nDelete        0 "));
+  free(report);
+
+  latencyReset();
+  CU_ASSERT_EQUAL(latencyHistogram(LATENCY_SAVE)->total, 0);
+}
@@ -0,0 +1,23 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the latency histograms
+ */
+
+#ifndef LATENCY_TEST_H_
+#define LATENCY_TEST_H_
+
+#include "latency.h"
+
+/* Small values are exact, big ones within a sub bucket. */
+void testLatencyBuckets();
+
+/* Percentiles of a known spread of values. */
+void testLatencyPercentiles();
+
+/* Actions are only recorded between a start and a stop. */
+void testLatencyActions();
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "event_list.h"
+#include "pool_test.h"
+
+#define POOL_TEST_SLAB 8
+#define POOL_TEST_OBJECTS 100
+
+void testPoolReuse() {
+  struct Pool *pool;
+  void *first, *second, *again;
+
+  pool = poolCreate(24, POOL_TEST_SLAB, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(pool);
+
+  first = poolAlloc(pool);
+  second = poolAlloc(pool);
+  CU_ASSERT_PTR_NOT_NULL(first);
+  CU_ASSERT_PTR_NOT_NULL(second);
+  CU_ASSERT_PTR_NOT_EQUAL(first, second);
+  CU_ASSERT_EQUAL(pool->in_use, 2);
+
+  poolFree(pool, first);
+  CU_ASSERT_EQUAL(pool->in_use, 1);
+  again = poolAlloc(pool);
+  CU_ASSERT_PTR_EQUAL(again, first);
+
+  poolFree(pool, second);
+  poolFree(pool, again);
+  CU_ASSERT_EQUAL(pool->in_use, 0);
+  poolRelease(pool);
+}
+
+void testPoolSlabs() {
+  struct Pool *pool;
+  long long *objects[POOL_TEST_OBJECTS];
+  int i, j;
+
+  /* Odd size, so the rounding up matters. */
+  pool = poolCreate(sizeof(long long) + 1, POOL_TEST_SLAB, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(pool);
+  CU_ASSERT_TRUE(pool->object_size >= sizeof(long long) + 1);
+  CU_ASSERT_EQUAL(pool->object_size % sizeof(long long), 0);
+
+  for (i = 0; i < POOL_TEST_OBJECTS; i++) {
+    objects[i] = (long long *) poolAlloc(pool);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(objects[i]);
+    *objects[i] = i;
+  }
+
+  for (i = 0; i < POOL_TEST_OBJECTS; i++) {
+    CU_ASSERT_EQUAL(*objects[i], i);
+
+    for (j = i + 1; j < POOL_TEST_OBJECTS; j++) {
+      CU_ASSERT_PTR_NOT_EQUAL(objects[i], objects[j]);
+    }
+  }
+
+  /* Free every other one, then get them back. */
+  for (i = 0; i < POOL_TEST_OBJECTS; i += 2) {
+    poolFree(pool, objects[i]);
+  }
+
+  CU_ASSERT_EQUAL(pool->in_use, POOL_TEST_OBJECTS / 2);
+
+  for (i = 0; i < POOL_TEST_OBJECTS; i += 2) {
+    objects[i] = (long long *) poolAlloc(pool);
+    CU_ASSERT_PTR_NOT_NULL(objects[i]);
+  }
+
+  CU_ASSERT_EQUAL(pool->in_use, POOL_TEST_OBJECTS);
+
+  /* Released with everything still out, freed with the last one. */
+  poolRelease(pool);
+
+  for (i = 0; i < POOL_TEST_OBJECTS; i++) {
+    poolFree(pool, objects[i]);
+  }
+}
+
+void testPoolAligned() {
+  struct Pool *pool;
+  void *objects[POOL_TEST_OBJECTS];
+  int i;
+
+  pool = poolCreate(100, POOL_TEST_SLAB, POOL_CACHE_LINE);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(pool);
+  CU_ASSERT_EQUAL(pool->object_size, 2 * POOL_CACHE_LINE);
+
+  for (i = 0; i < POOL_TEST_OBJECTS; i++) {
+    objects[i] = poolAlloc(pool);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(objects[i]);
+    CU_ASSERT_EQUAL((size_t) objects[i] % POOL_CACHE_LINE, 0);
+    memset(objects[i], i, 100);
+  }
+
+  for (i = 0; i < POOL_TEST_OBJECTS; i++) {
+    poolFree(pool, objects[i]);
+  }
+
+  poolRelease(pool);
+}
+
+void testPoolRelease() {
+  struct EventList *test_list;
+  struct Event *kept, *deleted, *test_event;
+
+  test_list = eventListCreate();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(test_list);
+
+  CU_ASSERT_EQUAL(eventListCreateEvent(test_list, &kept, "2013-05-24",
+                                       "06:15", 10, "Kept", "Room 1"),
+                  EVENT_NO_ERROR);
+  CU_ASSERT_PTR_EQUAL(kept->pool, test_list->event_pool);
+  CU_ASSERT_EQUAL((size_t) kept % POOL_CACHE_LINE, 0);
+  CU_ASSERT_EQUAL(eventListCreateEvent(test_list, &deleted, "2013-05-25",
+                                       "06:15", 10, "Deleted", NULL),
+                  EVENT_NO_ERROR);
+  CU_ASSERT_EQUAL(eventListCreateEvent(test_list, &test_event,
+                                       "2013-05-32", "06:15", 10, "Bad",
+                                       NULL),
+                  EVENT_DATE_INVALID);
+  CU_ASSERT_PTR_NULL(test_event);
+
+  CU_ASSERT_TRUE(eventListInsertLast(test_list, kept));
+  CU_ASSERT_TRUE(eventListInsertLast(test_list, deleted));
+  CU_ASSERT_TRUE(eventListDelete(test_list, deleted));
+  CU_ASSERT_EQUAL(test_list->event_pool->in_use, 1);
+
+  /* The list goes, the event taken out of it is still fine. */
+  CU_ASSERT_TRUE(eventListRemove(test_list, kept));
+  eventListDestroy(test_list);
+  CU_ASSERT_STRING_EQUAL(kept->name, "Kept");
+  CU_ASSERT_STRING_EQUAL(eventLocation(kept), "Room 1");
+
+  eventDestroy(kept);
+}
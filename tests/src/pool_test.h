@@ -0,0 +1,26 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the object pools
+ */
+
+#ifndef POOL_TEST_H_
+#define POOL_TEST_H_
+
+#include "pool.h"
+
+/* Freed objects are handed out again before new ones. */
+void testPoolReuse();
+
+/* Objects from many slabs are all separate and aligned. */
+void testPoolSlabs();
+
+/* Objects can be made to start on cache lines. */
+void testPoolAligned();
+
+/* Pools and list events outlive the list that released them. */
+void testPoolRelease();
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <pthread.h>
+
+#include <CUnit/CUnit.h>
+
+#include "shared_event_list_test.h"
+
+#define READER_THREADS 3
+#define WRITER_INSERTS 200
+
+/*
+ * What each reader thread is given, and what it reports back.
+ */
+struct ReaderTestState {
+  struct SharedEventList *shared;
+  Boolean stop;
+  Boolean consistent;
+};
+
+static void *readerThread(void *in_data);
+
+void testSharedEventListSnapshotIsolation() {
+  struct SharedEventList *shared;
+  struct Event *test_event_one, *test_event_two;
+  const struct EventListSnapshot *before, *after;
+
+  shared = sharedEventListCreate(eventListCreate());
+  CU_ASSERT_PTR_NOT_NULL(shared);
+
+  eventCreate(&test_event_one, "2010-05-24", "06:15", 10, "Event 1", NULL);
+  eventCreate(&test_event_two, "2011-05-24", "06:15", 10, "Event 2", NULL);
+
+  CU_ASSERT_TRUE(sharedEventListInsertLast(shared, test_event_one));
+  CU_ASSERT_TRUE(sharedEventListInsertLast(shared, test_event_two));
+
+  before = sharedEventListAcquire(shared);
+  CU_ASSERT_EQUAL(2, before->count);
+
+  CU_ASSERT_TRUE(sharedEventListDelete(shared, test_event_one));
+
+  after = sharedEventListAcquire(shared);
+  CU_ASSERT_EQUAL(1, after->count);
+  CU_ASSERT_PTR_EQUAL(test_event_two, after->events[0]);
+  CU_ASSERT_TRUE(after->version > before->version);
+
+  /* Old snapshot still has the deleted event, and it's still valid. */
+  CU_ASSERT_EQUAL(2, before->count);
+  CU_ASSERT_STRING_EQUAL("Event 1", before->events[0]->name);
+
+  sharedEventListRelease(shared, before);
+  sharedEventListRelease(shared, after);
+  sharedEventListReclaim(shared);
+
+  CU_ASSERT_PTR_EQUAL(shared->oldest, shared->current);
+
+  sharedEventListDestroy(shared);
+}
+
+void testSharedEventListEdit() {
+  struct SharedEventList *shared;
+  struct Event *test_event, *edited_event;
+  const struct EventListSnapshot *before, *after;
+  char *snapshot_string, *list_string;
+
+  shared = sharedEventListCreate(eventListCreate());
+  CU_ASSERT_PTR_NOT_NULL(shared);
+
+  eventCreate(&test_event, "2010-05-24", "06:15", 10, "Event 1", NULL);
+  CU_ASSERT_TRUE(sharedEventListInsertLast(shared, test_event));
+
+  before = sharedEventListAcquire(shared);
+
+  CU_ASSERT_EQUAL(EVENT_NO_ERROR,
+                  sharedEventListEdit(shared, test_event, &edited_event,
+                                      "2010-05-25", "07:00", 20,
+                                      "Edited", "Home"));
+  CU_ASSERT_PTR_NOT_EQUAL(test_event, edited_event);
+
+  after = sharedEventListAcquire(shared);
+  CU_ASSERT_STRING_EQUAL("Event 1", before->events[0]->name);
+  CU_ASSERT_STRING_EQUAL("Edited", after->events[0]->name);
+
+  snapshot_string = eventListSnapshotString(after);
+  list_string = eventListString(shared->list);
+  CU_ASSERT_PTR_NOT_NULL(snapshot_string);
+  CU_ASSERT_STRING_EQUAL(snapshot_string, list_string);
+  free(snapshot_string);
+  free(list_string);
+
+  /* Invalid fields leave the event alone. */
+  CU_ASSERT_EQUAL(EVENT_DATE_INVALID,
+                  sharedEventListEdit(shared, edited_event, &test_event,
+                                      "2010-13-25", "07:00", 20,
+                                      "Edited", "Home"));
+  CU_ASSERT_PTR_EQUAL(test_event, edited_event);
+
+  sharedEventListRelease(shared, before);
+  sharedEventListRelease(shared, after);
+  sharedEventListDestroy(shared);
+}
+
+void testSharedEventListConcurrentReaders() {
+  struct SharedEventList *shared;
+  struct ReaderTestState reader_state;
+  pthread_t readers[READER_THREADS];
+  struct Event *new_event;
+  int i;
+
+  shared = sharedEventListCreate(eventListCreate());
+  CU_ASSERT_PTR_NOT_NULL(shared);
+
+  reader_state.shared = shared;
+  reader_state.stop = FALSE;
+  reader_state.consistent = TRUE;
+
+  for (i = 0; i < READER_THREADS; i++) {
+    pthread_create(&readers[i], NULL, readerThread, &reader_state);
+  }
+
+  for (i = 0; i < WRITER_INSERTS; i++) {
+    eventCreate(&new_event, "2010-05-24", "06:15", i, "Event", NULL);
+    sharedEventListInsertLast(shared, new_event);
+
+    /* Keep the list from growing too much, delete every other one. */
+    if (i % 2 == 1) {
+      sharedEventListDelete(shared, shared->list->head->event);
+    }
+  }
+
+  pthread_mutex_lock(&shared->snapshot_lock);
+  reader_state.stop = TRUE;
+  pthread_mutex_unlock(&shared->snapshot_lock);
+
+  for (i = 0; i < READER_THREADS; i++) {
+    pthread_join(readers[i], NULL);
+  }
+
+  CU_ASSERT_TRUE(reader_state.consistent);
+
+  sharedEventListDestroy(shared);
+}
+
+/*
+ * Keep taking snapshots, each one should have increasing durations
+ * since that's the order the writer inserts them in.
+ */
+static void *readerThread(void *in_data)
+{
+  struct ReaderTestState *state = (struct ReaderTestState *)in_data;
+  const struct EventListSnapshot *snapshot;
+  Boolean stop, consistent;
+  int i;
+
+  stop = FALSE;
+  consistent = TRUE;
+
+  while (!stop) {
+    snapshot = sharedEventListAcquire(state->shared);
+
+    for (i = 1; i < snapshot->count; i++) {
+      if (snapshot->events[i - 1]->duration >= snapshot->events[i]->duration) {
+        consistent = FALSE;
+      }
+    }
+
+    sharedEventListRelease(state->shared, snapshot);
+
+    pthread_mutex_lock(&state->shared->snapshot_lock);
+    stop = state->stop;
+    if (!consistent) {
+      state->consistent = FALSE;
+    }
+    pthread_mutex_unlock(&state->shared->snapshot_lock);
+  }
+
+  return NULL;
+}
@@ -0,0 +1,23 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for the SharedEventList
+ */
+
+#ifndef SHARED_EVENT_LIST_TEST_H_
+#define SHARED_EVENT_LIST_TEST_H_
+
+#include "shared_event_list.h"
+
+/* Snapshots should not see changes made after they were taken. */
+void testSharedEventListSnapshotIsolation();
+
+/* Edits replace the event, old snapshots keep the old one. */
+void testSharedEventListEdit();
+
+/* Readers on another thread see a consistent list while we write. */
+void testSharedEventListConcurrentReaders();
+
+#endif
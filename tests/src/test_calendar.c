@@ -0,0 +1,55 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+#include <stdio.h>
+
+#include "test_calendar.h"
+
+Timestamp testCalendarTime(const char *const stDate,
+                           const char *const stTime)
+{
+  struct Date date;
+  struct Time time;
+
+  dateParse(stDate, &date);
+  timeParse(stTime, &time);
+
+  return timestampFromDateTime(&date, &time);
+}
+
+void testCalendarEvent(int i, struct TestCalendarEvent *event)
+{
+  sprintf(event->date, "2013-%02d-%02d", i % 12 + 1, i % 28 + 1);
+  sprintf(event->time, "%02d:%02d", i % 24, i % 4 * 15);
+  event->duration = i % 5 * 30;
+  sprintf(event->name, "Event %d", i % 10);
+
+  if (i % 3 == 0) {
+    event->location[0] = '\0';
+  } else {
+    sprintf(event->location, "Room %d", i % 7);
+  }
+}
+
+struct EventList *testCalendarList(int count)
+{
+  struct EventList *list;
+  struct Event *event;
+  struct TestCalendarEvent fields;
+  int i;
+
+  list = eventListCreate();
+
+  for (i = 0; i < count; i++) {
+    testCalendarEvent(i, &fields);
+    eventCreate(&event, fields.date, fields.time, fields.duration,
+                fields.name,
+                fields.location[0] == '\0' ? NULL : fields.location);
+    eventListInsertLast(list, event);
+  }
+
+  return list;
+}
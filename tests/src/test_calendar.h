@@ -0,0 +1,56 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Timestamps and calendars shared by the unit tests.
+ *
+ * The calendar has its events spread over the days and times of 2013,
+ * with a handful of names and locations used over and over. Event i
+ * is always the same, so tests can build it as a list or write it as
+ * a file and know what's in it.
+ */
+
+#ifndef TEST_CALENDAR_H_
+#define TEST_CALENDAR_H_
+
+#include "date_time.h"
+#include "event_list.h"
+
+#define TEST_CALENDAR_FIELD_SIZE 20
+
+/*
+ * The fields of one event, as strings for eventCreate or a file.
+ *
+ * date/time - Day i % 28 + 1 of month i % 12 + 1, at hour i % 24 and
+ *             minute i % 4 * 15.
+ * duration - i % 5 * 30 minutes.
+ * name - "Event " and i % 10.
+ * location - "Room " and i % 7, empty for every third event (when
+ *            i % 3 is 0).
+ */
+struct TestCalendarEvent {
+  char date[TEST_CALENDAR_FIELD_SIZE];
+  char time[TEST_CALENDAR_FIELD_SIZE];
+  int duration;
+  char name[TEST_CALENDAR_FIELD_SIZE];
+  char location[TEST_CALENDAR_FIELD_SIZE];
+};
+
+/*
+ * Timestamp for a date and time string.
+ */
+Timestamp testCalendarTime(const char *const stDate,
+                           const char *const stTime);
+
+/*
+ * Fill in the fields of event i of the calendar.
+ */
+void testCalendarEvent(int i, struct TestCalendarEvent *event);
+
+/*
+ * A list of the first count events of the calendar.
+ */
+struct EventList *testCalendarList(int count);
+
+#endif
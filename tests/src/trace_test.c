@@ -0,0 +1,153 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ */
+
+/* For setenv and unsetenv. */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <CUnit/CUnit.h>
+
+#include "calendar_file.h"
+#include "event_list.h"
+#include "trace_test.h"
+
+#define TRACE_TEST_FILE "saved/trace.json"
+#define LINE_SIZE 256
+
+/*
+ * Counts of what's in a written trace.
+ */
+struct TraceCounts {
+  int begins;
+  int ends;
+  int outer_begins;
+  int outer_ends;
+  Boolean loads;
+  Boolean closed;
+};
+
+static void countTrace(struct TraceCounts *counts);
+
+void testTraceDisabled() {
+  unsetenv(TRACE_ENV);
+  remove(TRACE_TEST_FILE);
+
+  traceStart();
+  CU_ASSERT_FALSE(traceEnabled());
+
+  traceBegin("disabled");
+  traceEnd("disabled");
+  CU_ASSERT_TRUE(traceWrite());
+  traceFinish();
+
+  CU_ASSERT_PTR_NULL(fopen(TRACE_TEST_FILE, "r"));
+}
+
+void testTraceEmpty() {
+  struct TraceCounts counts;
+
+  setenv(TRACE_ENV, TRACE_TEST_FILE, 1);
+  traceStart();
+  unsetenv(TRACE_ENV);
+  CU_ASSERT_TRUE_FATAL(traceEnabled());
+
+  traceFinish();
+
+  countTrace(&counts);
+  CU_ASSERT_EQUAL(counts.begins, 0);
+  CU_ASSERT_EQUAL(counts.ends, 0);
+  CU_ASSERT_TRUE(counts.closed);
+}
+
+void testTraceWrite() {
+  struct EventList *test_list;
+  struct TraceCounts counts;
+
+  setenv(TRACE_ENV, TRACE_TEST_FILE, 1);
+  traceStart();
+  unsetenv(TRACE_ENV);
+  CU_ASSERT_TRUE_FATAL(traceEnabled());
+
+  test_list = eventListCreate();
+
+  traceBegin("outer");
+  CU_ASSERT_EQUAL(loadCalendar(test_list, "data/test.txt"), FILE_NO_ERROR);
+  traceEnd("outer");
+
+  traceFinish();
+  CU_ASSERT_FALSE(traceEnabled());
+  eventListDestroy(test_list);
+
+  countTrace(&counts);
+  CU_ASSERT_EQUAL(counts.begins, 2);
+  CU_ASSERT_EQUAL(counts.ends, 2);
+  CU_ASSERT_EQUAL(counts.outer_begins, 1);
+  CU_ASSERT_EQUAL(counts.outer_ends, 1);
+  CU_ASSERT_TRUE(counts.loads);
+  CU_ASSERT_TRUE(counts.closed);
+}
+
+void testTraceWrapped() {
+  struct TraceCounts counts;
+  int i;
+
+  setenv(TRACE_ENV, TRACE_TEST_FILE, 1);
+  traceStart();
+  unsetenv(TRACE_ENV);
+  CU_ASSERT_TRUE_FATAL(traceEnabled());
+
+  traceBegin("outer");
+
+  for (i = 0; i < TRACE_BUFFER_EVENTS; i++) {
+    traceBegin("inner");
+    traceEnd("inner");
+  }
+
+  traceEnd("outer");
+  traceFinish();
+
+  countTrace(&counts);
+  CU_ASSERT_EQUAL(counts.begins, counts.ends);
+  CU_ASSERT_EQUAL(counts.begins, TRACE_BUFFER_EVENTS / 2 - 1);
+  CU_ASSERT_EQUAL(counts.outer_begins, 0);
+  CU_ASSERT_EQUAL(counts.outer_ends, 0);
+  CU_ASSERT_TRUE(counts.closed);
+}
+
+/*
+ * The trace has one event to a line, so it can be counted a line at
+ * a time.
+ */
+static void countTrace(struct TraceCounts *counts) {
+  FILE *input;
+  char line[LINE_SIZE];
+
+  memset(counts, 0, sizeof(struct TraceCounts));
+
+  input = fopen(TRACE_TEST_FILE, "r");
+  CU_ASSERT_PTR_NOT_NULL_FATAL(input);
+
+  while (fgets(line, LINE_SIZE, input) != NULL) {
+    if (strstr(line, "\"ph\": \"B\"") != NULL) {
+      counts->begins++;
+      counts->outer_begins += (strstr(line, "\"outer\"") != NULL);
+    } else if (strstr(line, "\"ph\": \"E\"") != NULL) {
+      counts->ends++;
+      counts->outer_ends += (strstr(line, "\"outer\"") != NULL);
+    }
+
+    if (strstr(line, "\"loadCalendar\"") != NULL) {
+      counts->loads = TRUE;
+    }
+
+    counts->closed = (strcmp(line, "]}\n") == 0);
+  }
+
+  fclose(input);
+}
@@ -0,0 +1,26 @@
+/*
+ * UCP 120 Assignment
+ *
+ * Author: Mike Aldred
+ *
+ * Unit tests for tracing
+ */
+
+#ifndef TRACE_TEST_H_
+#define TRACE_TEST_H_
+
+#include "trace.h"
+
+/* Without the environment variable nothing is recorded. */
+void testTraceDisabled();
+
+/* A trace with nothing recorded is still written. */
+void testTraceEmpty();
+
+/* Nested spans are written with a begin and an end each. */
+void testTraceWrite();
+
+/* Once the buffer wraps, ends without their begins are left out. */
+void testTraceWrapped();
+
+#endif
@@ -1,9 +1,23 @@
 #include <CUnit/Basic.h>
 
+#include "alloc_test.h"
 #include "calendar_file_test.h"
 #include "date_test.h"
+#include "event_fuzzy_test.h"
+#include "event_history_test.h"
 #include "event_list_test.h"
+#include "event_prefix_test.h"
+#include "event_query_test.h"
+#include "event_schedule_test.h"
+#include "event_stats_test.h"
 #include "event_test.h"
+#include "event_text_test.h"
+#include "event_upcoming_test.h"
+#include "instrument_test.h"
+#include "latency_test.h"
+#include "pool_test.h"
+#include "shared_event_list_test.h"
+#include "trace_test.h"
 
 int main() {
   CU_pSuite pDateSuite = NULL;
@@ -11,6 +25,20 @@ int main() {
   CU_pSuite pEventSuite = NULL;
   CU_pSuite pEventListSuite = NULL;
   CU_pSuite pCalendarFileSuite = NULL;
+  CU_pSuite pSharedEventListSuite = NULL;
+  CU_pSuite pEventHistorySuite = NULL;
+  CU_pSuite pEventQuerySuite = NULL;
+  CU_pSuite pEventScheduleSuite = NULL;
+  CU_pSuite pEventStatsSuite = NULL;
+  CU_pSuite pEventUpcomingSuite = NULL;
+  CU_pSuite pPoolSuite = NULL;
+  CU_pSuite pInstrumentSuite = NULL;
+  CU_pSuite pAllocSuite = NULL;
+  CU_pSuite pTraceSuite = NULL;
+  CU_pSuite pLatencySuite = NULL;
+  CU_pSuite pEventFuzzySuite = NULL;
+  CU_pSuite pEventTextSuite = NULL;
+  CU_pSuite pEventPrefixSuite = NULL;
 
   if (CUE_SUCCESS != CU_initialize_registry()) {
     return CU_get_error();
@@ -21,10 +49,31 @@ int main() {
   pEventSuite = CU_add_suite("Event Checks", NULL, NULL);
   pEventListSuite = CU_add_suite("Event List Checks", NULL, NULL);
   pCalendarFileSuite = CU_add_suite("Calendar File Checks", NULL, NULL);
+  pSharedEventListSuite = CU_add_suite("Shared Event List Checks", NULL, NULL);
+  pEventHistorySuite = CU_add_suite("Event History Checks", NULL, NULL);
+  pEventQuerySuite = CU_add_suite("Event Query Checks", NULL, NULL);
+  pEventScheduleSuite = CU_add_suite("Event Schedule Checks", NULL, NULL);
+  pEventStatsSuite = CU_add_suite("Event Stats Checks", NULL, NULL);
+  pEventUpcomingSuite = CU_add_suite("Event Upcoming Checks", NULL, NULL);
+  pPoolSuite = CU_add_suite("Pool Checks", NULL, NULL);
+  pInstrumentSuite = CU_add_suite("Instrument Checks", NULL, NULL);
+  pAllocSuite = CU_add_suite("Allocation Budget Checks", NULL, NULL);
+  pTraceSuite = CU_add_suite("Trace Checks", NULL, NULL);
+  pLatencySuite = CU_add_suite("Latency Checks", NULL, NULL);
+  pEventFuzzySuite = CU_add_suite("Event Fuzzy Checks", NULL, NULL);
+  pEventTextSuite = CU_add_suite("Event Text Checks", NULL, NULL);
+  pEventPrefixSuite = CU_add_suite("Event Prefix Checks", NULL, NULL);
 
   if ((NULL == pDateSuite) || (NULL == pTimeSuite) ||
       (NULL == pEventSuite) || (NULL == pEventListSuite) ||
-      (NULL == pCalendarFileSuite)) {
+      (NULL == pCalendarFileSuite) || (NULL == pSharedEventListSuite) ||
+      (NULL == pEventHistorySuite) || (NULL == pEventQuerySuite) ||
+      (NULL == pEventScheduleSuite) || (NULL == pEventStatsSuite) ||
+      (NULL == pEventUpcomingSuite) || (NULL == pPoolSuite) ||
+      (NULL == pInstrumentSuite) || (NULL == pAllocSuite) ||
+      (NULL == pTraceSuite) || (NULL == pLatencySuite) ||
+      (NULL == pEventFuzzySuite) || (NULL == pEventTextSuite) ||
+      (NULL == pEventPrefixSuite)) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -54,6 +103,24 @@ int main() {
                            testTimeStringOutput)) ||
       (NULL == CU_add_test(pTimeSuite, "Test Duration String Output",
                            testDurationStringOutput)) ||
+      (NULL == CU_add_test(pTimeSuite, "Test Timestamp Known Values",
+                           testTimestampKnownValues)) ||
+      (NULL == CU_add_test(pTimeSuite, "Test Timestamp Round Trip",
+                           testTimestampRoundTrip)) ||
+      (NULL == CU_add_test(pDateSuite, "Test Date Add Days",
+                           testDateAddDays)) ||
+      (NULL == CU_add_test(pDateSuite, "Test Date Difference",
+                           testDateDifference)) ||
+      (NULL == CU_add_test(pDateSuite, "Test Date Weekday",
+                           testDateWeekday)) ||
+      (NULL == CU_add_test(pDateSuite, "Test Date ISO Week",
+                           testDateIsoWeek)) ||
+      (NULL == CU_add_test(pTimeSuite, "Test Date Time Add Minutes",
+                           testDateTimeAddMinutes)) ||
+      (NULL == CU_add_test(pDateSuite, "Test Date Parse Batch",
+                           testDateParseBatch)) ||
+      (NULL == CU_add_test(pTimeSuite, "Test Time Parse Batch",
+                           testTimeParseBatch)) ||
       (NULL == CU_add_test(pEventSuite, "Test Create Valid Event",
                            testCreateEvent)) ||
       (NULL == CU_add_test(pEventSuite, "Test Create Event Invalid Duration",
@@ -66,6 +133,14 @@ int main() {
                            testCreateEventInvalidName)) ||
       (NULL == CU_add_test(pEventSuite, "Test Create Event No Location",
                            testCreateEventNoLocation)) ||
+      (NULL == CU_add_test(pEventSuite, "Test Copy Event",
+                           testCopyEvent)) ||
+      (NULL == CU_add_test(pEventSuite, "Test Event Timestamp",
+                           testEventTimestamp)) ||
+      (NULL == CU_add_test(pEventSuite, "Test Events Overlap",
+                           testEventsOverlap)) ||
+      (NULL == CU_add_test(pEventSuite, "Test Event Inline Name",
+                           testEventInlineName)) ||
       (NULL == CU_add_test(pEventListSuite, "Test Create Empty Event List",
                            testEventListCreateList)) ||
       (NULL == CU_add_test(pEventListSuite, "Test Event List Insert Single",
@@ -80,6 +155,22 @@ int main() {
                            testEventListFindEmptyList)) ||
       (NULL == CU_add_test(pEventListSuite, "Test Event List Delete",
                            testEventListDelete)) ||
+      (NULL == CU_add_test(pEventListSuite, "Test Event List Remove",
+                           testEventListRemove)) ||
+      (NULL == CU_add_test(pEventListSuite, "Test Event List Replace",
+                           testEventListReplace)) ||
+      (NULL == CU_add_test(pEventListSuite, "Test Event List Shared Locations",
+                           testEventListSharedLocations)) ||
+      (NULL == CU_add_test(pEventListSuite, "Test Event List Rename Location",
+                           testEventListRenameLocation)) ||
+      (NULL == CU_add_test(pEventListSuite, "Test Event List Watch",
+                           testEventListWatch)) ||
+      (NULL == CU_add_test(pEventListSuite, "Test Event List Ids",
+                           testEventListIds)) ||
+      (NULL == CU_add_test(pEventListSuite, "Test Event List Delete Handle",
+                           testEventListDeleteHandle)) ||
+      (NULL == CU_add_test(pEventListSuite, "Test Event List Insert Before",
+                           testEventListInsertBefore)) ||
       (NULL == CU_add_test(pCalendarFileSuite, "Test Load Calendar File",
                            testCalendarLoadFile)) ||
       (NULL == CU_add_test(pCalendarFileSuite, "Test Load Invalid Calendar Files",
@@ -87,7 +178,109 @@ int main() {
       (NULL == CU_add_test(pCalendarFileSuite, "Test Save Calendar File",
                            testCalendarSaveFile)) ||
       (NULL == CU_add_test(pCalendarFileSuite, "Test Save Calendar Over Dir",
-                           testCalendarSaveOverDir))
+                           testCalendarSaveOverDir)) ||
+      (NULL == CU_add_test(pCalendarFileSuite, "Test Calendar File Ids",
+                           testCalendarIds)) ||
+      (NULL == CU_add_test(pSharedEventListSuite, "Test Snapshot Isolation",
+                           testSharedEventListSnapshotIsolation)) ||
+      (NULL == CU_add_test(pSharedEventListSuite, "Test Shared Edit",
+                           testSharedEventListEdit)) ||
+      (NULL == CU_add_test(pSharedEventListSuite, "Test Concurrent Readers",
+                           testSharedEventListConcurrentReaders)) ||
+      (NULL == CU_add_test(pEventHistorySuite, "Test Create History",
+                           testEventHistoryCreate)) ||
+      (NULL == CU_add_test(pEventHistorySuite, "Test Undo Redo",
+                           testEventHistoryUndoRedo)) ||
+      (NULL == CU_add_test(pEventHistorySuite, "Test Versions Shared",
+                           testEventHistoryVersionsShared)) ||
+      (NULL == CU_add_test(pEventHistorySuite, "Test Change Clears Redo",
+                           testEventHistoryChangeClearsRedo)) ||
+      (NULL == CU_add_test(pEventHistorySuite, "Test History Ownership",
+                           testEventHistoryOwnership)) ||
+      (NULL == CU_add_test(pEventHistorySuite, "Test History Out Of Memory",
+                           testEventHistoryOutOfMemory)) ||
+      (NULL == CU_add_test(pEventQuerySuite, "Test Create Index",
+                           testEventIndexCreate)) ||
+      (NULL == CU_add_test(pEventQuerySuite, "Test Index Current",
+                           testEventIndexCurrent)) ||
+      (NULL == CU_add_test(pEventQuerySuite, "Test Query Scan",
+                           testEventQueryScan)) ||
+      (NULL == CU_add_test(pEventQuerySuite, "Test Query Plan",
+                           testEventQueryPlan)) ||
+      (NULL == CU_add_test(pEventScheduleSuite, "Test Busy",
+                           testScheduleBusy)) ||
+      (NULL == CU_add_test(pEventScheduleSuite, "Test Free Slots",
+                           testScheduleFreeSlots)) ||
+      (NULL == CU_add_test(pEventScheduleSuite, "Test Indexed",
+                           testScheduleIndexed)) ||
+      (NULL == CU_add_test(pEventStatsSuite, "Test Empty Stats",
+                           testEventStatsEmpty)) ||
+      (NULL == CU_add_test(pEventStatsSuite, "Test Period Stats",
+                           testEventStatsPeriods)) ||
+      (NULL == CU_add_test(pEventStatsSuite, "Test Location Stats",
+                           testEventStatsLocations)) ||
+      (NULL == CU_add_test(pEventUpcomingSuite, "Test Upcoming Scan",
+                           testEventUpcomingScan)) ||
+      (NULL == CU_add_test(pEventUpcomingSuite, "Test Upcoming Indexed",
+                           testEventUpcomingIndexed)) ||
+      (NULL == CU_add_test(pPoolSuite, "Test Pool Reuse",
+                           testPoolReuse)) ||
+      (NULL == CU_add_test(pPoolSuite, "Test Pool Slabs",
+                           testPoolSlabs)) ||
+      (NULL == CU_add_test(pPoolSuite, "Test Pool Aligned",
+                           testPoolAligned)) ||
+      (NULL == CU_add_test(pPoolSuite, "Test Pool Release",
+                           testPoolRelease)) ||
+      (NULL == CU_add_test(pInstrumentSuite, "Test Instrument Counters",
+                           testInstrumentCounters)) ||
+      (NULL == CU_add_test(pInstrumentSuite, "Test Instrument Operations",
+                           testInstrumentOperations)) ||
+      (NULL == CU_add_test(pInstrumentSuite, "Test Instrument JSON",
+                           testInstrumentJson)) ||
+      (NULL == CU_add_test(pAllocSuite, "Test Load Budget",
+                           testAllocLoadBudget)) ||
+      (NULL == CU_add_test(pAllocSuite, "Test Iterate Budget",
+                           testAllocIterateBudget)) ||
+      (NULL == CU_add_test(pAllocSuite, "Test String Budget",
+                           testAllocStringBudget)) ||
+      (NULL == CU_add_test(pAllocSuite, "Test Destroy Frees All",
+                           testAllocDestroyFreesAll)) ||
+      (NULL == CU_add_test(pTraceSuite, "Test Trace Disabled",
+                           testTraceDisabled)) ||
+      (NULL == CU_add_test(pTraceSuite, "Test Trace Empty",
+                           testTraceEmpty)) ||
+      (NULL == CU_add_test(pTraceSuite, "Test Trace Write",
+                           testTraceWrite)) ||
+      (NULL == CU_add_test(pTraceSuite, "Test Trace Wrapped",
+                           testTraceWrapped)) ||
+      (NULL == CU_add_test(pLatencySuite, "Test Latency Buckets",
+                           testLatencyBuckets)) ||
+      (NULL == CU_add_test(pLatencySuite, "Test Latency Percentiles",
+                           testLatencyPercentiles)) ||
+      (NULL == CU_add_test(pLatencySuite, "Test Latency Actions",
+                           testLatencyActions)) ||
+      (NULL == CU_add_test(pEventFuzzySuite, "Test Fuzzy Distance",
+                           testEventFuzzyDistance)) ||
+      (NULL == CU_add_test(pEventFuzzySuite, "Test Fuzzy Find",
+                           testEventFuzzyFind)) ||
+      (NULL == CU_add_test(pEventFuzzySuite, "Test Fuzzy Filter",
+                           testEventFuzzyFilter)) ||
+      (NULL == CU_add_test(pEventFuzzySuite, "Test Fuzzy Current",
+                           testEventFuzzyCurrent)) ||
+      (NULL == CU_add_test(pEventTextSuite, "Test Text Search",
+                           testEventTextSearch)) ||
+      (NULL == CU_add_test(pEventTextSuite, "Test Text Updates",
+                           testEventTextUpdates)) ||
+      (NULL == CU_add_test(pEventTextSuite, "Test Text Compact",
+                           testEventTextCompact)) ||
+      (NULL == CU_add_test(pEventTextSuite, "Test Text Prefix Terms",
+                           testEventTextPrefixTerms)) ||
+      (NULL == CU_add_test(pEventPrefixSuite, "Test Prefix Find",
+                           testEventPrefixFind)) ||
+      (NULL == CU_add_test(pEventPrefixSuite, "Test Prefix Updates",
+                           testEventPrefixUpdates)) ||
+      (NULL == CU_add_test(pEventPrefixSuite, "Test Prefix Changes",
+                           testEventPrefixChanges))
 
      ) {
     CU_cleanup_registry();